@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -32,6 +33,7 @@
 #include "binder/expressions/bound_constant.h"
 #include "binder/expressions/bound_star.h"
 #include "binder/expressions/bound_unary_op.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
@@ -85,6 +87,24 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
   auto table = std::string(pg_stmt->relation->relname);
   auto columns = std::vector<Column>{};
   size_t column_count = 0;
+  std::vector<std::string> primary_key;
+
+  // PRIMARY KEY is the only constraint, either after a column or on its own naming the key columns
+  auto bind_constraint = [&primary_key](duckdb_libpgquery::PGConstraint *constraint, const std::string &colname) {
+    if (constraint->contype != duckdb_libpgquery::PG_CONSTR_PRIMARY) {
+      throw NotImplementedException("constraints other than primary key are not supported");
+    }
+    if (!primary_key.empty()) {
+      throw bustub::Exception("multiple primary keys are not allowed");
+    }
+    if (constraint->keys == nullptr) {
+      primary_key.push_back(colname);
+      return;
+    }
+    for (auto k = constraint->keys->head; k != nullptr; k = lnext(k)) {
+      primary_key.emplace_back(reinterpret_cast<duckdb_libpgquery::PGValue *>(k->data.ptr_value)->val.str);
+    }
+  };
 
   for (auto c = pg_stmt->tableElts->head; c != nullptr; c = lnext(c)) {
     auto node = reinterpret_cast<duckdb_libpgquery::PGNode *>(c->data.ptr_value);
@@ -93,14 +113,17 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
         auto cdef = reinterpret_cast<duckdb_libpgquery::PGColumnDef *>(c->data.ptr_value);
         auto centry = BindColumnDefinition(cdef);
         if (cdef->constraints != nullptr) {
-          throw NotImplementedException("constraints not supported");
+          for (auto con = cdef->constraints->head; con != nullptr; con = lnext(con)) {
+            bind_constraint(reinterpret_cast<duckdb_libpgquery::PGConstraint *>(con->data.ptr_value),
+                            centry.GetName());
+          }
         }
         columns.push_back(std::move(centry));
         column_count++;
         break;
       }
       case duckdb_libpgquery::T_PGConstraint: {
-        throw NotImplementedException("constraints not supported");
+        bind_constraint(reinterpret_cast<duckdb_libpgquery::PGConstraint *>(c->data.ptr_value), "");
         break;
       }
       default:
@@ -112,7 +135,37 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  std::vector<uint32_t> key_attrs;
+  for (const auto &key : primary_key) {
+    auto it = std::find_if(columns.begin(), columns.end(), [&key](const Column &col) { return col.GetName() == key; });
+    if (it == columns.end()) {
+      throw bustub::Exception(fmt::format("primary key column {} not found", key));
+    }
+    key_attrs.push_back(static_cast<uint32_t>(it - columns.begin()));
+  }
+
+  // WITH (clustered) stores the rows in a B+ tree on the primary key, which takes the place of an index on it
+  bool clustered = false;
+  if (pg_stmt->options != nullptr) {
+    for (auto o = pg_stmt->options->head; o != nullptr; o = lnext(o)) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(o->data.ptr_value);
+      if (StringUtil::Lower(option->defname) != "clustered") {
+        throw NotImplementedException(fmt::format("table option {} is not supported", option->defname));
+      }
+      if (option->arg != nullptr) {
+        throw NotImplementedException("table option clustered takes no value");
+      }
+      clustered = true;
+    }
+  }
+  if (clustered && key_attrs.empty()) {
+    throw bustub::Exception("a clustered table needs a primary key");
+  }
+  if (!clustered && !key_attrs.empty()) {
+    throw NotImplementedException("primary keys are only supported on clustered tables, add WITH (clustered)");
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), std::move(key_attrs), clustered);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -129,7 +182,26 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  std::string index_type = stmt->accessMethod == nullptr ? "btree" : StringUtil::Lower(stmt->accessMethod);
+  if (index_type != "btree" && index_type != "art" && index_type != "lsm" && index_type != "skiplist") {
+    throw NotImplementedException(fmt::format("index type {} is not supported", index_type));
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), stmt->unique,
+                                          std::move(index_type));
+}
+
+auto Binder::BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_VACUUM) != 0) {
+    throw NotImplementedException("VACUUM is not supported");
+  }
+  if (stmt->va_cols != nullptr) {
+    throw NotImplementedException("ANALYZE of single columns is not supported");
+  }
+  if (stmt->relation == nullptr) {
+    return std::make_unique<AnalyzeStatement>(nullptr);
+  }
+  return std::make_unique<AnalyzeStatement>(BindBaseTableRef(stmt->relation->relname, std::nullopt));
 }
 
 }  // namespace bustub
@@ -812,8 +812,8 @@ auto Binder::BindLimitOffset(duckdb_libpgquery::PGNode *root) -> std::unique_ptr
 }
 
 auto Binder::BindExplain(duckdb_libpgquery::PGExplainStmt *stmt) -> std::unique_ptr<ExplainStatement> {
-  uint8_t explain_options =
-      ExplainOptions::PLANNER | ExplainOptions::OPTIMIZER | ExplainOptions::BINDER | ExplainOptions::SCHEMA;
+  uint8_t explain_options = ExplainOptions::PLANNER | ExplainOptions::OPTIMIZER | ExplainOptions::BINDER |
+                            ExplainOptions::SCHEMA | ExplainOptions::STATISTICS;
   if (stmt->options != nullptr) {
     explain_options = ExplainOptions::INVALID;
     for (auto node = stmt->options->head; node != nullptr; node = node->next) {
@@ -830,6 +830,9 @@ auto Binder::BindExplain(duckdb_libpgquery::PGExplainStmt *stmt) -> std::unique_
       if (strcmp(temp->defname, "schema") == 0 || strcmp(temp->defname, "s") == 0) {
         explain_options |= ExplainOptions::SCHEMA;
       }
+      if (strcmp(temp->defname, "statistics") == 0) {
+        explain_options |= ExplainOptions::STATISTICS;
+      }
     }
   }
   return std::make_unique<ExplainStatement>(BindStatement(stmt->query), explain_options);
@@ -0,0 +1,16 @@
+#include "binder/statement/analyze_statement.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+AnalyzeStatement::AnalyzeStatement(std::unique_ptr<BoundBaseTableRef> table)
+    : BoundStatement(StatementType::ANALYZE_STATEMENT), table_(std::move(table)) {}
+
+auto AnalyzeStatement::ToString() const -> std::string {
+  if (table_ == nullptr) {
+    return "BoundAnalyze { table=<all> }";
+  }
+  return fmt::format("BoundAnalyze {{ table={} }}", *table_);
+}
+
+}  // namespace bustub
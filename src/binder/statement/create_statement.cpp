@@ -5,11 +5,17 @@
 
 namespace bustub {
 
-CreateStatement::CreateStatement(std::string table, std::vector<Column> columns)
-    : BoundStatement(StatementType::CREATE_STATEMENT), table_(std::move(table)), columns_(std::move(columns)) {}
+CreateStatement::CreateStatement(std::string table, std::vector<Column> columns, std::vector<uint32_t> primary_key,
+                                 bool clustered)
+    : BoundStatement(StatementType::CREATE_STATEMENT),
+      table_(std::move(table)),
+      columns_(std::move(columns)),
+      primary_key_(std::move(primary_key)),
+      clustered_(clustered) {}
 
 auto CreateStatement::ToString() const -> std::string {
-  return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n}}", table_, columns_);
+  return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n  primary_key={}\n  clustered={}\n}}", table_,
+                     columns_, primary_key_, clustered_);
 }
 
 }  // namespace bustub
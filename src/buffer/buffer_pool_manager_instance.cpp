@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include <algorithm>
 #include <cstdlib>
 
 #include "common/exception.h"
@@ -36,29 +37,30 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  {
+    std::scoped_lock lock(prefetch_latch_);
+    stop_prefetch_ = true;
+  }
+  prefetch_cv_.notify_one();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
   delete[] pages_;
   delete page_table_;
   delete replacer_;
 }
 
 auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+  std::scoped_lock<std::mutex> lock(latch_);
   frame_id_t frame_id = 0;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.back();
-    free_list_.pop_back();
-  } else {
-    if (!replacer_->Evict(&frame_id)) {
-      return nullptr;
-    }
-    if (pages_[frame_id].is_dirty_) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-      pages_[frame_id].is_dirty_ = false;
-    }
-    page_table_->Remove(pages_[frame_id].GetPageId());
+  if (!AcquireFrame(&frame_id)) {
+    return nullptr;
   }
 
+  pages_[frame_id].ResetMemory();
   pages_[frame_id].page_id_ = AllocatePage();
   pages_[frame_id].pin_count_ = 1;
+  pages_[frame_id].is_dirty_ = false;
   *page_id = pages_[frame_id].page_id_;
   page_table_->Insert((*page_id), frame_id);
   replacer_->RecordAccess(frame_id);
@@ -67,6 +69,7 @@ auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
 }
 
 auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
+  std::scoped_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
   if (page_table_->Find(page_id, frame_id)) {
     pages_[frame_id].pin_count_++;
@@ -75,18 +78,8 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
     return &pages_[frame_id];
   }
 
-  if (!free_list_.empty()) {
-    frame_id = free_list_.back();
-    free_list_.pop_back();
-  } else {
-    if (!replacer_->Evict(&frame_id)) {
-      return nullptr;
-    }
-    if (pages_[frame_id].is_dirty_) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-      pages_[frame_id].is_dirty_ = false;
-    }
-    page_table_->Remove(pages_[frame_id].GetPageId());
+  if (!AcquireFrame(&frame_id)) {
+    return nullptr;
   }
   page_table_->Insert(page_id, frame_id);
   pages_[frame_id].page_id_ = page_id;
@@ -100,8 +93,9 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
 }
 
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  if (page_table_->Find(page_id, frame_id) == false) {
+  if (!page_table_->Find(page_id, frame_id)) {
     return false;
   }
   if (pages_[frame_id].pin_count_ == 0) {
@@ -111,38 +105,99 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
   if (pages_[frame_id].pin_count_ == 0) {
     replacer_->SetEvictable(frame_id, true);
   }
-  pages_[frame_id].is_dirty_ = is_dirty;
+  // a clean unpin must not hide an earlier writer's modification
+  pages_[frame_id].is_dirty_ = pages_[frame_id].is_dirty_ || is_dirty;
   return true;
 }
 
 auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  if (page_table_->Find(page_id, frame_id) == false) {
+  if (!page_table_->Find(page_id, frame_id)) {
     return false;
   }
-  pages_[frame_id].is_dirty_ = false;
   disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
+  pages_[frame_id].is_dirty_ = false;
   return true;
 }
 
-void BufferPoolManagerInstance::FlushAllPgsImp() {}
+void BufferPoolManagerInstance::FlushAllPgsImp() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].page_id_ != INVALID_PAGE_ID && pages_[i].is_dirty_) {
+      disk_manager_->WritePage(pages_[i].page_id_, pages_[i].GetData());
+      pages_[i].is_dirty_ = false;
+    }
+  }
+}
 
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  if (page_table_->Find(page_id, frame_id) == false) {
+  if (!page_table_->Find(page_id, frame_id)) {
     return true;
   }
   if (pages_[frame_id].GetPinCount() != 0) {
     return false;
   }
-  if (pages_[frame_id].IsDirty()) {
-    FlushPgImp(page_id);
-  }
   page_table_->Remove(page_id);
   replacer_->Remove(frame_id);
 
   pages_[frame_id].ResetMemory();
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  pages_[frame_id].is_dirty_ = false;
   free_list_.emplace_back(frame_id);
+  DeallocatePage(page_id);
+  return true;
+}
+
+void BufferPoolManagerInstance::PrefetchPage(page_id_t page_id) {
+  {
+    std::scoped_lock lock(prefetch_latch_);
+    if (stop_prefetch_ || prefetch_queue_.size() >= PREFETCH_QUEUE_SIZE ||
+        std::find(prefetch_queue_.begin(), prefetch_queue_.end(), page_id) != prefetch_queue_.end()) {
+      return;
+    }
+    prefetch_queue_.push_back(page_id);
+    if (!prefetch_thread_.joinable()) {
+      prefetch_thread_ = std::thread(&BufferPoolManagerInstance::PrefetchWork, this);
+    }
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManagerInstance::PrefetchWork() {
+  std::unique_lock lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return stop_prefetch_ || !prefetch_queue_.empty(); });
+    if (stop_prefetch_) {
+      return;
+    }
+    page_id_t page_id = prefetch_queue_.front();
+    prefetch_queue_.pop_front();
+    lock.unlock();
+    // the page only has to be resident, it is nullptr if every frame is pinned
+    if (FetchPgImp(page_id) != nullptr) {
+      UnpinPgImp(page_id, false);
+    }
+    lock.lock();
+  }
+}
+
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id) -> bool {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.back();
+    free_list_.pop_back();
+    return true;
+  }
+  if (!replacer_->Evict(frame_id)) {
+    return false;
+  }
+  if (pages_[*frame_id].is_dirty_) {
+    disk_manager_->WritePage(pages_[*frame_id].GetPageId(), pages_[*frame_id].GetData());
+    pages_[*frame_id].is_dirty_ = false;
+  }
+  page_table_->Remove(pages_[*frame_id].GetPageId());
   return true;
 }
 
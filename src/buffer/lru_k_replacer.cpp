@@ -119,12 +119,14 @@ void LRUKReplacer::Remove(frame_id_t frame_id) {
     for (auto i = cache_list_.begin(); i != cache_list_.end(); i++) {
       if ((*i) == frame_id) {
         cache_list_.erase(i);
+        break;
       }
     }
   } else {
     for (auto i = history_list_.begin(); i != history_list_.end(); i++) {
       if ((*i) == frame_id) {
         history_list_.erase(i);
+        break;
       }
     }
   }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -6,6 +7,7 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
@@ -25,6 +27,9 @@
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "optimizer/optimizer.h"
@@ -37,6 +42,39 @@
 
 namespace bustub {
 
+namespace {
+
+/** Append the names of the tables plan reads to tables, each of them once */
+void CollectScannedTables(const AbstractPlanNode &plan, Catalog *catalog, std::vector<std::string> *tables) {
+  const TableInfo *table_info = Catalog::NULL_TABLE_INFO;
+  switch (plan.GetType()) {
+    case PlanType::SeqScan:
+      table_info = catalog->GetTable(dynamic_cast<const SeqScanPlanNode &>(plan).GetTableOid());
+      break;
+    case PlanType::IndexScan: {
+      const auto *index_info = catalog->GetIndex(dynamic_cast<const IndexScanPlanNode &>(plan).GetIndexOid());
+      if (index_info != Catalog::NULL_INDEX_INFO) {
+        table_info = catalog->GetTable(index_info->table_name_);
+      }
+      break;
+    }
+    case PlanType::NestedIndexJoin:
+      table_info = catalog->GetTable(dynamic_cast<const NestedIndexJoinPlanNode &>(plan).GetInnerTableOid());
+      break;
+    default:
+      break;
+  }
+  if (table_info != Catalog::NULL_TABLE_INFO &&
+      std::find(tables->begin(), tables->end(), table_info->name_) == tables->end()) {
+    tables->push_back(table_info->name_);
+  }
+  for (const auto &child : plan.GetChildren()) {
+    CollectScannedTables(*child, catalog, tables);
+  }
+}
+
+}  // namespace
+
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
@@ -58,6 +96,12 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
+  if (buffer_pool_manager_ != nullptr) {
+    // B+ trees, which hold indexes and clustered tables, register their roots in the header page
+    page_id_t header_page_id;
+    buffer_pool_manager_->NewPage(&header_page_id);
+    buffer_pool_manager_->UnpinPage(header_page_id, true);
+  }
 
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
@@ -90,6 +134,12 @@ BustubInstance::BustubInstance() {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
+  if (buffer_pool_manager_ != nullptr) {
+    // B+ trees, which hold indexes and clustered tables, register their roots in the header page
+    page_id_t header_page_id;
+    buffer_pool_manager_->NewPage(&header_page_id);
+    buffer_pool_manager_->UnpinPage(header_page_id, true);
+  }
 
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
@@ -212,7 +262,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_));
+        Schema schema(create_stmt.columns_);
+        auto info = create_stmt.clustered_
+                        ? catalog_->CreateClusteredTable(txn, create_stmt.table_, schema, create_stmt.primary_key_)
+                        : catalog_->CreateTable(txn, create_stmt.table_, schema);
         l.unlock();
 
         if (info == nullptr) {
@@ -224,23 +277,39 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       case StatementType::INDEX_STATEMENT: {
         const auto &index_stmt = dynamic_cast<const IndexStatement &>(*statement);
 
+        // adaptive radix trees, lsm trees and skiplists index any key, B+ trees are built over a single integer
+        // column here
+        const bool is_art = index_stmt.index_type_ == "art";
+        const bool is_lsm = index_stmt.index_type_ == "lsm";
+        const bool is_skiplist = index_stmt.index_type_ == "skiplist";
+        const bool is_normalized = is_art || is_lsm || is_skiplist;
         std::vector<uint32_t> col_ids;
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
+          if (!is_normalized && index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
             throw NotImplementedException("only support creating index on integer column");
           }
         }
-        if (col_ids.size() != 1) {
+        if (!is_normalized && col_ids.size() != 1) {
           throw NotImplementedException("only support creating index with exactly one column");
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
+        auto index_type = IndexType::BPlusTreeIndex;
+        if (is_art) {
+          index_type = IndexType::ARTIndex;
+        } else if (is_lsm) {
+          index_type = IndexType::LSMIndex;
+        } else if (is_skiplist) {
+          index_type = IndexType::SkipListIndex;
+        }
+        // a plain CREATE INDEX builds a NonUniqueBPlusTreeIndexForOneIntegerColumn, CREATE UNIQUE INDEX a
+        // BPlusTreeIndexForOneIntegerColumn, see b_plus_tree_index.h
         auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
             txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+            INTEGER_SIZE, IntegerHashFunctionType{}, index_stmt.is_unique_, {}, index_type);
         l.unlock();
 
         if (info == nullptr) {
@@ -249,6 +318,21 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
         continue;
       }
+      case StatementType::ANALYZE_STATEMENT: {
+        const auto &analyze_stmt = dynamic_cast<const AnalyzeStatement &>(*statement);
+
+        std::unique_lock<std::shared_mutex> l(catalog_lock_);
+        auto table_names = analyze_stmt.table_ == nullptr ? catalog_->GetTableNames()
+                                                          : std::vector<std::string>{analyze_stmt.table_->table_};
+        size_t analyzed = 0;
+        for (const auto &table_name : table_names) {
+          analyzed += catalog_->AnalyzeTable(txn, table_name);
+        }
+        l.unlock();
+
+        WriteOneCell(fmt::format("Analyzed {} indexes", analyzed), writer);
+        continue;
+      }
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
         auto content = GetSessionVariable(show_stmt.variable_);
@@ -291,6 +375,20 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
         auto optimized_plan = optimizer.Optimize(planner.plan_);
 
+        // Collect the statistics of the indexes on the tables the plan reads, where ANALYZE has run.
+        std::string statistics;
+        if ((explain_stmt.options_ & ExplainOptions::STATISTICS) != 0) {
+          std::vector<std::string> table_names;
+          CollectScannedTables(*optimized_plan, catalog_, &table_names);
+          for (const auto &table_name : table_names) {
+            for (const auto *index_info : catalog_->GetTableIndexes(table_name)) {
+              if (index_info->stats_.has_value()) {
+                statistics += fmt::format("{}.{} {}\n", table_name, index_info->name_, index_info->stats_->ToString());
+              }
+            }
+          }
+        }
+
         l.unlock();
 
         if ((explain_stmt.options_ & ExplainOptions::OPTIMIZER) != 0) {
@@ -300,6 +398,13 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
           output += "\n";
         }
 
+        // Print statistics.
+        if (!statistics.empty()) {
+          output += "=== STATISTICS ===";
+          output += "\n";
+          output += statistics;
+        }
+
         WriteOneCell(output, writer);
 
         continue;
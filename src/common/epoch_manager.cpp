@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.cpp
+//
+// Identification: src/common/epoch_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/epoch_manager.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+EpochManager::~EpochManager() {
+  for (const auto &retired : retired_) {
+    retired.deleter_(retired.object_);
+  }
+}
+
+auto EpochManager::Enter() -> size_t {
+  size_t slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % SLOTS;
+  while (true) {
+    uint64_t free = 0;
+    if (slots_[slot].compare_exchange_strong(free, global_epoch_.load())) {
+      return slot;
+    }
+    slot = (slot + 1) % SLOTS;
+  }
+}
+
+void EpochManager::Exit(size_t slot) { slots_[slot].store(0); }
+
+void EpochManager::Retire(void *object, void (*deleter)(void *)) {
+  std::scoped_lock lock(latch_);
+  retired_.push_back({global_epoch_.load(), object, deleter});
+  if (retired_.size() >= RETIRE_BATCH) {
+    Reclaim();
+  }
+}
+
+void EpochManager::Reclaim() {
+  global_epoch_.fetch_add(1);
+  uint64_t oldest = std::numeric_limits<uint64_t>::max();
+  for (const auto &slot : slots_) {
+    uint64_t epoch = slot.load();
+    if (epoch != 0) {
+      oldest = std::min(oldest, epoch);
+    }
+  }
+  auto still_reachable = std::partition(retired_.begin(), retired_.end(),
+                                        [oldest](const Retired &retired) { return retired.epoch_ >= oldest; });
+  for (auto it = still_reachable; it != retired_.end(); ++it) {
+    it->deleter_(it->object_);
+  }
+  retired_.erase(still_reachable, retired_.end());
+}
+
+}  // namespace bustub
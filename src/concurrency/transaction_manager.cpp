@@ -48,16 +48,23 @@ void TransactionManager::Commit(Transaction *txn) {
 
   // Perform all deletes before we commit.
   auto write_set = txn->GetWriteSet();
+  std::unordered_set<TableHeap *> inserted_tables;
   while (!write_set->empty()) {
     auto &item = write_set->back();
     auto *table = item.table_;
     if (item.wtype_ == WType::DELETE) {
       // Note that this also releases the lock when holding the page latch.
       table->ApplyDelete(item.rid_, txn);
+    } else if (item.wtype_ == WType::INSERT) {
+      inserted_tables.insert(table);
     }
     write_set->pop_back();
   }
   write_set->clear();
+  // Hand the pages the insert lanes hold back to the free space maps.
+  for (auto *table : inserted_tables) {
+    table->ReleaseInsertPages();
+  }
 
   // Release all the locks.
   ReleaseLocks(txn);
@@ -69,20 +76,28 @@ void TransactionManager::Abort(Transaction *txn) {
   txn->SetState(TransactionState::ABORTED);
   // Rollback before releasing the lock.
   auto table_write_set = txn->GetWriteSet();
+  std::unordered_set<TableHeap *> inserted_tables;
   while (!table_write_set->empty()) {
     auto &item = table_write_set->back();
     auto *table = item.table_;
     if (item.wtype_ == WType::DELETE) {
       table->RollbackDelete(item.rid_, txn);
     } else if (item.wtype_ == WType::INSERT) {
+      inserted_tables.insert(table);
       // Note that this also releases the lock when holding the page latch.
-      table->ApplyDelete(item.rid_, txn);
+      for (auto i = item.count_; i-- > 0;) {
+        table->ApplyDelete(RID(item.rid_.GetPageId(), item.rid_.GetSlotNum() + i), txn);
+      }
     } else if (item.wtype_ == WType::UPDATE) {
       table->UpdateTuple(item.tuple_, item.rid_, txn);
     }
     table_write_set->pop_back();
   }
   table_write_set->clear();
+  // The rolled back inserts left room on the pages the insert lanes hold, hand them back to the free space maps.
+  for (auto *table : inserted_tables) {
+    table->ReleaseInsertPages();
+  }
   // Rollback index updates
   auto index_write_set = txn->GetIndexWriteSet();
   while (!index_write_set->empty()) {
@@ -0,0 +1,28 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/analyze_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "binder/bound_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+
+namespace bustub {
+
+class AnalyzeStatement : public BoundStatement {
+ public:
+  explicit AnalyzeStatement(std::unique_ptr<BoundBaseTableRef> table);
+
+  /** The table to analyze, nullptr to analyze every table */
+  std::unique_ptr<BoundBaseTableRef> table_;
+
+  auto ToString() const -> std::string override;
+};
+
+}  // namespace bustub
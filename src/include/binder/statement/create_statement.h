@@ -21,10 +21,15 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, std::vector<uint32_t> primary_key = {},
+                           bool clustered = false);
 
   std::string table_;
   std::vector<Column> columns_;
+  /** The columns of the PRIMARY KEY, empty if there is none */
+  std::vector<uint32_t> primary_key_;
+  /** Whether the rows are stored in a B+ tree on the primary key, WITH (clustered) */
+  bool clustered_;
 
   auto ToString() const -> std::string override;
 };
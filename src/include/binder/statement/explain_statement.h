@@ -13,11 +13,12 @@
 #include "binder/bound_statement.h"
 
 enum ExplainOptions : uint8_t {
-  INVALID = 0,   /**< Default explain mode */
-  BINDER = 1,    /**< Show binder results. */
-  PLANNER = 2,   /**< Show planner results. */
-  OPTIMIZER = 4, /**< Show optimizer results. */
-  SCHEMA = 8,    /**< Show schema. */
+  INVALID = 0,     /**< Default explain mode */
+  BINDER = 1,      /**< Show binder results. */
+  PLANNER = 2,     /**< Show planner results. */
+  OPTIMIZER = 4,   /**< Show optimizer results. */
+  SCHEMA = 8,      /**< Show schema. */
+  STATISTICS = 16, /**< Show the statistics of the tables the plan reads. */
 };
 
 namespace bustub {
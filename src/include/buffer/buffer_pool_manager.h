@@ -84,6 +84,12 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Hint that page_id is about to be fetched, so that the pool may read it in ahead of time. The page is not
+   * pinned and may be evicted again before it is fetched. Pools that do not read ahead ignore the hint.
+   */
+  virtual void PrefetchPage(__attribute__((unused)) page_id_t page_id) {}
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
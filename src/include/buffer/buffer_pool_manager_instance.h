@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
-#include <mutex>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
 
 #include "buffer/buffer_pool_manager.h"
@@ -49,6 +52,12 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
+  /**
+   * @brief Queue page_id to be read in by the prefetch thread, which the first call starts. The queue is short,
+   * a hint that does not fit is dropped.
+   */
+  void PrefetchPage(page_id_t page_id) override;
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
@@ -159,9 +168,30 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   LRUKReplacer *replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** This latch protects the page table, the replacer, the free list and the frame metadata. */
   std::mutex latch_;
 
+  /** Pages the prefetch thread is yet to read in, at most PREFETCH_QUEUE_SIZE of them. */
+  static constexpr size_t PREFETCH_QUEUE_SIZE = 16;
+  std::deque<page_id_t> prefetch_queue_;
+  /** One thread reads ahead for every user of the pool, it runs until the pool is destroyed. */
+  std::thread prefetch_thread_;
+  /** This latch protects the prefetch queue and stop_prefetch_. */
+  std::mutex prefetch_latch_;
+  std::condition_variable prefetch_cv_;
+  bool stop_prefetch_{false};
+
+  /** @brief Body of the prefetch thread: fetch and unpin queued pages until the pool is destroyed. */
+  void PrefetchWork();
+
+  /**
+   * @brief Take a frame from the free list, or evict one from the replacer and write it back if it is dirty.
+   * Caller should acquire the latch before calling this function.
+   * @param[out] frame_id id of the acquired frame
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
    * @return the id of the allocated page
@@ -12,8 +12,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -21,9 +25,13 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/art_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/lsm_index.h"
+#include "storage/index/skiplist_index.h"
+#include "storage/table/clustered_table.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -35,6 +43,9 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The structures an index can be built on, see Catalog::CreateIndex */
+enum class IndexType { BPlusTreeIndex, ARTIndex, LSMIndex, SkipListIndex };
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -48,12 +59,23 @@ struct TableInfo {
    */
   TableInfo(Schema schema, std::string name, std::unique_ptr<TableHeap> &&table, table_oid_t oid)
       : schema_{std::move(schema)}, name_{std::move(name)}, table_{std::move(table)}, oid_{oid} {}
+  /**
+   * Construct a new TableInfo instance for an index-organized table.
+   * @param schema The table schema
+   * @param name The table name
+   * @param clustered_table An owning pointer to the tree holding the rows
+   * @param oid The unique OID for the table
+   */
+  TableInfo(Schema schema, std::string name, std::unique_ptr<ClusteredTable> &&clustered_table, table_oid_t oid)
+      : schema_{std::move(schema)}, name_{std::move(name)}, clustered_table_{std::move(clustered_table)}, oid_{oid} {}
   /** The table schema */
   Schema schema_;
   /** The table name */
   const std::string name_;
-  /** An owning pointer to the table heap */
+  /** An owning pointer to the table heap, nullptr for index-organized tables */
   std::unique_ptr<TableHeap> table_;
+  /** An owning pointer to the rows of an index-organized table, nullptr for heap tables */
+  std::unique_ptr<ClusteredTable> clustered_table_;
   /** The table OID */
   const table_oid_t oid_;
 };
@@ -70,15 +92,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The structure the index is built on
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +115,10 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The structure the index is built on */
+  const IndexType index_type_;
+  /** The statistics gathered by the last Catalog::AnalyzeTable, if the index keeps any */
+  std::optional<IndexStatistics> stats_;
 };
 
 /**
@@ -154,6 +182,34 @@ class Catalog {
     return tmp;
   }
 
+  /**
+   * Create a new index-organized table, whose rows are stored in the leaves of a B+ tree on their primary key, and
+   * return its metadata.
+   * @param txn The transaction in which the table is being created
+   * @param table_name The name of the new table
+   * @param schema The schema of the new table
+   * @param key_attrs The primary key columns
+   * @return A (non-owning) pointer to the metadata for the table, `NULL_TABLE_INFO` if the name is taken, there is
+   * no primary key or the rows of schema may not fit into a tree entry
+   */
+  auto CreateClusteredTable(Transaction *txn, const std::string &table_name, const Schema &schema,
+                            const std::vector<uint32_t> &key_attrs) -> TableInfo * {
+    if (table_names_.count(table_name) != 0 || key_attrs.empty() || !ClusteredTable::Fits(schema)) {
+      return NULL_TABLE_INFO;
+    }
+
+    const auto table_oid = next_table_oid_.fetch_add(1);
+    auto table = std::make_unique<ClusteredTable>(table_name, bpm_, schema, key_attrs);
+    auto meta = std::make_unique<TableInfo>(schema, table_name, std::move(table), table_oid);
+    auto *tmp = meta.get();
+
+    tables_.emplace(table_oid, std::move(meta));
+    table_names_.emplace(table_name, table_oid);
+    index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
+
+    return tmp;
+  }
+
   /**
    * Query table metadata by name.
    * @param table_name The name of the table
@@ -196,12 +252,21 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
-   * @return A (non-owning) pointer to the metadata of the new table
+   * @param is_unique Whether two entries may not share a key
+   * @param include_attrs Columns stored in the index alongside the key (INCLUDE), which make it covering
+   * @param index_type The structure to build the index on: a B+ tree in the buffer pool, an in-memory adaptive
+   * radix tree, a log-structured merge tree or an in-memory skiplist, all but the first ignoring the key types and
+   * taking no included columns
+   * @return A (non-owning) pointer to the metadata of the new table, `NULL_INDEX_INFO` if the index is unique
+   * but the table already holds duplicate keys, if the included columns do not fit into an index entry, if varchar
+   * keys may be longer than VARKEY_MAX_SIZE, if the table is index-organized, or if the table could not be scanned
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, bool is_unique = true,
+                   const std::vector<uint32_t> &include_attrs = {},
+                   IndexType index_type = IndexType::BPlusTreeIndex) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -218,7 +283,7 @@ class Catalog {
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, is_unique, include_attrs);
 
     // Construct the index, take ownership of metadata
     // TODO(Kyle): We should update the API for CreateIndex
@@ -226,21 +291,93 @@ class Catalog {
     // just the key, value, and comparator types
 
     // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
-
-    // Populate the index with all tuples in table heap
+    // A single integer column gets a tree over native integers instead of the requested generic key, and
+    // keys with varchar columns a tree over variable length keys, which store strings in as many bytes as they need.
+    // Non-unique indexes append the RID to every key, so that their trees order entries by (key, rid).
+    // Covering indexes store their entries in full in generic keys, compared on the key columns only.
+    // Adaptive radix trees, log-structured merge trees and skiplists store the normalized encoding of any key and need
+    // none of that.
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    // the rows of an index-organized table have no RIDs for an index to point at
+    if (table_meta->clustered_table_ != nullptr) {
+      return NULL_INDEX_INFO;
+    }
+    const auto *index_key_schema = meta->GetKeySchema();
+    const bool is_integer =
+        index_key_schema->GetColumnCount() == 1 && index_key_schema->GetColumn(0).GetType() == TypeId::INTEGER;
+    const bool is_bigint =
+        index_key_schema->GetColumnCount() == 1 && index_key_schema->GetColumn(0).GetType() == TypeId::BIGINT;
+    const size_t entry_size = NormalizedKey::MaxEncodedSize(meta->GetEntrySchema());
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::ARTIndex) {
+      if (!include_attrs.empty()) {
+        return NULL_INDEX_INFO;
+      }
+      index = BuildInMemoryIndex<ARTIndex>(txn, std::move(meta), heap, schema);
+    } else if (index_type == IndexType::SkipListIndex) {
+      if (!include_attrs.empty()) {
+        return NULL_INDEX_INFO;
+      }
+      index = BuildInMemoryIndex<SkipListIndex>(txn, std::move(meta), heap, schema);
+    } else if (index_type == IndexType::LSMIndex) {
+      if (!include_attrs.empty()) {
+        return NULL_INDEX_INFO;
+      }
+      index = BuildLSMIndex(txn, std::move(meta), heap, schema);
+    } else if (!include_attrs.empty() && entry_size > 64) {
+      return NULL_INDEX_INFO;
+    } else if (!include_attrs.empty() && entry_size <= 16) {
+      using Comparator = CoveringComparator<GenericComparator<16>>;
+      if (is_unique) {
+        index =
+            BuildBPlusTreeIndex<BPlusTreeIndex<GenericKey<16>, RID, Comparator>>(txn, std::move(meta), heap, schema);
+      } else {
+        index = BuildBPlusTreeIndex<BPlusTreeIndex<NonUniqueKey<GenericKey<16>>, RID, NonUniqueComparator<Comparator>>>(
+            txn, std::move(meta), heap, schema);
+      }
+    } else if (!include_attrs.empty()) {
+      using Comparator = CoveringComparator<GenericComparator<64>>;
+      if (is_unique) {
+        index =
+            BuildBPlusTreeIndex<BPlusTreeIndex<GenericKey<64>, RID, Comparator>>(txn, std::move(meta), heap, schema);
+      } else {
+        index = BuildBPlusTreeIndex<BPlusTreeIndex<NonUniqueKey<GenericKey<64>>, RID, NonUniqueComparator<Comparator>>>(
+            txn, std::move(meta), heap, schema);
+      }
+    } else if (HasVarcharColumn(*index_key_schema) && !VarKey::Fits(index_key_schema, !is_unique)) {
+      // a VarKey would truncate the longest keys, or the RID of a non-unique index, and distinct keys could collide
+      return NULL_INDEX_INFO;
+    } else if (is_unique && is_integer) {
+      index = BuildBPlusTreeIndex<BPlusTreeIndexForOneIntegerColumn>(txn, std::move(meta), heap, schema);
+    } else if (is_unique && is_bigint) {
+      index = BuildBPlusTreeIndex<BPlusTreeIndexForOneBigintColumn>(txn, std::move(meta), heap, schema);
+    } else if (is_unique && HasVarcharColumn(*index_key_schema)) {
+      index = BuildBPlusTreeIndex<BPlusTreeIndex<VarKey, RID, VarKeyComparator>>(txn, std::move(meta), heap, schema);
+    } else if (is_unique) {
+      index = BuildBPlusTreeIndex<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(txn, std::move(meta), heap,
+                                                                                     schema);
+    } else if (is_integer) {
+      index = BuildBPlusTreeIndex<NonUniqueBPlusTreeIndexForOneIntegerColumn>(txn, std::move(meta), heap, schema);
+    } else if (is_bigint) {
+      index = BuildBPlusTreeIndex<NonUniqueBPlusTreeIndexForOneBigintColumn>(txn, std::move(meta), heap, schema);
+    } else if (HasVarcharColumn(*index_key_schema)) {
+      index = BuildBPlusTreeIndex<BPlusTreeIndex<VarKey, RID, NonUniqueComparator<VarKeyComparator>>>(
+          txn, std::move(meta), heap, schema);
+    } else {
+      index = BuildBPlusTreeIndex<BPlusTreeIndex<NonUniqueKey<KeyType>, ValueType, NonUniqueComparator<KeyComparator>>>(
+          txn, std::move(meta), heap, schema);
+    }
+    if (index == nullptr) {
+      return NULL_INDEX_INFO;
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -333,6 +470,25 @@ class Catalog {
     return indexes;
   }
 
+  /**
+   * Gather fresh statistics on every index of the table `table_name` that keeps them, replacing those of the last
+   * call. This is what ANALYZE runs.
+   * @param txn The transaction in which the statistics are gathered
+   * @param table_name The name of the table whose indexes to analyze
+   * @return The number of indexes analyzed, 0 if the table does not exist
+   */
+  auto AnalyzeTable(Transaction *txn, const std::string &table_name) -> size_t {
+    size_t analyzed = 0;
+    for (auto *index_info : GetTableIndexes(table_name)) {
+      IndexStatistics stats;
+      if (index_info->index_->CollectStatistics(&stats, txn)) {
+        index_info->stats_ = std::move(stats);
+        analyzed++;
+      }
+    }
+    return analyzed;
+  }
+
   auto GetTableNames() -> std::vector<std::string> {
     std::vector<std::string> result;
     for (const auto &x : table_names_) {
@@ -342,6 +498,119 @@ class Catalog {
   }
 
  private:
+  static auto HasVarcharColumn(const Schema &key_schema) -> bool {
+    const auto &columns = key_schema.GetColumns();
+    return std::any_of(columns.begin(), columns.end(),
+                       [](const Column &column) { return column.GetType() == TypeId::VARCHAR; });
+  }
+
+  /**
+   * The number of threads that scan a table to build an index: one per core, but no more than one per
+   * SCAN_FRAMES_PER_WORKER frames of the buffer pool, as each keeps a page pinned and the index needs frames too.
+   */
+  auto IndexBuildWorkers() const -> size_t {
+    static constexpr size_t SCAN_FRAMES_PER_WORKER = 16;
+    return std::max<size_t>(
+        1, std::min<size_t>(std::thread::hardware_concurrency(), bpm_->GetPoolSize() / SCAN_FRAMES_PER_WORKER));
+  }
+
+  /**
+   * Construct a B+ tree index and populate it with all tuples in the table heap: collect the entries
+   * with a parallel scan, then build the tree bottom-up rather than inserting tuple by tuple.
+   * @return the populated index, nullptr if it is unique and the table holds duplicate keys or the scan failed
+   */
+  template <class BPlusTreeIndexType>
+  auto BuildBPlusTreeIndex(Transaction *txn, std::unique_ptr<IndexMetadata> &&meta, TableHeap *heap,
+                           const Schema &schema) -> std::unique_ptr<Index> {
+    using EntryType = typename BPlusTreeIndexType::EntryType;
+    auto index = std::make_unique<BPlusTreeIndexType>(std::move(meta), bpm_);
+    const size_t num_workers = IndexBuildWorkers();
+    std::vector<std::vector<EntryType>> runs(num_workers);
+    bool scanned = heap->ParallelScan(
+        num_workers,
+        [&](size_t worker, const Tuple &tuple) {
+          auto key = tuple.KeyFromTuple(schema, *index->GetEntrySchema(), index->GetEntryAttrs());
+          runs[worker].emplace_back(index->MakeKey(key, tuple.GetRid()), tuple.GetRid());
+        },
+        txn);
+    if (!scanned) {
+      return nullptr;
+    }
+    std::vector<EntryType> entries;
+    for (auto &run : runs) {
+      entries.insert(entries.end(), run.begin(), run.end());
+    }
+    if (!index->BulkLoad(&entries, INDEX_FILL_FACTOR)) {
+      return nullptr;
+    }
+    return index;
+  }
+
+  /**
+   * Construct an in-memory index that takes concurrent writers, an ARTIndex or a SkipListIndex, and populate it with
+   * all tuples in the table heap, the scan workers inserting into it concurrently.
+   * @return the populated index, nullptr if it is unique and the table holds duplicate keys or the scan failed
+   */
+  template <typename InMemoryIndex>
+  auto BuildInMemoryIndex(Transaction *txn, std::unique_ptr<IndexMetadata> &&meta, TableHeap *heap,
+                          const Schema &schema) -> std::unique_ptr<Index> {
+    auto index = std::make_unique<InMemoryIndex>(std::move(meta));
+    const size_t num_workers = IndexBuildWorkers();
+    std::atomic<size_t> num_tuples{0};
+    bool scanned = heap->ParallelScan(
+        num_workers,
+        [&](size_t /* worker */, const Tuple &tuple) {
+          index->InsertEntry(tuple.KeyFromTuple(schema, *index->GetEntrySchema(), index->GetEntryAttrs()),
+                             tuple.GetRid(), txn);
+          num_tuples.fetch_add(1, std::memory_order_relaxed);
+        },
+        txn);
+    if (!scanned) {
+      return nullptr;
+    }
+    // a unique index drops the entries whose key is taken already
+    if (index->Size() != num_tuples.load()) {
+      return nullptr;
+    }
+    return index;
+  }
+
+  /**
+   * Construct a log-structured merge tree index and populate it with all tuples in the table heap: collect the
+   * entries with a parallel scan, sort them and write them out as a single run.
+   * @return the populated index, nullptr if it is unique and the table holds duplicate keys or the scan failed
+   */
+  auto BuildLSMIndex(Transaction *txn, std::unique_ptr<IndexMetadata> &&meta, TableHeap *heap, const Schema &schema)
+      -> std::unique_ptr<Index> {
+    auto index = std::make_unique<LSMIndex>(std::move(meta), bpm_);
+    const size_t num_workers = IndexBuildWorkers();
+    std::vector<std::vector<std::pair<std::string, RID>>> runs(num_workers);
+    bool scanned = heap->ParallelScan(
+        num_workers,
+        [&](size_t worker, const Tuple &tuple) {
+          auto key = tuple.KeyFromTuple(schema, *index->GetEntrySchema(), index->GetEntryAttrs());
+          runs[worker].emplace_back(index->MakeKey(key, tuple.GetRid()), tuple.GetRid());
+        },
+        txn);
+    if (!scanned) {
+      return nullptr;
+    }
+    std::vector<std::pair<std::string, RID>> entries;
+    for (auto &run : runs) {
+      std::move(run.begin(), run.end(), std::back_inserter(entries));
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto &left, const auto &right) { return left.first < right.first; });
+    // keys of non-unique indexes include the RID, so only unique indexes can have duplicates
+    if (std::adjacent_find(entries.begin(), entries.end(), [](const auto &left, const auto &right) {
+          return left.first == right.first;
+        }) != entries.end()) {
+      return nullptr;
+    }
+    index->GetTree().BulkLoad(entries);
+    return index;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -36,6 +36,7 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr double INDEX_FILL_FACTOR = 0.9;  // fraction of each B+ tree node filled when building an index
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/common/epoch_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * Epoch based reclamation for latch-free structures, whose readers may still
+ * hold a pointer to an object that a writer just unlinked. Every operation
+ * runs within an EpochGuard, which publishes the epoch it entered in; an object
+ * retired in epoch e is freed once every active operation entered after e,
+ * since those started when the object was unlinked already.
+ */
+class EpochManager {
+ public:
+  EpochManager() = default;
+  ~EpochManager();
+
+  EpochManager(const EpochManager &) = delete;
+  auto operator=(const EpochManager &) -> EpochManager & = delete;
+
+  /** @return the slot the operation is registered in */
+  auto Enter() -> size_t;
+  void Exit(size_t slot);
+
+  /** Hand an unlinked object over, deleter frees it once no operation can reach it anymore */
+  void Retire(void *object, void (*deleter)(void *));
+
+ private:
+  static constexpr size_t SLOTS = 128;
+  static constexpr size_t RETIRE_BATCH = 64;
+  void Reclaim();
+
+  struct Retired {
+    uint64_t epoch_;
+    void *object_;
+    void (*deleter_)(void *);
+  };
+
+  std::atomic<uint64_t> global_epoch_{1};
+  // the epoch each active operation entered in, 0 for free slots
+  std::array<std::atomic<uint64_t>, SLOTS> slots_{};
+  std::mutex latch_;
+  std::vector<Retired> retired_;
+};
+
+/** Marks an operation active in an epoch manager for its lifetime */
+class EpochGuard {
+ public:
+  explicit EpochGuard(EpochManager *epochs) : epochs_(epochs), slot_(epochs->Enter()) {}
+  ~EpochGuard() {
+    if (epochs_ != nullptr) {
+      epochs_->Exit(slot_);
+    }
+  }
+
+  EpochGuard(const EpochGuard &) = delete;
+  auto operator=(const EpochGuard &) -> EpochGuard & = delete;
+  EpochGuard(EpochGuard &&other) noexcept : epochs_(std::exchange(other.epochs_, nullptr)), slot_(other.slot_) {}
+  auto operator=(EpochGuard &&other) noexcept -> EpochGuard & {
+    if (this != &other) {
+      if (epochs_ != nullptr) {
+        epochs_->Exit(slot_);
+      }
+      epochs_ = std::exchange(other.epochs_, nullptr);
+      slot_ = other.slot_;
+    }
+    return *this;
+  }
+
+ private:
+  EpochManager *epochs_;
+  size_t slot_;
+};
+
+}  // namespace bustub
@@ -64,8 +64,8 @@ using index_oid_t = uint32_t;
  */
 class TableWriteRecord {
  public:
-  TableWriteRecord(RID rid, WType wtype, const Tuple &tuple, TableHeap *table)
-      : rid_(rid), wtype_(wtype), tuple_(tuple), table_(table) {}
+  TableWriteRecord(RID rid, WType wtype, const Tuple &tuple, TableHeap *table, uint32_t count = 1)
+      : rid_(rid), wtype_(wtype), tuple_(tuple), table_(table), count_(count) {}
 
   RID rid_;
   WType wtype_;
@@ -73,6 +73,8 @@ class TableWriteRecord {
   Tuple tuple_;
   /** The table heap specifies which table this write record is for. */
   TableHeap *table_;
+  /** A batch insert records count_ tuples in consecutive slots of a page, starting at rid_, as one write. */
+  uint32_t count_;
 };
 
 /**
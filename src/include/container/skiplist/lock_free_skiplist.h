@@ -0,0 +1,317 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_skiplist.h
+//
+// Identification: src/include/container/skiplist/lock_free_skiplist.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <utility>
+
+#include "common/epoch_manager.h"
+
+namespace bustub {
+
+/**
+ * Ordered map in memory that threads modify without taking any latch
+ * (Fraser, "Practical lock-freedom", 2004; Herlihy & Shavit, ch. 14.4):
+ *  - every node is linked into level 0 and, with probability 1/4 per level,
+ *    into the levels above, which let searches skip ahead.
+ *  - an insert links the node into level 0 with a compare-and-swap, which
+ *    makes it visible, then into its upper levels one by one.
+ *  - a remove marks the next pointers of the node from the top down, setting
+ *    their lowest bit; marking level 0 is what removes the key, so when two
+ *    removes race, the one that marks it wins. Marked nodes are unlinked by
+ *    whichever operation passes them next.
+ *  - lookups and iterators never write, they step over marked nodes.
+ *
+ * Nodes are freed through an EpochManager once they are unlinked from every
+ * level: both the insert that linked a node and the remove that marked it
+ * search for its key once they are done with it, which unlinks it, and the
+ * second of them to finish retires it.
+ *
+ * Keys and values must be default constructible and copyable; Compare is a
+ * strict weak ordering of the keys.
+ */
+template <typename K, typename V, typename Compare = std::less<K>>
+class LockFreeSkipList {
+ private:
+  struct Node;
+
+ public:
+  /** Forward iterator over the entries, which keeps the nodes it may reach alive while it exists */
+  class Iterator {
+   public:
+    auto IsEnd() const -> bool { return node_ == nullptr; }
+
+    auto Key() const -> const K & { return node_->key_; }
+
+    auto Value() const -> const V & { return node_->value_; }
+
+    /** Move to the next entry that is not removed */
+    auto operator++() -> Iterator & {
+      node_ = SkipRemoved(Unmark(node_->next_[0].load()));
+      return *this;
+    }
+
+   private:
+    friend class LockFreeSkipList;
+    Iterator(EpochGuard &&guard, const Node *node) : guard_(std::move(guard)), node_(SkipRemoved(node)) {}
+
+    EpochGuard guard_;
+    const Node *node_;
+  };
+
+  explicit LockFreeSkipList(Compare comparator = Compare())
+      : comparator_(std::move(comparator)), head_(new Node(K(), V(), MAX_HEIGHT)) {}
+
+  ~LockFreeSkipList() {
+    // nodes that were unlinked already belong to epochs_
+    const Node *node = head_;
+    while (node != nullptr) {
+      const Node *next = Unmark(node->next_[0].load(std::memory_order_relaxed));
+      delete node;
+      node = next;
+    }
+  }
+
+  LockFreeSkipList(const LockFreeSkipList &) = delete;
+  auto operator=(const LockFreeSkipList &) -> LockFreeSkipList & = delete;
+
+  /** @return false if key is in the list already */
+  auto Insert(const K &key, const V &value) -> bool {
+    EpochGuard guard(&epochs_);
+    Node *preds[MAX_HEIGHT];
+    Node *succs[MAX_HEIGHT];
+    Node *node = nullptr;
+    while (true) {
+      if (Find(key, preds, succs)) {
+        delete node;
+        return false;
+      }
+      if (node == nullptr) {
+        node = new Node(key, value, RandomHeight());
+      }
+      for (int level = 0; level < node->height_; level++) {
+        node->next_[level].store(Mark(succs[level], false), std::memory_order_relaxed);
+      }
+      auto expected = Mark(succs[0], false);
+      if (preds[0]->next_[0].compare_exchange_strong(expected, Mark(node, false))) {
+        break;
+      }
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+
+    // link the upper levels, unless a remove of the key starts marking the node meanwhile
+    for (int level = 1; level < node->height_; level++) {
+      while (true) {
+        auto next = node->next_[level].load();
+        if (IsMarked(next)) {
+          break;
+        }
+        auto expected = Mark(succs[level], false);
+        if (preds[level]->next_[level].compare_exchange_strong(expected, Mark(node, false))) {
+          break;
+        }
+        Find(key, preds, succs);
+        if (!node->next_[level].compare_exchange_strong(next, Mark(succs[level], false))) {
+          break;
+        }
+      }
+    }
+    if (IsMarked(node->next_[0].load())) {
+      // the node may have been linked into a level after the remove unlinked it
+      Find(key, preds, succs);
+    }
+    Release(node);
+    return true;
+  }
+
+  /** @return false if key is not in the list */
+  auto Remove(const K &key) -> bool {
+    EpochGuard guard(&epochs_);
+    Node *preds[MAX_HEIGHT];
+    Node *succs[MAX_HEIGHT];
+    if (!Find(key, preds, succs)) {
+      return false;
+    }
+    Node *node = succs[0];
+    for (int level = node->height_ - 1; level > 0; level--) {
+      auto next = node->next_[level].load();
+      while (!IsMarked(next) && !node->next_[level].compare_exchange_weak(next, next | 1)) {
+      }
+    }
+    auto next = node->next_[0].load();
+    while (true) {
+      if (IsMarked(next)) {
+        // a concurrent remove of the key won
+        return false;
+      }
+      if (node->next_[0].compare_exchange_weak(next, next | 1)) {
+        break;
+      }
+    }
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    Find(key, preds, succs);
+    Release(node);
+    return true;
+  }
+
+  /** @return whether key is in the list, its value then goes to value */
+  auto Lookup(const K &key, V *value) const -> bool {
+    EpochGuard guard(&epochs_);
+    const Node *node = FindGreaterOrEqual(key);
+    if (node == nullptr || comparator_(key, node->key_)) {
+      return false;
+    }
+    *value = node->value_;
+    return true;
+  }
+
+  /** @return an iterator at the first entry */
+  auto Begin() const -> Iterator {
+    EpochGuard guard(&epochs_);
+    const Node *first = Unmark(head_->next_[0].load());
+    return Iterator(std::move(guard), first);
+  }
+
+  /** @return an iterator at the first entry whose key is not less than key */
+  auto LowerBound(const K &key) const -> Iterator {
+    EpochGuard guard(&epochs_);
+    const Node *node = FindGreaterOrEqual(key);
+    return Iterator(std::move(guard), node);
+  }
+
+  auto Size() const -> size_t { return size_.load(std::memory_order_relaxed); }
+
+  // a list of n entries uses about log4(n) levels
+  static constexpr int MAX_HEIGHT = 16;
+
+ private:
+  struct Node {
+    Node(const K &key, const V &value, int height)
+        : key_(key), value_(value), height_(height), next_(new std::atomic<uintptr_t>[height]) {
+      for (int level = 0; level < height; level++) {
+        next_[level].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    const K key_;
+    const V value_;
+    const int height_;
+    // the inserting and the removing operation, the node is retired once both let go
+    std::atomic<int> owners_{2};
+    // the successor on every level, whose lowest bit marks this node removed from that level
+    std::unique_ptr<std::atomic<uintptr_t>[]> next_;
+  };
+
+  static auto Mark(const Node *node, bool marked) -> uintptr_t {
+    return reinterpret_cast<uintptr_t>(node) | static_cast<uintptr_t>(marked);
+  }
+  static auto IsMarked(uintptr_t next) -> bool { return (next & 1) != 0; }
+  static auto Unmark(uintptr_t next) -> Node * { return reinterpret_cast<Node *>(next & ~static_cast<uintptr_t>(1)); }
+
+  /** @return node, or the first node after it on level 0 that is not removed */
+  static auto SkipRemoved(const Node *node) -> const Node * {
+    while (node != nullptr) {
+      auto next = node->next_[0].load();
+      if (!IsMarked(next)) {
+        break;
+      }
+      node = Unmark(next);
+    }
+    return node;
+  }
+
+  static auto RandomHeight() -> int {
+    thread_local std::mt19937 rng(std::random_device{}());
+    int height = 1;
+    while (height < MAX_HEIGHT && (rng() & 3) == 0) {
+      height++;
+    }
+    return height;
+  }
+
+  static void DeleteRetired(void *node) { delete static_cast<Node *>(node); }
+
+  /**
+   * Fill preds and succs with the nodes around key on every level, unlinking the marked nodes on the way. succs holds
+   * the first node whose key is not less than key, preds the node before it.
+   * @return whether succs[0] holds key
+   */
+  auto Find(const K &key, Node **preds, Node **succs) -> bool {
+    while (!TryFind(key, preds, succs)) {
+    }
+    return succs[0] != nullptr && !comparator_(key, succs[0]->key_);
+  }
+
+  /** @return false if a node could not be unlinked, and the search has to start over */
+  auto TryFind(const K &key, Node **preds, Node **succs) -> bool {
+    Node *pred = head_;
+    for (int level = MAX_HEIGHT - 1; level >= 0; level--) {
+      Node *curr = Unmark(pred->next_[level].load());
+      while (curr != nullptr) {
+        auto next = curr->next_[level].load();
+        if (IsMarked(next)) {
+          // fails if pred is marked itself, or anything changed after it
+          auto expected = Mark(curr, false);
+          if (!pred->next_[level].compare_exchange_strong(expected, next & ~static_cast<uintptr_t>(1))) {
+            return false;
+          }
+          curr = Unmark(next);
+          continue;
+        }
+        if (!comparator_(curr->key_, key)) {
+          break;
+        }
+        pred = curr;
+        curr = Unmark(next);
+      }
+      preds[level] = pred;
+      succs[level] = curr;
+    }
+    return true;
+  }
+
+  /** @return the first node whose key is not less than key and that is not removed, without unlinking anything */
+  auto FindGreaterOrEqual(const K &key) const -> const Node * {
+    const Node *pred = head_;
+    const Node *curr = nullptr;
+    for (int level = MAX_HEIGHT - 1; level >= 0; level--) {
+      curr = Unmark(pred->next_[level].load());
+      while (curr != nullptr) {
+        auto next = curr->next_[level].load();
+        if (!IsMarked(next)) {
+          if (!comparator_(curr->key_, key)) {
+            break;
+          }
+          pred = curr;
+        }
+        curr = Unmark(next);
+      }
+    }
+    return curr;
+  }
+
+  void Release(Node *node) {
+    if (node->owners_.fetch_sub(1) == 1) {
+      epochs_.Retire(node, DeleteRetired);
+    }
+  }
+
+  Compare comparator_;
+  Node *head_;
+  std::atomic<size_t> size_{0};
+  mutable EpochManager epochs_;
+};
+
+}  // namespace bustub
@@ -85,7 +85,7 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
+  /** @brief check if the index can be matched, preferring the analyzed index with the fewest levels */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
@@ -95,8 +95,8 @@ class Optimizer {
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
-   * doesn't support statistics for now, so it's the only way for you to get the table size :(
+   * @brief get the estimated cardinality for a table. Useful when join reordering. Tables with an index that ANALYZE
+   * has run on are as large as the index, the size of other tables is guessed from suffixes of their name like `_1m`.
    *
    * @param table_name
    * @return std::optional<size_t>
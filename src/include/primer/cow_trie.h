@@ -0,0 +1,256 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cow_trie.h
+//
+// Identification: src/include/primer/cow_trie.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+class CowTrie;
+
+/**
+ * CowTrieNode is a node of a CowTrie. Once a node is reachable from a published
+ * root it never changes again: writers copy the nodes they would modify instead.
+ * Children are shared between all the versions of the trie that contain them.
+ */
+class CowTrieNode {
+ public:
+  CowTrieNode() = default;
+  virtual ~CowTrieNode() = default;
+
+  /** @return whether a key ends at this node */
+  auto IsEndNode() const -> bool { return is_end_; }
+
+  auto HasChildren() const -> bool { return !children_.empty(); }
+
+  /** @return the child node for key_char, nullptr if there is none */
+  auto GetChildNode(char key_char) const -> const CowTrieNode * {
+    auto it = children_.find(key_char);
+    return it == children_.end() ? nullptr : it->second.get();
+  }
+
+ protected:
+  friend class CowTrie;
+
+  /** @return a mutable copy of this node that shares its children and value */
+  virtual auto Clone() const -> std::unique_ptr<CowTrieNode> { return std::make_unique<CowTrieNode>(*this); }
+
+  /** A map of all child nodes of this node, by the key char leading to them */
+  std::unordered_map<char, std::shared_ptr<const CowTrieNode>> children_;
+  /** whether this node marks the end of a key, and so is a CowTrieNodeWithValue */
+  bool is_end_{false};
+};
+
+/**
+ * CowTrieNodeWithValue marks the end of a key and holds its value. The value is
+ * held through a shared pointer, so copying the node does not copy the value and
+ * T need not be copyable.
+ */
+template <typename T>
+class CowTrieNodeWithValue : public CowTrieNode {
+ public:
+  explicit CowTrieNodeWithValue(std::shared_ptr<const T> value) : value_(std::move(value)) { this->is_end_ = true; }
+
+  auto GetValue() const -> const T & { return *value_; }
+
+ protected:
+  auto Clone() const -> std::unique_ptr<CowTrieNode> override {
+    return std::make_unique<CowTrieNodeWithValue<T>>(*this);
+  }
+
+ private:
+  std::shared_ptr<const T> value_;
+};
+
+/**
+ * CowTrieSnapshot is an immutable version of a CowTrie. It keeps every node of
+ * its version alive, so values it hands out stay valid for its lifetime no
+ * matter what is written to the trie in the meantime.
+ */
+class CowTrieSnapshot {
+ public:
+  CowTrieSnapshot() = default;
+  explicit CowTrieSnapshot(std::shared_ptr<const CowTrieNode> root) : root_(std::move(root)) {}
+
+  /**
+   * @return the value of key, nullptr if key is empty, not in this version, or
+   * its value is not of type T. The pointer is valid while the snapshot is.
+   */
+  template <typename T>
+  auto Get(const std::string &key) const -> const T * {
+    if (key.empty()) {
+      return nullptr;
+    }
+    const CowTrieNode *cur = root_.get();
+    for (auto key_char : key) {
+      if (cur == nullptr) {
+        return nullptr;
+      }
+      cur = cur->GetChildNode(key_char);
+    }
+    if (cur == nullptr || !cur->IsEndNode()) {
+      return nullptr;
+    }
+    auto node = dynamic_cast<const CowTrieNodeWithValue<T> *>(cur);
+    return node == nullptr ? nullptr : &node->GetValue();
+  }
+
+  /** Same contract as Trie::GetValue */
+  template <typename T>
+  auto GetValue(const std::string &key, bool *success) const -> T {
+    auto value = Get<T>(key);
+    *success = value != nullptr;
+    return value == nullptr ? T() : *value;
+  }
+
+  auto GetRoot() const -> const std::shared_ptr<const CowTrieNode> & { return root_; }
+
+ private:
+  std::shared_ptr<const CowTrieNode> root_;
+};
+
+/**
+ * CowTrie is a key-value store with the interface of Trie for data that is read
+ * far more often than it is written, like catalog and configuration lookups.
+ *
+ * Writers never modify a published node. They copy the path from the root to
+ * the node they change, leave every other subtree shared with the previous
+ * version, and publish the new root with a single atomic store. Readers load
+ * the current root atomically and walk an immutable version, so they never
+ * wait on writers or on each other. Writers are serialized by a mutex so that
+ * none of them loses the update of another one.
+ *
+ * Old versions are reclaimed through reference counting: a version is freed,
+ * down to the nodes no newer version shares, once the last snapshot of it goes
+ * away.
+ */
+class CowTrie {
+ public:
+  CowTrie() = default;
+
+  CowTrie(const CowTrie &) = delete;
+  auto operator=(const CowTrie &) -> CowTrie & = delete;
+
+  /** @return the current version of the trie, which never changes afterwards */
+  auto GetSnapshot() const -> CowTrieSnapshot { return CowTrieSnapshot(std::atomic_load(&root_)); }
+
+  /**
+   * @brief Insert key-value pair into the trie, with the contract of Trie::Insert:
+   * it fails for an empty key and never overwrites the value of an existing key.
+   * @return True if insertion succeeds, false otherwise
+   */
+  template <typename T>
+  auto Insert(const std::string &key, T value) -> bool {
+    return Write<T>(key, std::make_shared<const T>(std::move(value)), false);
+  }
+
+  /**
+   * @brief Set the value of key, replacing the value it has already, whatever its type.
+   * @return True unless key is empty
+   */
+  template <typename T>
+  auto Put(const std::string &key, T value) -> bool {
+    return Write<T>(key, std::make_shared<const T>(std::move(value)), true);
+  }
+
+  /**
+   * @brief Remove key from the trie, along with the nodes no other key needs anymore.
+   * @return True if the key existed and is removed, false otherwise
+   */
+  auto Remove(const std::string &key) -> bool {
+    if (key.empty()) {
+      return false;
+    }
+    std::scoped_lock lock(write_latch_);
+    std::vector<const CowTrieNode *> path;
+    if (!FindPath(key, &path) || !path.back()->IsEndNode()) {
+      return false;
+    }
+    // the end node turns into a plain node if other keys go through it
+    std::shared_ptr<const CowTrieNode> child;
+    if (path.back()->HasChildren()) {
+      auto node = std::make_shared<CowTrieNode>();
+      node->children_ = path.back()->children_;
+      child = std::move(node);
+    }
+    for (size_t i = key.size(); i-- > 0;) {
+      std::unique_ptr<CowTrieNode> copy = path[i]->Clone();
+      if (child == nullptr) {
+        copy->children_.erase(key[i]);
+      } else {
+        copy->children_[key[i]] = std::move(child);
+      }
+      child = copy->HasChildren() || copy->IsEndNode() ? std::shared_ptr<const CowTrieNode>(std::move(copy)) : nullptr;
+    }
+    std::atomic_store(&root_, std::move(child));
+    return true;
+  }
+
+  /** Same contract as Trie::GetValue, on the current version of the trie */
+  template <typename T>
+  auto GetValue(const std::string &key, bool *success) const -> T {
+    return GetSnapshot().GetValue<T>(key, success);
+  }
+
+ private:
+  /**
+   * Fill path with the nodes from the root along key, one more than key has
+   * chars, with nullptr from where key leaves the trie.
+   * @return whether all of key is in the trie
+   */
+  auto FindPath(const std::string &key, std::vector<const CowTrieNode *> *path) const -> bool {
+    const CowTrieNode *cur = root_.get();
+    path->reserve(key.size() + 1);
+    path->push_back(cur);
+    for (auto key_char : key) {
+      cur = cur == nullptr ? nullptr : cur->GetChildNode(key_char);
+      path->push_back(cur);
+    }
+    return cur != nullptr;
+  }
+
+  template <typename T>
+  auto Write(const std::string &key, std::shared_ptr<const T> value, bool overwrite) -> bool {
+    if (key.empty()) {
+      return false;
+    }
+    std::scoped_lock lock(write_latch_);
+    std::vector<const CowTrieNode *> path;
+    if (FindPath(key, &path) && path.back()->IsEndNode() && !overwrite) {
+      return false;
+    }
+    // the new end node keeps the children of the node it replaces, then every node up to the root is copied
+    auto end = std::make_shared<CowTrieNodeWithValue<T>>(std::move(value));
+    if (path.back() != nullptr) {
+      end->children_ = path.back()->children_;
+    }
+    std::shared_ptr<const CowTrieNode> child = std::move(end);
+    for (size_t i = key.size(); i-- > 0;) {
+      std::unique_ptr<CowTrieNode> copy = path[i] == nullptr ? std::make_unique<CowTrieNode>() : path[i]->Clone();
+      copy->children_[key[i]] = std::move(child);
+      child = std::move(copy);
+    }
+    std::atomic_store(&root_, std::move(child));
+    return true;
+  }
+
+  /* Root of the current version, nullptr while the trie is empty. Only accessed through the std::atomic_ functions,
+   * except by writers under write_latch_, which are the only ones to store it. */
+  std::shared_ptr<const CowTrieNode> root_;
+  std::mutex write_latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_hash_index.h
+//
+// Identification: src/include/storage/index/adaptive_hash_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rwlatch.h"
+#include "container/hash/hash_function.h"
+
+namespace bustub {
+
+/** Counters of an AdaptiveHashIndex */
+struct AdaptiveHashIndexStats {
+  // lookups answered from the hash, and lookups that went to the tree
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  // hot leaves whose keys were hashed, and the keys hashed right now
+  uint64_t leaves_built_{0};
+  uint64_t entries_{0};
+
+  auto HitRate() const -> double {
+    uint64_t lookups = hits_ + misses_;
+    return lookups == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(lookups);
+  }
+};
+
+/**
+ * In-memory hash from the keys of hot B+ tree leaves straight to their
+ * values, in the spirit of InnoDB's adaptive hash index: point lookups it can
+ * answer skip the descent through the buffer pool.
+ *
+ * Lookups the hash misses report the leaf they ended in. Once a leaf has seen
+ * hot_threshold of them, the caller copies its entries and hands them to
+ * AddLeaf. The hash maps keys to values rather than to leaf slots, so splits
+ * and merges leave it valid; removing a key from the tree must Invalidate it.
+ * AddLeaf drops entries copied before an invalidation that raced with the copy.
+ * The hash is cleared once it would exceed max_entries, and adapts anew.
+ *
+ * Keys are hashed on their bytes, so only key types whose comparator reports
+ * equality for equal bytes alone (GenericKey, IntegerKey) are supported.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class AdaptiveHashIndex {
+ public:
+  explicit AdaptiveHashIndex(const KeyComparator &comparator, uint32_t hot_threshold = 16,
+                             size_t max_entries = 1 << 16)
+      : entries_(0, KeyHash(), KeyEqual{comparator}), hot_threshold_(hot_threshold), max_entries_(max_entries) {}
+
+  /** @return whether key is hashed, its value then goes to value */
+  auto Lookup(const KeyType &key, ValueType *value) -> bool {
+    latch_.RLock();
+    auto it = entries_.find(key);
+    bool found = it != entries_.end();
+    if (found) {
+      *value = it->second;
+    }
+    latch_.RUnlock();
+    (found ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+    return found;
+  }
+
+  /** Count a lookup the hash missed that ended in leaf_page_id. @return whether the leaf just became hot */
+  auto RecordLeafAccess(page_id_t leaf_page_id) -> bool {
+    std::scoped_lock lock(leaf_hits_latch_);
+    uint32_t &count = leaf_hits_[leaf_page_id];
+    if (++count < hot_threshold_) {
+      return false;
+    }
+    count = 0;
+    return true;
+  }
+
+  /** To be read before copying the entries of a leaf for AddLeaf */
+  auto GetEpoch() const -> uint64_t { return epoch_.load(); }
+
+  /** Hash the entries of a hot leaf, unless a key was invalidated since epoch was read */
+  void AddLeaf(const std::vector<std::pair<KeyType, ValueType>> &entries, uint64_t epoch) {
+    latch_.WLock();
+    if (epoch_.load() == epoch) {
+      if (entries_.size() + entries.size() > max_entries_) {
+        entries_.clear();
+      }
+      for (const auto &[key, value] : entries) {
+        entries_[key] = value;
+      }
+      leaves_built_.fetch_add(1, std::memory_order_relaxed);
+    }
+    latch_.WUnlock();
+  }
+
+  /** Forget key, after it was removed from the tree */
+  void Invalidate(const KeyType &key) {
+    latch_.WLock();
+    epoch_.fetch_add(1);
+    entries_.erase(key);
+    latch_.WUnlock();
+  }
+
+  void Clear() {
+    latch_.WLock();
+    epoch_.fetch_add(1);
+    entries_.clear();
+    latch_.WUnlock();
+    std::scoped_lock lock(leaf_hits_latch_);
+    leaf_hits_.clear();
+  }
+
+  auto GetStats() -> AdaptiveHashIndexStats {
+    AdaptiveHashIndexStats stats;
+    stats.hits_ = hits_.load(std::memory_order_relaxed);
+    stats.misses_ = misses_.load(std::memory_order_relaxed);
+    stats.leaves_built_ = leaves_built_.load(std::memory_order_relaxed);
+    latch_.RLock();
+    stats.entries_ = entries_.size();
+    latch_.RUnlock();
+    return stats;
+  }
+
+ private:
+  struct KeyHash {
+    auto operator()(const KeyType &key) const -> size_t { return HashFunction<KeyType>().GetHash(key); }
+  };
+  struct KeyEqual {
+    auto operator()(const KeyType &lhs, const KeyType &rhs) const -> bool { return comparator_(lhs, rhs) == 0; }
+    KeyComparator comparator_;
+  };
+
+  ReaderWriterLatch latch_;
+  std::unordered_map<KeyType, ValueType, KeyHash, KeyEqual> entries_;
+  // bumped by every invalidation
+  std::atomic<uint64_t> epoch_{0};
+
+  std::mutex leaf_hits_latch_;
+  std::unordered_map<page_id_t, uint32_t> leaf_hits_;
+  uint32_t hot_threshold_;
+  size_t max_entries_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> leaves_built_{0};
+};
+
+}  // namespace bustub
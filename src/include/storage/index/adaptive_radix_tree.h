@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.h
+//
+// Identification: src/include/storage/index/adaptive_radix_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/epoch_manager.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * In-memory adaptive radix tree (Leis et al., ICDE 2013) from byte string keys
+ * to RIDs, the ordered counterpart of the primer Trie:
+ *  - inner nodes come in four sizes, Node4 and Node16 holding sorted key bytes
+ *    next to their children, Node48 a 256 entry byte to slot map and Node256
+ *    the children directly; a node grows and shrinks between them as children
+ *    come and go. Node16 compares all its key bytes at once with SSE2.
+ *  - paths are compressed: an inner node stores the bytes its single child
+ *    chain would have consumed. Only the first MAX_PREFIX of them are kept, a
+ *    lookup skips the rest optimistically and verifies the full key at the leaf.
+ *  - leaves hold the whole key and never change once published.
+ *
+ * Concurrency follows optimistic lock coupling (Leis et al., DaMoN 2016): every
+ * inner node has a version word, readers never write shared memory and only
+ * validate that the versions of the nodes they passed did not change, writers
+ * lock the one or two nodes they modify. Nodes that are unlinked are reclaimed
+ * once no operation that started before can still hold a pointer to them.
+ *
+ * Keys must be prefix free: no key may be a proper prefix of another one, which
+ * the NormalizedKey encoding of a key schema guarantees.
+ */
+class AdaptiveRadixTree {
+ public:
+  AdaptiveRadixTree();
+  ~AdaptiveRadixTree();
+
+  AdaptiveRadixTree(const AdaptiveRadixTree &) = delete;
+  auto operator=(const AdaptiveRadixTree &) -> AdaptiveRadixTree & = delete;
+
+  /** @return false if key is in the tree already */
+  auto Insert(const std::string &key, RID value) -> bool;
+
+  /** @return false if key is not in the tree */
+  auto Remove(const std::string &key) -> bool;
+
+  /** @return whether key is in the tree, its value then goes to value */
+  auto Lookup(const std::string &key, RID *value) const -> bool;
+
+  /**
+   * Call emit with the key and value of every entry within the range, in key order. A null bound leaves the range
+   * open on that side. Under concurrent writes each entry is reported at most once.
+   */
+  void Scan(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+            const std::function<void(const std::string &, RID)> &emit) const;
+
+  auto Size() const -> size_t { return size_.load(std::memory_order_relaxed); }
+
+  /** The number of inner nodes of each layout, Node4 to Node256, for tests and benchmarks */
+  auto GetNodeCounts() const -> std::array<size_t, 4>;
+
+  // bytes of a compressed path an inner node stores itself
+  static constexpr uint32_t MAX_PREFIX = 8;
+
+ private:
+  enum class NodeType : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+  struct Node {
+    explicit Node(NodeType type) : type_(type) {}
+    NodeType type_;
+  };
+  struct Leaf;
+  struct InnerNode;
+  struct Node4;
+  struct Node16;
+  struct Node48;
+  struct Node256;
+  enum class ScanStatus { CONTINUE, STOP, RESTART };
+  struct ScanState;
+
+  auto InsertOptimistic(const std::string &key, RID value, bool *inserted) -> bool;
+  auto RemoveOptimistic(const std::string &key, bool *removed) -> bool;
+  auto LookupOptimistic(const std::string &key, RID *value, bool *found) const -> bool;
+  auto ScanNode(const Node *node, std::string *path, bool low_clear, bool high_clear, ScanState *state) const
+      -> ScanStatus;
+
+  // optimistic lock coupling on the version words of inner nodes
+  static auto ReadLock(const InnerNode *node, uint64_t *version) -> bool;
+  static auto Validate(const InnerNode *node, uint64_t version) -> bool;
+  static auto Upgrade(InnerNode *node, uint64_t version) -> bool;
+  static void WriteUnlock(InnerNode *node);
+  static void WriteUnlockObsolete(InnerNode *node);
+
+  // node layouts
+  static auto FindChild(const InnerNode *node, uint8_t byte) -> Node *;
+  static auto IsFull(const InnerNode *node) -> bool;
+  static auto IsUnderfull(const InnerNode *node) -> bool;
+  static void AddChild(InnerNode *node, uint8_t byte, Node *child);
+  static void ReplaceChild(InnerNode *node, uint8_t byte, Node *child);
+  static void RemoveChild(InnerNode *node, uint8_t byte);
+  static auto Resize(const InnerNode *node, NodeType type) -> InnerNode *;
+  static void ChildrenInOrder(const InnerNode *node, std::vector<std::pair<uint8_t, Node *>> *children,
+                              uint8_t from = 0, uint8_t to = 0xff);
+  static auto AnyLeaf(const Node *node) -> const Leaf *;
+  static auto PrefixMismatch(const InnerNode *node, const std::string &key, size_t depth) -> uint32_t;
+  static void SetPrefix(InnerNode *node, const std::string &key, size_t begin, uint32_t length);
+  static void FreeSubtree(Node *node);
+  static void DeleteNode(Node *node);
+  // the deleter of retired nodes
+  static void DeleteRetired(void *node);
+
+  InnerNode *root_;
+  std::atomic<size_t> size_{0};
+  mutable EpochManager epochs_;
+};
+
+}  // namespace bustub
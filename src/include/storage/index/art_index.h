@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/normalized_key_index.h"
+
+namespace bustub {
+
+/**
+ * Ordered in-memory index over an adaptive radix tree, for tables whose index
+ * comfortably fits in memory. It bypasses the buffer pool, so it is neither
+ * persistent nor logged, and is rebuilt from the table when created.
+ */
+class ARTIndex : public NormalizedKeyIndex {
+ public:
+  explicit ARTIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  /** @return the number of entries in the index */
+  auto Size() const -> size_t { return tree_.Size(); }
+
+  auto GetTree() const -> const AdaptiveRadixTree & { return tree_; }
+
+ protected:
+  void InsertKey(const std::string &key, RID rid) override;
+  void RemoveKey(const std::string &key) override;
+  auto LookupKey(const std::string &key, RID *rid) const -> bool override;
+  void ScanKeys(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                const std::function<void(const std::string &, RID)> &emit) const override;
+
+ private:
+  AdaptiveRadixTree tree_;
+};
+
+}  // namespace bustub
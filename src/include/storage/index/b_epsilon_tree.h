@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree.h
+//
+// Identification: src/include/storage/index/b_epsilon_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "storage/page/b_epsilon_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BEPSILONTREE_TYPE BEpsilonTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Write-optimized variant of BPlusTree for random insert heavy indexes.
+ *
+ * Leaves are regular B+ tree leaf pages. Internal pages (BEpsilonInternalPage)
+ * have a small fanout and spend the rest of their page on a buffer of pending
+ * upserts and deletes. Writes only add a message to the root buffer; a full
+ * buffer is flushed by moving the messages for its fullest child one level
+ * down in a batch, so one leaf write absorbs many inserts. Point queries stop
+ * at the first buffered message for their key on the way down, which is the
+ * newest one.
+ *
+ * (1) Insert is an upsert: a blind insert cannot tell whether the key exists
+ * (2) Pages are split as messages arrive, but never merged; deletes may leave
+ *     leaves underfull or empty
+ * (3) No range scans, the leaves do not see buffered messages
+ * (4) Operations are serialized by a tree latch, readers share it
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BEpsilonTree {
+  using InternalPage = BEpsilonInternalPage<KeyType, ValueType, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using Message = BufferedMessage<KeyType, ValueType>;
+
+ public:
+  // buffer_max_size caps the messages buffered per internal page, 0 fills the page
+  explicit BEpsilonTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                        int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = B_EPSILON_FANOUT,
+                        int buffer_max_size = 0);
+
+  // Returns true if nothing was ever inserted into this tree.
+  auto IsEmpty() const -> bool;
+
+  // Set the value of a key, whether or not it is present.
+  void Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value from this tree.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
+
+  // return the page id of the root node
+  auto GetRootPageId() -> page_id_t;
+
+ private:
+  void UpdateRootPageId(int insert_record = 0);
+  auto FetchTreePage(page_id_t page_id) -> Page *;
+  auto NewTreePage(page_id_t *page_id) -> Page *;
+
+  void Put(const Message &message);
+  void FlushBuffer(InternalPage *node);
+  void ApplyToLeaf(LeafPage *leaf, const Message &message);
+  // split a page that is too full, returns the page id of the new right sibling
+  auto SplitLeaf(LeafPage *leaf, KeyType *separator) -> page_id_t;
+  auto SplitInternal(InternalPage *node, KeyType *separator) -> page_id_t;
+  void GrowRoot(page_id_t old_root_id, const KeyType &separator, page_id_t sibling_id);
+
+  // member variable
+  std::string index_name_;
+  page_id_t root_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+  int buffer_max_size_;
+  // writers hold it exclusively, readers shared
+  ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
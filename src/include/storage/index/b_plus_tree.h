@@ -10,29 +10,67 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <vector>
 
 #include "common/logger.h"
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/index_statistics.h"
+#include "storage/index/swizzle_table.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_var_internal_page.h"
+#include "storage/page/b_plus_tree_var_leaf_page.h"
 
 namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/** The kind of access a descent is performed for, which decides how pages are latched on the way down. */
+enum class Operation { SEARCH, INSERT, DELETE };
+
+/**
+ * How concurrent operations on a tree are synchronized.
+ * LATCH_CRABBING: optimistic crabbing with a pessimistic fallback, pages are merged on underflow.
+ * B_LINK: Lehman-Yao style, every level is linked left to right and bounded by high keys. Readers hold
+ *   at most one latch and no root latch, writers publish the right sibling of a split before updating
+ *   the parent. Pages are never merged or freed, so a page id stays valid for unlatched readers.
+ */
+enum class ConcurrencyMode { LATCH_CRABBING, B_LINK };
+
+/** The leaf a descent ends in: the one covering a key, or the first or the last leaf of the tree. */
+enum class LeafTarget { KEY, LEFTMOST, RIGHTMOST };
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) We only support unique key, indexes that allow duplicate keys make them
+ *     unique by appending the RID (see NonUniqueKey)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
- * (4) Implement index iterator for range scan
+ * (4) Implement index iterator for range scan, in both directions: leaves are
+ *     linked to their left neighbour too
+ * (5) Concurrent access through latch crabbing: every operation first descends
+ *     with read latches and write-latches only the leaf. Writers that find the
+ *     leaf unsafe (it would split or underflow) restart and crab down with
+ *     write latches, releasing ancestors as soon as a child is safe. Latches
+ *     held by a writer are tracked in Transaction::GetPageSet, where a nullptr
+ *     entry stands for root_latch_.
+ * (6) Optionally, internal pages stay pinned in the buffer pool once a
+ *     descent reads them, and descents resolve them through a SwizzleTable
+ *     of frame pointers instead of fetching them. Only read-latched descents
+ *     do; a resident page is unswizzled and unpinned before it is freed.
+ * (7) Deletes rebalance a page once it drops below half full, or below a
+ *     lower fill set with SetMinFill to trade space for fewer page writes.
+ *     Compact rebuilds a tree left sparse by that.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -41,7 +79,10 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     ConcurrencyMode mode = ConcurrencyMode::LATCH_CRABBING);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -52,17 +93,61 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
-  auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
+  // Replace key by new_key in place, keeping its value, if that keeps the tree ordered without touching the
+  // separators, i.e. key is neither the first nor the last entry of its leaf and new_key sorts between its neighbours.
+  auto ReplaceKey(const KeyType &key, const KeyType &new_key) -> bool;
+
+  // return the value associated with a given key, and the leaf the search ended in
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr,
+                page_id_t *leaf_page_id = nullptr) -> bool;
+
+  // copy every entry of the leaf covering key, returns its page id (INVALID_PAGE_ID if the tree is empty)
+  auto GetLeafEntries(const KeyType &key, std::vector<MappingType> *entries) -> page_id_t;
+
+  // Insert entries in key order, which are sorted in place, staying on a leaf while the following keys belong to it.
+  // Returns the number of entries inserted, duplicates of keys already present are skipped.
+  auto InsertBatch(std::vector<MappingType> *entries, Transaction *transaction = nullptr) -> int;
+
+  // Look up keys in key order like InsertBatch, the values of keys[i] are appended to (*results)[i].
+  // Returns the number of keys found.
+  auto GetValueBatch(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                     Transaction *transaction = nullptr) -> int;
 
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
+  // Keep up to max_pages internal pages resident and swizzled, 0 unpins them again.
+  // Must not run concurrently with other operations on this tree.
+  void SetResidentUpperLevels(size_t max_pages);
+
+  // the number of internal pages kept resident
+  auto GetResidentPageCount() -> size_t;
+
+  // Rebalance pages on delete once they are less than min_fill full, 0 only merges pages that become empty.
+  void SetMinFill(double min_fill);
+
+  // Rebuild the tree with its pages packed to fill_factor and free the old ones, returns the pages saved.
+  // Must not run concurrently with other operations on this tree.
+  auto Compact(double fill_factor = 1.0) -> int;
+
+  // Fill in the shape of the tree, its entries and its leaf fill in stats, reading all internal pages but only up
+  // to sample_leaves leaves spread evenly over the tree, whose keys go to sample, one vector per leaf in key order.
+  // Must not run concurrently with writers, which may free pages.
+  void CollectStatistics(size_t sample_leaves, IndexStatistics *stats, std::vector<std::vector<KeyType>> *sample);
+
+  // Build an empty B+ tree bottom-up from entries, which are sorted (and deduplicated) in place.
+  // Nodes are filled to fill_factor of their capacity, but never below half full.
+  auto BulkLoad(std::vector<MappingType> *entries, double fill_factor = 1.0) -> bool;
+
   // index iterator
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
 
+  // index iterator positioned at the last entry, or the last entry not greater than key, to be moved with --
+  auto ReverseBegin() -> INDEXITERATOR_TYPE;
+  auto ReverseBegin(const KeyType &key) -> INDEXITERATOR_TYPE;
+
   // print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -83,15 +168,70 @@ class BPlusTree {
 
   void ToString(BPlusTreePage *page, BufferPoolManager *bpm) const;
 
-  auto FindLeaf(const KeyType &key) -> Page *;
+  // descent with read latches, the leaf is write latched unless operation is SEARCH
+  auto FindLeaf(const KeyType &key, Operation operation, LeafTarget target = LeafTarget::KEY) -> Page *;
+  // descent with write latches, every latch still held is recorded in the transaction's page set
+  auto FindLeafPessimistic(const KeyType &key, Operation operation, Transaction *transaction) -> Page *;
+  auto IsSafe(BPlusTreePage *node, Operation operation) -> bool;
+  void ReleaseLatchFromQueue(Transaction *transaction, bool is_dirty);
+  auto FetchTreePage(page_id_t page_id) -> Page *;
+  auto NewTreePage(page_id_t *page_id) -> Page *;
+  // fetch an internal page a descent passes, resident is set if it came from the swizzle table and is not pinned
+  auto FetchUpperPage(page_id_t page_id, bool *resident) -> Page *;
+  // make a latched internal page resident, taking over its pin
+  auto Swizzle(Page *page) -> bool;
+  void Unswizzle(page_id_t page_id);
+  auto ChildFor(InternalPage *node, const KeyType &key, LeafTarget target) -> page_id_t;
+  void ReleaseLeaf(Page *page, bool exclusive, bool is_dirty);
+  void SetPrevLink(page_id_t page_id, page_id_t prev_page_id);
+
+  // insertion helpers
+  void StartNewTree(const KeyType &key, const ValueType &value);
+  auto InsertIntoLeafPessimistic(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool;
+  void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+                        Transaction *transaction);
+
+  // deletion helpers
+  void RemovePessimistic(const KeyType &key, Transaction *transaction);
+  void CoalesceOrRedistribute(BPlusTreePage *node, Transaction *transaction);
+  void AdjustRoot(BPlusTreePage *old_root_node, Transaction *transaction);
+
+  // free pages no longer linked into the tree, pages still pinned by a reader are kept for a later retry
+  void FreePages(const std::vector<page_id_t> &page_ids);
+  void RetryFreePages();
+
+  auto LeafSeparator(LeafPage *left, LeafPage *right) -> KeyType;
+  // the ids of all pages of the tree, parents before children
+  void CollectPages(std::vector<page_id_t> *page_ids);
+
+  // B-link helpers, path collects the internal pages visited on the way down
+  auto FindLeafBLink(const KeyType &key, Operation operation, std::vector<page_id_t> *path = nullptr,
+                     LeafTarget target = LeafTarget::KEY) -> Page *;
+  auto NeedMoveRight(BPlusTreePage *node, const KeyType &key, LeafTarget target) -> bool;
+  auto MoveRight(Page *page, const KeyType &key, bool exclusive, LeafTarget target = LeafTarget::KEY) -> Page *;
+  auto InsertBLink(const KeyType &key, const ValueType &value) -> bool;
+  void InsertIntoParentBLink(Page *old_page, const KeyType &key, Page *new_page, std::vector<page_id_t> *path);
+  void RecoverPathBLink(page_id_t root_page_id, page_id_t child_id, const KeyType &key, std::vector<page_id_t> *path);
+  void RemoveBLink(const KeyType &key);
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // written under root_latch_, but B-link readers load it without taking the latch
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  ConcurrencyMode mode_;
+  // fill below which deletes rebalance a page
+  double min_fill_{0.5};
+  // protects root_page_id_, taken before the root page itself is latched
+  ReaderWriterLatch root_latch_;
+  // resident internal pages, nullptr unless enabled
+  std::unique_ptr<SwizzleTable> swizzle_table_;
+  // pages unlinked from the tree whose DeletePage failed because they were still pinned
+  std::mutex pending_free_latch_;
+  std::vector<page_id_t> pending_free_pages_;
 };
 
 }  // namespace bustub
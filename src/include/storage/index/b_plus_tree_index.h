@@ -11,12 +11,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
+#include "storage/index/adaptive_hash_index.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
 
@@ -27,6 +32,9 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
+  /** An entry of the tree, as BulkLoad takes them */
+  using EntryType = std::pair<KeyType, ValueType>;
+
   BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
@@ -35,6 +43,41 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids, Transaction *transaction) override;
+
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  void ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive, bool reverse,
+                 std::vector<RID> *result, Transaction *transaction) override;
+
+  void ScanRangeEntries(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                        bool reverse, std::vector<Tuple> *result, Transaction *transaction) override;
+
+  /** The shape of the tree and a histogram over the first key column, from a sample of the leaves */
+  auto CollectStatistics(IndexStatistics *stats, Transaction *transaction) -> bool override;
+
+  /**
+   * @return the key the tree stores for the entry (key, rid), where key holds the entry columns (GetEntrySchema).
+   * It includes rid if the index is not unique.
+   */
+  auto MakeKey(const Tuple &key, RID rid) const -> KeyType;
+
+  /**
+   * Build the still empty index bottom-up from unsorted entries, whose keys come from MakeKey.
+   * @return false if the index is not empty, or if it is unique and entries hold duplicate keys, in which case no
+   * page is allocated
+   */
+  auto BulkLoad(std::vector<EntryType> *entries, double fill_factor) -> bool;
+
+  /**
+   * Turn the adaptive hash index for point lookups on or off, it is off by default. Disabling drops the hash.
+   * @return false if the index does not support it: only unique indexes over generic or integer keys do
+   */
+  auto SetAdaptiveHashIndex(bool enabled) -> bool;
+
+  auto GetAdaptiveHashIndexStats() -> AdaptiveHashIndexStats;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -42,21 +85,64 @@ class BPlusTreeIndex : public Index {
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
  protected:
+  // indexes over NonUniqueComparator allow duplicate keys, their tree orders entries by (key, rid)
+  static constexpr bool IS_UNIQUE = !IsNonUniqueComparator<KeyComparator>::value;
+  // sorts after every valid rid, while the default RID() sorts before them
+  static inline const RID LAST_RID{std::numeric_limits<page_id_t>::max(), std::numeric_limits<uint32_t>::max()};
+
+  // keys hashed on their bytes must be equal exactly when their bytes are
+  static constexpr bool SUPPORTS_ADAPTIVE_HASH =
+      IS_UNIQUE && !IsCoveringComparator<KeyComparator>::value && !std::is_same_v<KeyType, VarKey>;
+
+  // compare the index keys of two entries, leaving out the rid of non-unique indexes
+  auto CompareKeys(const KeyType &lhs, const KeyType &rhs) const -> int;
+
+  // the key to search the tree for, built from a tuple over the key schema alone
+  auto MakeSearchKey(const Tuple &key, RID rid) const -> KeyType;
+
+  // call emit(key, rid) for every entry within the range, in the order of the scan
+  template <typename Emit>
+  void ForEachInRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                      bool reverse, Emit &&emit);
+
   // comparator for key
   KeyComparator comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
+  // answers point lookups on hot leaves while enabled
+  AdaptiveHashIndex<KeyType, ValueType, KeyComparator> adaptive_hash_;
+  std::atomic<bool> adaptive_hash_enabled_{false};
 };
 
-/** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
+/**
+ * We only support index table with one integer key for now in BusTub. Hardcode everything here.
+ *
+ * Catalog::CreateIndex builds a B+ tree over a single INTEGER or BIGINT column with the types below, so executors
+ * cast an index to the alias that matches its column type and IndexMetadata::IsUnique(). A plain CREATE INDEX is not
+ * unique and builds the NonUnique trees, CREATE UNIQUE INDEX the others.
+ */
 
 constexpr static const auto INTEGER_SIZE = 4;
-using IntegerKeyType = GenericKey<INTEGER_SIZE>;
+using IntegerKeyType = IntegerKey<int32_t>;
 using IntegerValueType = RID;
-using IntegerComparatorType = GenericComparator<INTEGER_SIZE>;
+using IntegerComparatorType = IntegerKeyComparator<int32_t>;
 using BPlusTreeIndexForOneIntegerColumn = BPlusTreeIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+using NonUniqueIntegerKeyType = NonUniqueKey<IntegerKeyType>;
+using NonUniqueIntegerComparatorType = NonUniqueComparator<IntegerComparatorType>;
+using NonUniqueBPlusTreeIndexForOneIntegerColumn =
+    BPlusTreeIndex<NonUniqueIntegerKeyType, IntegerValueType, NonUniqueIntegerComparatorType>;
+using NonUniqueBPlusTreeIndexIteratorForOneIntegerColumn =
+    IndexIterator<NonUniqueIntegerKeyType, IntegerValueType, NonUniqueIntegerComparatorType>;
+
+using BPlusTreeIndexForOneBigintColumn = BPlusTreeIndex<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+using BPlusTreeIndexIteratorForOneBigintColumn = IndexIterator<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+using NonUniqueBPlusTreeIndexForOneBigintColumn =
+    BPlusTreeIndex<NonUniqueKey<IntegerKey<int64_t>>, RID, NonUniqueComparator<IntegerKeyComparator<int64_t>>>;
+using NonUniqueBPlusTreeIndexIteratorForOneBigintColumn =
+    IndexIterator<NonUniqueKey<IntegerKey<int64_t>>, RID, NonUniqueComparator<IntegerKeyComparator<int64_t>>>;
+
 }  // namespace bustub
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// covering_comparator.h
+//
+// Identification: src/include/storage/index/covering_comparator.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "storage/index/generic_key.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+/**
+ * Function object for the keys of a covering index, which store the values of
+ * the included columns behind the key columns (see IndexMetadata) so that
+ * queries reading only those need not fetch the tuple. The included columns
+ * are payload: keys compare on their key columns alone, so uniqueness and
+ * lookups ignore them.
+ *
+ * Only GenericKey is supported, the catalog picks one large enough to hold
+ * every entry in full.
+ */
+template <typename KeyComparator>
+class CoveringComparator;
+
+template <size_t KeySize>
+class CoveringComparator<GenericComparator<KeySize>> {
+ public:
+  inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    size_t lhs_size = KeyColumnsSize(lhs);
+    size_t rhs_size = KeyColumnsSize(rhs);
+    // the encoding is prefix free, so equal bytes up to the shorter size mean a truncated key
+    int cmp = memcmp(lhs.data_, rhs.data_, std::min(lhs_size, rhs_size));
+    if (cmp != 0) {
+      return (cmp > 0) - (cmp < 0);
+    }
+    return (lhs_size > rhs_size) - (lhs_size < rhs_size);
+  }
+
+  // key_schema holds the key columns only, without the included ones
+  explicit CoveringComparator(Schema *key_schema)
+      : key_schema_(key_schema), fixed_size_(IsFixedWidth(key_schema) ? PrefixSize(nullptr) : 0) {}
+
+ private:
+  static inline auto IsFixedWidth(const Schema *key_schema) -> bool {
+    const auto &columns = key_schema->GetColumns();
+    return std::none_of(columns.begin(), columns.end(),
+                        [](const Column &column) { return column.GetType() == TypeId::VARCHAR; });
+  }
+
+  // the bytes the key columns take in key, known up front unless they include a varchar
+  inline auto KeyColumnsSize(const GenericKey<KeySize> &key) const -> size_t {
+    return fixed_size_ != 0 ? fixed_size_ : PrefixSize(key.data_);
+  }
+
+  inline auto PrefixSize(const char *data) const -> size_t {
+    return NormalizedKey::PrefixSize(data, KeySize, key_schema_, key_schema_->GetColumnCount());
+  }
+
+  Schema *key_schema_;
+  size_t fixed_size_;
+};
+
+/** Whether an index over KeyComparator stores included columns behind its keys */
+template <typename KeyComparator>
+struct IsCoveringComparator : std::false_type {};
+
+template <typename KeyComparator>
+struct IsCoveringComparator<CoveringComparator<KeyComparator>> : std::true_type {};
+
+}  // namespace bustub
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
+#include <string>
 
+#include "storage/index/normalized_key.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -25,39 +28,50 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * The key columns are stored in their normalized form (see NormalizedKey), so
+ * that two keys order exactly like their bytes do. Unused trailing bytes are
+ * zero. Keys longer than KeySize are truncated, and compare equal if they only
+ * differ past KeySize.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    NormalizedKey::Encode(tuple, key_schema, data_, KeySize);
   }
 
   // NOTE: for test purpose only
+  // encode key as a single BIGINT column
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    NormalizedKey::EncodeInteger(key, data_, KeySize);
   }
 
   inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+    return NormalizedKey::Decode(data_, KeySize, schema, column_idx);
+  }
+
+  /**
+   * Suffix truncation: the shortest key k with left < k <= right, which is right cut off just past the first
+   * byte where it differs from left. Used as a separator so that internal pages need not hold whole keys.
+   */
+  static inline auto ShortestSeparator(const GenericKey &left, const GenericKey &right) -> GenericKey {
+    GenericKey separator;
+    memset(separator.data_, 0, KeySize);
+    size_t length = 0;
+    while (length < KeySize && left.data_[length] == right.data_[length]) {
+      length++;
     }
-    return Value::DeserializeFrom(data_ptr, column_type);
+    memcpy(separator.data_, right.data_, std::min(length + 1, KeySize));
+    return separator;
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline auto ToString() const -> int64_t { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // interpret the first 8 bytes as a BIGINT column
+  inline auto ToString() const -> int64_t { return NormalizedKey::DecodeInteger(data_, KeySize); }
 
   // NOTE: for test purpose only
   // interpret the first 8 bytes as int64_t from data vector
@@ -77,21 +91,17 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
+    // keys are normalized, so compare them as big-endian words and finish off the tail bytewise
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= KeySize; i += sizeof(uint64_t)) {
+      uint64_t lhs_word = LoadBigEndian(lhs.data_ + i);
+      uint64_t rhs_word = LoadBigEndian(rhs.data_ + i);
+      if (lhs_word != rhs_word) {
+        return lhs_word < rhs_word ? -1 : 1;
       }
     }
-    // equals
-    return 0;
+    int cmp = memcmp(lhs.data_ + i, rhs.data_ + i, KeySize - i);
+    return (cmp > 0) - (cmp < 0);
   }
 
   GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
@@ -100,7 +110,17 @@ class GenericComparator {
   explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
 
  private:
-  Schema *key_schema_;
+  static inline auto LoadBigEndian(const char *data) -> uint64_t {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+  }
+
+  // the normalized encoding makes the comparison schema independent
+  [[maybe_unused]] Schema *key_schema_;
 };
 
 }  // namespace bustub
@@ -18,6 +18,8 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
+#include "storage/index/index_statistics.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -43,11 +45,20 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param is_unique Whether two entries may not share a key
+   * @param include_attrs The base table columns stored alongside the key without being part of it (INCLUDE)
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true, std::vector<uint32_t> include_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        is_unique_(is_unique),
+        include_attrs_(std::move(include_attrs)) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    entry_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, entry_attrs_));
   }
 
   ~IndexMetadata() = default;
@@ -72,6 +83,18 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return Whether two entries may not share a key */
+  inline auto IsUnique() const -> bool { return is_unique_; }
+
+  /** @return The base table columns stored alongside the key, empty unless the index is covering */
+  inline auto GetIncludeAttrs() const -> const std::vector<uint32_t> & { return include_attrs_; }
+
+  /** @return The base table columns of an index entry: the key columns followed by the included ones */
+  inline auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return entry_attrs_; }
+
+  /** @return A schema object pointer that represents an index entry, which equals the key schema without INCLUDE */
+  inline auto GetEntrySchema() const -> Schema * { return entry_schema_.get(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -79,6 +102,8 @@ class IndexMetadata {
     os << "IndexMetadata["
        << "Name = " << name_ << ", "
        << "Type = B+Tree, "
+       << "Unique = " << is_unique_ << ", "
+       << "Included columns = " << include_attrs_.size() << ", "
        << "Table name = " << table_name_ << "] :: ";
     os << key_schema_->ToString();
 
@@ -94,6 +119,14 @@ class IndexMetadata {
   const std::vector<uint32_t> key_attrs_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** Whether two entries may not share a key */
+  const bool is_unique_;
+  /** The mapping relation between included columns and base table columns */
+  const std::vector<uint32_t> include_attrs_;
+  /** The key attributes followed by the included ones */
+  std::vector<uint32_t> entry_attrs_;
+  /** The schema of an index entry */
+  std::shared_ptr<Schema> entry_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +172,12 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return The index entry schema, the key schema followed by the included columns */
+  auto GetEntrySchema() const -> Schema * { return metadata_->GetEntrySchema(); }
+
+  /** @return The index entry attributes, see InsertEntry */
+  auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetEntryAttrs(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -153,7 +192,8 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
+   * @param key The index entry, built from the tuple over GetEntrySchema() and GetEntryAttrs(), so that a covering
+   *            index receives the included columns along with the key
    * @param rid The RID associated with the key
    * @param transaction The transaction context
    */
@@ -161,7 +201,7 @@ class Index {
 
   /**
    * Delete an index entry by key.
-   * @param key The index key
+   * @param key The index entry, see InsertEntry
    * @param rid The RID associated with the key (unused)
    * @param transaction The transaction context
    */
@@ -175,6 +215,70 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Insert many entries into the index, as InsertEntry does one by one. Indexes may reorder the entries to share
+   * the work between neighbouring keys.
+   * @param keys The index entries, see InsertEntry
+   * @param rids The RIDs associated with the keys, rids[i] with keys[i]
+   * @param transaction The transaction context
+   */
+  virtual void InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids, Transaction *transaction) {
+    for (size_t i = 0; i < keys.size(); i++) {
+      InsertEntry(keys[i], rids[i], transaction);
+    }
+  }
+
+  /**
+   * Search the index for many keys, as ScanKey does one by one.
+   * @param keys The index keys
+   * @param results The collections of RIDs that are populated with the results, (*results)[i] for keys[i]
+   * @param transaction The transaction context
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
+  /**
+   * Search the index for the keys within a range, in key order. Only ordered indexes support this.
+   * @param low_key The lower bound of the range, or nullptr if it is unbounded below
+   * @param low_inclusive Whether keys equal to low_key are in the range
+   * @param high_key The upper bound of the range, or nullptr if it is unbounded above
+   * @param high_inclusive Whether keys equal to high_key are in the range
+   * @param reverse Whether to return the RIDs in descending key order
+   * @param result The collection of RIDs that is populated with results of the search
+   * @param transaction The transaction context
+   */
+  virtual void ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                         bool reverse, std::vector<RID> *result, Transaction *transaction) {
+    throw NotImplementedException("range scans need an ordered index");
+  }
+
+  /**
+   * Search the index for the keys within a range like ScanRange, but return the index entries themselves: tuples
+   * over GetEntrySchema() with their RID set. Queries that only read the key and included columns can be answered
+   * from these without fetching the tuples from the table.
+   */
+  virtual void ScanRangeEntries(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                                bool reverse, std::vector<Tuple> *result, Transaction *transaction) {
+    throw NotImplementedException("range scans need an ordered index");
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Statistics
+  ///////////////////////////////////////////////////////////////////
+
+  /**
+   * Gather statistics on the size and the key distribution of the index for the optimizer, see IndexStatistics.
+   * @param stats The statistics to fill in, which start out empty
+   * @param transaction The transaction context
+   * @return false if the index does not keep statistics
+   */
+  virtual auto CollectStatistics(IndexStatistics *stats, Transaction *transaction) -> bool { return false; }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
@@ -14,16 +14,39 @@
  */
 #pragma once
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_var_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * The iterator keeps its current leaf pinned and only read latches it while an
+ * entry is copied out or the iterator advances, so a caller may modify the
+ * tree while it holds an iterator. operator++ follows next_page_id_ holding at
+ * most one leaf latch. operator-- follows prev_page_id_ and latches the left
+ * neighbour before letting go of the current leaf, so that a split cannot slip
+ * in between; writers latch leaves left to right, so it only tries to and
+ * backs off on contention. In either direction, entries inserted or removed
+ * next to the current one while iterating may be skipped or seen twice.
+ *
+ * With EnablePrefetch, whenever the iterator enters a leaf the one after it
+ * in the direction of iteration is handed to the buffer pool to read ahead
+ * (see BufferPoolManager::PrefetchPage), so that reading it from disk overlaps
+ * with consuming the current leaf.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
-  // you may define your own constructor based on your member variables
+  // end iterator
   IndexIterator();
+  // takes over the pin on page, positioned at index within that leaf; an index outside of the leaf moves on to
+  // the following leaves, or to the preceding ones if reverse is set
+  IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index, bool reverse = false);
+  IndexIterator(const IndexIterator &) = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -32,12 +55,27 @@ class IndexIterator {
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator--() -> IndexIterator &;
+
+  // prefetch the leaf after the next one entered, in the direction the iterator moves
+  void EnablePrefetch();
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool { return page_ == itr.page_ && index_ == itr.index_; }
+
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  // move on to the following leaves until index_ points at an entry, or reach the end
+  void SkipExhaustedLeaves();
+  // move back to the preceding leaves until index_ points at an entry, or reach the end
+  void SkipExhaustedLeavesBackward();
+  void Prefetch(page_id_t page_id);
+
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  Page *page_{nullptr};
+  int index_{0};
+  MappingType item_;
+  bool prefetch_{false};
 };
 
 }  // namespace bustub
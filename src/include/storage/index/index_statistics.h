@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_statistics.h
+//
+// Identification: src/include/storage/index/index_statistics.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "type/value.h"
+
+namespace bustub {
+
+/** A bucket of an equi-depth histogram, holding the values above the previous bucket up to and including upper_ */
+struct HistogramBucket {
+  Value upper_;
+  // estimated entries in the bucket, and distinct values among them
+  double count_{0};
+  double distinct_{0};
+};
+
+/**
+ * Statistics of an index for the optimizer, gathered by Index::CollectStatistics when ANALYZE runs and kept in the
+ * catalog until the next ANALYZE.
+ *
+ * A B+ tree reads its internal levels in full, which gives the shape of the
+ * tree, but only a sample of evenly spread leaves, from which the entries
+ * and the key distribution are extrapolated. Keys are sorted within a leaf,
+ * so the share of neighbouring entries that differ estimates the number of
+ * distinct keys: a run of r equal keys has one change in r pairs.
+ *
+ * A leaf fill well below the fill factor the index was built with means
+ * that deletes left it sparse, and that compacting it would save pages.
+ */
+struct IndexStatistics {
+  // levels from the root down to the leaves, 0 for an empty index
+  uint32_t height_{0};
+  uint64_t internal_pages_{0};
+  uint64_t leaf_pages_{0};
+  // the share of the leaf capacity in use
+  double leaf_fill_{0};
+  // estimated entries, and distinct keys among them, the RIDs of non-unique indexes left out
+  double entries_{0};
+  double distinct_keys_{0};
+  // equi-depth histogram over the first key column: its smallest value, then the buckets in ascending order
+  Value lowest_;
+  std::vector<HistogramBucket> histogram_;
+
+  // leaves a statistics pass reads at most, and buckets of the histogram
+  static constexpr size_t SAMPLE_LEAVES = 64;
+  static constexpr size_t HISTOGRAM_BUCKETS = 16;
+
+  /** @return the distinct values among entries, given that changes of pairs of neighbouring entries differ */
+  static auto EstimateDistinct(double entries, size_t pairs, size_t changes) -> double;
+
+  /**
+   * Fill the histogram from sampled leaves, each given as the first key column of its entries in key order, with
+   * the leaves in key order too. entries_ must be set already, the bucket counts are scaled to it.
+   */
+  void BuildHistogram(const std::vector<std::vector<Value>> &leaves, size_t num_buckets);
+
+  /** @return the estimated entries whose first key column equals value */
+  auto EstimateEqual(const Value &value) const -> double;
+
+  /** @return the estimated entries whose first key column lies within [low, high], a null bound leaves it open */
+  auto EstimateRange(const Value *low, const Value *high) const -> double;
+
+  auto ToString() const -> std::string;
+};
+
+}  // namespace bustub
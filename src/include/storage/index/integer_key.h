@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// integer_key.h
+//
+// Identification: src/include/storage/index/integer_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Integer key is used for indexing a single INTEGER or BIGINT column.
+ *
+ * It offers the same interface as GenericKey but holds the native integer,
+ * so that a key comparison inside a node is a single compare and nodes fit
+ * more entries than with the padded generic key.
+ */
+template <typename IntType>
+class IntegerKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    key_ = tuple.GetValue(key_schema, 0).GetAs<IntType>();
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) { key_ = static_cast<IntType>(key); }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+    return {schema->GetColumn(column_idx).GetType(), key_};
+  }
+
+  // integers have no shorter form, the separator between two leaves is the right key itself
+  static inline auto ShortestSeparator(__attribute__((unused)) const IntegerKey &left, const IntegerKey &right)
+      -> IntegerKey {
+    return right;
+  }
+
+  // NOTE: for test purpose only
+  inline auto ToString() const -> int64_t { return key_; }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const IntegerKey &key) -> std::ostream & {
+    os << key.ToString();
+    return os;
+  }
+
+  IntType key_;
+};
+
+/**
+ * Function object return is > 0 if lhs > rhs, < 0 if lhs < rhs,
+ * = 0 if lhs = rhs, computed without branches.
+ */
+template <typename IntType>
+class IntegerKeyComparator {
+ public:
+  inline auto operator()(const IntegerKey<IntType> &lhs, const IntegerKey<IntType> &rhs) const -> int {
+    return static_cast<int>(lhs.key_ > rhs.key_) - static_cast<int>(lhs.key_ < rhs.key_);
+  }
+
+  // the key schema is implied by IntType, it is accepted to match GenericComparator
+  explicit IntegerKeyComparator(__attribute__((unused)) Schema *key_schema) {}
+};
+
+}  // namespace bustub
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_index.h
+//
+// Identification: src/include/storage/index/lsm_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "storage/index/lsm_tree.h"
+#include "storage/index/normalized_key_index.h"
+
+namespace bustub {
+
+/**
+ * Ordered index over a log-structured merge tree, for tables that take far
+ * more inserts than lookups. Entries of non-unique indexes are written blindly.
+ * Inserting a key of a unique index that is there already keeps its RID, like
+ * the other index types do, which costs a lookup per insert.
+ */
+class LSMIndex : public NormalizedKeyIndex {
+ public:
+  LSMIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  auto GetTree() -> LSMTree & { return tree_; }
+
+ protected:
+  void InsertKey(const std::string &key, RID rid) override;
+  void RemoveKey(const std::string &key) override;
+  auto LookupKey(const std::string &key, RID *rid) const -> bool override;
+  void ScanKeys(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                const std::function<void(const std::string &, RID)> &emit) const override;
+
+ private:
+  LSMTree tree_;
+};
+
+}  // namespace bustub
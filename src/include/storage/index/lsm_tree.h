@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree.h
+//
+// Identification: src/include/storage/index/lsm_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * Log-structured merge tree from byte string keys to RIDs, for write heavy
+ * indexes like the ones of append-only event tables:
+ *  - writes go to the memtable, a skiplist in memory. Neither updates nor
+ *    deletes look for the key, they add a newer entry, a tombstone for deletes.
+ *  - a full memtable is frozen and written out by a background thread as an
+ *    immutable sorted run: buffer pool pages filled in key order, with the
+ *    first key of every page (fence pointers) and a bloom filter over the keys
+ *    of the run kept in memory.
+ *  - runs are tiered: a level holds up to level_fanout runs, and once it is
+ *    full the background thread merges all of them into one run of the next
+ *    level. A merge keeps the newest entry of every key and drops tombstones
+ *    once nothing older lies beneath them.
+ *  - lookups go from newest to oldest: the memtable, the frozen memtable, then
+ *    the runs level by level, skipping the runs whose key range or bloom
+ *    filter rule the key out and reading a single page of the others. Scans
+ *    merge all of them.
+ *
+ * The memtables and the runs of every level make up a version of the tree,
+ * which is replaced whenever a memtable is frozen or a run is added. Readers
+ * take a reference to the current version and never wait; writers are
+ * serialized and only wait when the memtable fills up before the frozen one is
+ * written out. A run gives its pages back once no version refers to it.
+ *
+ * The runs live in the buffer pool, but the tree is not persistent: nothing
+ * records where they are, and writes are not logged. Keys must fit into a run
+ * page, see LSMRunPage::MAX_KEY_SIZE.
+ */
+class LSMTree {
+ public:
+  explicit LSMTree(BufferPoolManager *buffer_pool_manager, size_t memtable_size = DEFAULT_MEMTABLE_SIZE,
+                   size_t level_fanout = DEFAULT_LEVEL_FANOUT);
+  ~LSMTree();
+
+  LSMTree(const LSMTree &) = delete;
+  auto operator=(const LSMTree &) -> LSMTree & = delete;
+
+  /** Set the value of key, whether or not it is in the tree already */
+  void Put(const std::string &key, RID value);
+
+  /** Set the value of key unless it is in the tree already, @return false then */
+  auto Insert(const std::string &key, RID value) -> bool;
+
+  /** Remove key from the tree, if it is there */
+  void Remove(const std::string &key);
+
+  /** @return whether key is in the tree, its value then goes to value */
+  auto Lookup(const std::string &key, RID *value) const -> bool;
+
+  /**
+   * Call emit with the key and value of every entry within the range, in key order, as of the time the scan
+   * started: writes made while it runs are not seen. A null bound leaves the range open on that side.
+   */
+  void Scan(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+            const std::function<void(const std::string &, RID)> &emit) const;
+
+  /** Write sorted, distinct entries straight into a single run of an empty tree, to build an index */
+  void BulkLoad(const std::vector<std::pair<std::string, RID>> &entries);
+
+  /** Freeze the memtable and wait until the background thread has written it out and finished compacting */
+  void Flush();
+
+  /** The number of runs on every level, for tests and benchmarks */
+  auto GetRunCounts() const -> std::vector<size_t>;
+
+  // bytes of entries a memtable takes before it is frozen
+  static constexpr size_t DEFAULT_MEMTABLE_SIZE = 1 << 20;
+  // runs a level holds before they are merged into the next one
+  static constexpr size_t DEFAULT_LEVEL_FANOUT = 4;
+
+ private:
+  class MemTable;
+  struct Run;
+  class RunBuilder;
+  class Cursor;
+  class MemTableCursor;
+  class RunCursor;
+
+  /** What the tree consists of at one point in time; only the active memtable changes afterwards */
+  struct Version {
+    std::shared_ptr<MemTable> mem_;
+    // frozen and waiting to be written out, nullptr if there is none
+    std::shared_ptr<MemTable> imm_;
+    // the runs of every level, newest first
+    std::vector<std::vector<std::shared_ptr<const Run>>> levels_;
+  };
+
+  auto CurrentVersion() const -> std::shared_ptr<const Version>;
+  void Publish(std::shared_ptr<const Version> version);
+  /** @return false, writing nothing, if if_absent and key is in the tree */
+  auto Write(const std::string &key, bool tombstone, RID value, bool if_absent = false) -> bool;
+  void FreezeMemTable();
+  void BackgroundWork();
+  /** @return the level whose runs are due to be merged, -1 if there is none */
+  auto PickCompaction(const Version &version) const -> int;
+  /** @return the cursors over every part of version as it is now, newest first; they skip later memtable writes */
+  auto MakeCursors(const Version &version) const -> std::vector<std::unique_ptr<Cursor>>;
+  /** @return the run holding the merged entries of cursors, nullptr if there are none */
+  auto WriteRun(const std::vector<std::unique_ptr<Cursor>> &cursors, bool drop_tombstones)
+      -> std::shared_ptr<const Run>;
+
+  /**
+   * Call emit with the newest entry of every key across cursors, which come newest first, in key order, until emit
+   * returns false
+   */
+  static void Merge(const std::vector<std::unique_ptr<Cursor>> &cursors,
+                    const std::function<bool(std::string_view, bool, RID)> &emit);
+
+  BufferPoolManager *buffer_pool_manager_;
+  size_t memtable_size_;
+  size_t level_fanout_;
+  // only accessed through the std::atomic_ functions, and only replaced under latch_
+  std::shared_ptr<const Version> version_;
+  // orders the entries of a key within a memtable
+  uint64_t next_sequence_{0};
+  bool compacting_{false};
+  bool stop_{false};
+  std::mutex latch_;
+  // wakes up the background thread
+  std::condition_variable work_cv_;
+  // signals writers and Flush that the background thread finished a run
+  std::condition_variable done_cv_;
+  std::thread background_thread_;
+};
+
+}  // namespace bustub
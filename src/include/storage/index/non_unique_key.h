@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// non_unique_key.h
+//
+// Identification: src/include/storage/index/non_unique_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <ostream>
+#include <type_traits>
+
+#include "common/rid.h"
+#include "storage/index/var_key.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Key of an index that allows duplicate keys: the index key followed by the
+ * RID of its tuple. Trees stay unique over (key, rid), so equal keys sit next
+ * to each other ordered by RID, a scan for a key walks the leaves from
+ * (key, RID()) on, and a single entry is removed by its full (key, rid).
+ *
+ * SetFromKey leaves the RID at its default, which sorts before every valid
+ * RID, so that the result is a lower bound for all entries with that key.
+ */
+template <typename KeyType>
+class NonUniqueKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    key_.SetFromKey(tuple, key_schema);
+    rid_ = RID();
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    key_.SetFromInteger(key);
+    rid_ = RID();
+  }
+
+  inline void SetRid(const RID &rid) { rid_ = rid; }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value { return key_.ToValue(schema, column_idx); }
+
+  /**
+   * The separator of the keys truncated as KeyType does, and the RID of right to keep it above left when both
+   * keys are equal.
+   */
+  static inline auto ShortestSeparator(const NonUniqueKey &left, const NonUniqueKey &right) -> NonUniqueKey {
+    NonUniqueKey separator;
+    separator.key_ = KeyType::ShortestSeparator(left.key_, right.key_);
+    separator.rid_ = right.rid_;
+    return separator;
+  }
+
+  // NOTE: for test purpose only
+  inline auto ToString() const -> int64_t { return key_.ToString(); }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const NonUniqueKey &key) -> std::ostream & {
+    os << key.ToString();
+    return os;
+  }
+
+  KeyType key_;
+  RID rid_;
+};
+
+/**
+ * Function object ordering NonUniqueKey by key first and RID second.
+ */
+template <typename KeyComparator>
+class NonUniqueComparator {
+ public:
+  template <typename KeyType>
+  inline auto operator()(const NonUniqueKey<KeyType> &lhs, const NonUniqueKey<KeyType> &rhs) const -> int {
+    int cmp = comparator_(lhs.key_, rhs.key_);
+    if (cmp != 0) {
+      return cmp;
+    }
+    int64_t lhs_page = lhs.rid_.GetPageId();
+    int64_t rhs_page = rhs.rid_.GetPageId();
+    if (lhs_page != rhs_page) {
+      return lhs_page < rhs_page ? -1 : 1;
+    }
+    return static_cast<int>(lhs.rid_.GetSlotNum() > rhs.rid_.GetSlotNum()) -
+           static_cast<int>(lhs.rid_.GetSlotNum() < rhs.rid_.GetSlotNum());
+  }
+
+  /** Compare the keys only, ignoring their RIDs */
+  template <typename KeyType>
+  inline auto CompareKey(const NonUniqueKey<KeyType> &lhs, const NonUniqueKey<KeyType> &rhs) const -> int {
+    return comparator_(lhs.key_, rhs.key_);
+  }
+
+  explicit NonUniqueComparator(Schema *key_schema) : comparator_(key_schema) {}
+
+ private:
+  KeyComparator comparator_;
+};
+
+/**
+ * Variable length keys carry their RID as trailing bytes (see VarKey::SetRid)
+ * and stay VarKey, so that non-unique indexes keep the slotted pages. The
+ * normalized key encoding is prefix free, so comparing the bytes orders
+ * entries by key first and RID second.
+ */
+template <>
+class NonUniqueComparator<VarKeyComparator> {
+ public:
+  inline auto operator()(const VarKey &lhs, const VarKey &rhs) const -> int { return comparator_(lhs, rhs); }
+
+  /** Compare the keys only, ignoring their RIDs */
+  inline auto CompareKey(const VarKey &lhs, const VarKey &rhs) const -> int {
+    int cmp = CompareVarKeyBytes(lhs.data_, lhs.size_ - VarKey::RID_SIZE, rhs.data_, rhs.size_ - VarKey::RID_SIZE);
+    return (cmp > 0) - (cmp < 0);
+  }
+
+  explicit NonUniqueComparator(Schema *key_schema) : comparator_(key_schema) {}
+
+ private:
+  VarKeyComparator comparator_;
+};
+
+/** Whether an index over KeyComparator allows duplicate keys */
+template <typename KeyComparator>
+struct IsNonUniqueComparator : std::false_type {};
+
+template <typename KeyComparator>
+struct IsNonUniqueComparator<NonUniqueComparator<KeyComparator>> : std::true_type {};
+
+}  // namespace bustub
@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key.h
+//
+// Identification: src/include/storage/index/normalized_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Encoding of index key columns into a byte string that orders exactly like
+ * the keys do, shared by the fixed size GenericKey and the variable length
+ * VarKey:
+ *  - integers are big-endian with the sign bit flipped, which also sorts the
+ *    NULL sentinel (the minimum value) first
+ *  - decimals are big-endian IEEE 754 bits, all of them flipped when negative
+ *    and only the sign bit otherwise
+ *  - varchars are a non-null flag byte followed by the characters and a zero
+ *    terminator, a NULL varchar is a single zero byte
+ * Every function works on a buffer of the given capacity: what does not fit is
+ * dropped when encoding and read as zero bytes when decoding.
+ */
+class NormalizedKey {
+ public:
+  /** Encode the columns of a key tuple into data, return the number of bytes written. */
+  static inline auto Encode(const Tuple &tuple, const Schema *key_schema, char *data, size_t capacity) -> size_t {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount() && offset < capacity; i++) {
+      offset = EncodeValue(tuple.GetValue(key_schema, i), data, capacity, offset);
+    }
+    return std::min(offset, capacity);
+  }
+
+  /** Encode key as a single BIGINT column, return the number of bytes written. */
+  static inline auto EncodeInteger(int64_t key, char *data, size_t capacity) -> size_t {
+    return std::min(EncodeUnsigned(static_cast<uint64_t>(key) ^ INT64_SIGN_BIT, sizeof(int64_t), data, capacity, 0),
+                    capacity);
+  }
+
+  /** Decode the column column_idx of schema. */
+  static inline auto Decode(const char *data, size_t capacity, const Schema *schema, uint32_t column_idx) -> Value {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < column_idx; i++) {
+      DecodeValue(schema->GetColumn(i).GetType(), data, capacity, &offset);
+    }
+    return DecodeValue(schema->GetColumn(column_idx).GetType(), data, capacity, &offset);
+  }
+
+  /** Decode every column of schema, in order. */
+  static inline auto DecodeColumns(const char *data, size_t capacity, const Schema *schema) -> std::vector<Value> {
+    std::vector<Value> values;
+    values.reserve(schema->GetColumnCount());
+    size_t offset = 0;
+    for (const auto &column : schema->GetColumns()) {
+      values.push_back(DecodeValue(column.GetType(), data, capacity, &offset));
+    }
+    return values;
+  }
+
+  /** The number of bytes the first column_count columns of schema take in the encoded key data. */
+  static inline auto PrefixSize(const char *data, size_t capacity, const Schema *schema, uint32_t column_count)
+      -> size_t {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < column_count && offset < capacity; i++) {
+      if (schema->GetColumn(i).GetType() != TypeId::VARCHAR) {
+        offset += FixedWidth(schema->GetColumn(i).GetType());
+        continue;
+      }
+      // a NULL varchar is its zero flag byte alone, otherwise the characters run up to the terminator
+      if (data[offset++] != 0) {
+        while (offset < capacity && data[offset] != '\0') {
+          offset++;
+        }
+        offset++;
+      }
+    }
+    return std::min(offset, capacity);
+  }
+
+  /** The size of the encoding of the longest key schema can hold, varchars at their declared length. */
+  static inline auto MaxEncodedSize(const Schema *schema) -> size_t {
+    size_t size = 0;
+    for (const auto &column : schema->GetColumns()) {
+      // flag byte and terminator around the characters
+      size += column.GetType() == TypeId::VARCHAR ? column.GetLength() + 2 : FixedWidth(column.GetType());
+    }
+    return size;
+  }
+
+  /** Interpret the first 8 bytes as a BIGINT column. */
+  static inline auto DecodeInteger(const char *data, size_t capacity) -> int64_t {
+    size_t offset = 0;
+    return static_cast<int64_t>(DecodeUnsigned(sizeof(int64_t), data, capacity, &offset) ^ INT64_SIGN_BIT);
+  }
+
+ private:
+  static constexpr uint64_t INT64_SIGN_BIT = 1ULL << 63;
+
+  /** The encoded size of a column of a fixed width type. */
+  static inline auto FixedWidth(TypeId type) -> size_t {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return sizeof(int8_t);
+      case TypeId::SMALLINT:
+        return sizeof(int16_t);
+      case TypeId::INTEGER:
+        return sizeof(int32_t);
+      case TypeId::BIGINT:
+      case TypeId::TIMESTAMP:
+      case TypeId::DECIMAL:
+        return sizeof(uint64_t);
+      default:
+        throw Exception(ExceptionType::INCOMPATIBLE_TYPE, "unsupported index key column type");
+    }
+  }
+
+  /** Append the normalized form of value at offset, return the offset past it. */
+  static inline auto EncodeValue(const Value &value, char *data, size_t capacity, size_t offset) -> size_t {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return EncodeUnsigned(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, sizeof(int8_t), data, capacity,
+                              offset);
+      case TypeId::SMALLINT:
+        return EncodeUnsigned(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, sizeof(int16_t), data,
+                              capacity, offset);
+      case TypeId::INTEGER:
+        return EncodeUnsigned(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, sizeof(int32_t), data,
+                              capacity, offset);
+      case TypeId::BIGINT:
+        return EncodeUnsigned(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ INT64_SIGN_BIT, sizeof(int64_t), data,
+                              capacity, offset);
+      case TypeId::TIMESTAMP:
+        return EncodeUnsigned(value.GetAs<uint64_t>(), sizeof(uint64_t), data, capacity, offset);
+      case TypeId::DECIMAL: {
+        auto decimal = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &decimal, sizeof(bits));
+        bits = (bits & INT64_SIGN_BIT) != 0 ? ~bits : bits | INT64_SIGN_BIT;
+        return EncodeUnsigned(bits, sizeof(uint64_t), data, capacity, offset);
+      }
+      case TypeId::VARCHAR: {
+        if (value.IsNull()) {
+          return EncodeUnsigned(0, 1, data, capacity, offset);
+        }
+        offset = EncodeUnsigned(1, 1, data, capacity, offset);
+        const char *str = value.GetData();
+        // the stored length counts the terminating '\0'
+        for (uint32_t i = 0; i + 1 < value.GetLength() && str[i] != '\0' && offset < capacity; i++) {
+          data[offset++] = str[i];
+        }
+        return EncodeUnsigned(0, 1, data, capacity, offset);
+      }
+      default:
+        throw Exception(ExceptionType::INCOMPATIBLE_TYPE, "unsupported index key column type");
+    }
+  }
+
+  /** Decode the column of the given type at *offset and advance *offset past it. */
+  static inline auto DecodeValue(TypeId type, const char *data, size_t capacity, size_t *offset) -> Value {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return {type, static_cast<int8_t>(DecodeUnsigned(sizeof(int8_t), data, capacity, offset) ^ 0x80U)};
+      case TypeId::SMALLINT:
+        return {type, static_cast<int16_t>(DecodeUnsigned(sizeof(int16_t), data, capacity, offset) ^ 0x8000U)};
+      case TypeId::INTEGER:
+        return {type, static_cast<int32_t>(DecodeUnsigned(sizeof(int32_t), data, capacity, offset) ^ 0x80000000U)};
+      case TypeId::BIGINT:
+        return {type, static_cast<int64_t>(DecodeUnsigned(sizeof(int64_t), data, capacity, offset) ^ INT64_SIGN_BIT)};
+      case TypeId::TIMESTAMP:
+        return {type, static_cast<uint64_t>(DecodeUnsigned(sizeof(uint64_t), data, capacity, offset))};
+      case TypeId::DECIMAL: {
+        uint64_t bits = DecodeUnsigned(sizeof(uint64_t), data, capacity, offset);
+        bits = (bits & INT64_SIGN_BIT) != 0 ? bits & ~INT64_SIGN_BIT : ~bits;
+        double decimal;
+        memcpy(&decimal, &bits, sizeof(decimal));
+        return {type, decimal};
+      }
+      case TypeId::VARCHAR: {
+        if (DecodeUnsigned(1, data, capacity, offset) == 0) {
+          return {type, nullptr, 0, false};
+        }
+        size_t begin = *offset;
+        while (*offset < capacity && data[*offset] != '\0') {
+          ++*offset;
+        }
+        std::string str(data + begin, *offset - begin);
+        ++*offset;
+        return {type, str};
+      }
+      default:
+        throw Exception(ExceptionType::INCOMPATIBLE_TYPE, "unsupported index key column type");
+    }
+  }
+
+  /** Write the low width bytes of bits most significant first, dropping what does not fit. */
+  static inline auto EncodeUnsigned(uint64_t bits, size_t width, char *data, size_t capacity, size_t offset)
+      -> size_t {
+    for (size_t i = 0; i < width; i++, offset++) {
+      if (offset < capacity) {
+        data[offset] = static_cast<char>(bits >> (8 * (width - 1 - i)));
+      }
+    }
+    return offset;
+  }
+
+  static inline auto DecodeUnsigned(size_t width, const char *data, size_t capacity, size_t *offset) -> uint64_t {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < width; i++, ++*offset) {
+      bits = (bits << 8) | (*offset < capacity ? static_cast<uint8_t>(data[*offset]) : 0U);
+    }
+    return bits;
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key_index.h
+//
+// Identification: src/include/storage/index/normalized_key_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+/**
+ * Index over an ordered map from byte string keys to RIDs, which subclasses
+ * provide. Keys are stored in their NormalizedKey encoding, which orders
+ * bytewise like the keys do and is prefix free. Non-unique indexes append the
+ * RID to every key, big-endian, so that equal keys become a contiguous run of
+ * distinct entries. Included columns are not supported.
+ */
+class NormalizedKeyIndex : public Index {
+ public:
+  explicit NormalizedKeyIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  void ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive, bool reverse,
+                 std::vector<RID> *result, Transaction *transaction) override;
+
+  void ScanRangeEntries(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                        bool reverse, std::vector<Tuple> *result, Transaction *transaction) override;
+
+  /** @return the key stored for the entry (key, rid), which includes rid if the index is not unique */
+  auto MakeKey(const Tuple &key, RID rid) const -> std::string;
+
+ protected:
+  // the ordered map underneath
+  virtual void InsertKey(const std::string &key, RID rid) = 0;
+  virtual void RemoveKey(const std::string &key) = 0;
+  virtual auto LookupKey(const std::string &key, RID *rid) const -> bool = 0;
+  virtual void ScanKeys(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                        const std::function<void(const std::string &, RID)> &emit) const = 0;
+
+ private:
+  /** @return the encoded key columns */
+  auto EncodeKey(const Tuple &key) const -> std::string;
+
+  void ForEachInRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                      const std::function<void(const std::string &, RID)> &emit) const;
+
+  // appended to an encoded key, it sorts after every entry with that key
+  static const std::string PAST_ALL_RIDS;
+
+  size_t key_capacity_;
+  bool is_unique_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skiplist_index.h
+//
+// Identification: src/include/storage/index/skiplist_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "container/skiplist/lock_free_skiplist.h"
+#include "storage/index/normalized_key_index.h"
+
+namespace bustub {
+
+/**
+ * Ordered in-memory index over a lock-free skiplist, for tables with many
+ * concurrent writers. Like ARTIndex it bypasses the buffer pool, so it is
+ * neither persistent nor logged, and is rebuilt from the table when created.
+ */
+class SkipListIndex : public NormalizedKeyIndex {
+ public:
+  explicit SkipListIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  /** @return the number of entries in the index */
+  auto Size() const -> size_t { return list_.Size(); }
+
+  auto GetList() const -> const LockFreeSkipList<std::string, RID> & { return list_; }
+
+ protected:
+  void InsertKey(const std::string &key, RID rid) override;
+  void RemoveKey(const std::string &key) override;
+  auto LookupKey(const std::string &key, RID *rid) const -> bool override;
+  void ScanKeys(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                const std::function<void(const std::string &, RID)> &emit) const override;
+
+ private:
+  LockFreeSkipList<std::string, RID> list_;
+};
+
+}  // namespace bustub
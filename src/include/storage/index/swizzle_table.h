@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// swizzle_table.h
+//
+// Identification: src/include/storage/index/swizzle_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * Swizzled page ids of the B+ tree pages an index keeps resident: a direct
+ * mapped array from page id to the frame holding the page, which stays pinned
+ * for as long as it is in the table. A descent resolves child page ids here
+ * first and only goes through the buffer pool page table, replacer and pin
+ * count for pages that are not resident.
+ *
+ * Page ids are allocated densely, so the array is split into chunks that are
+ * allocated on first use. Get never blocks; Insert and Erase are serialized.
+ * Page ids beyond the capacity of the table are never resident.
+ */
+class SwizzleTable {
+ public:
+  explicit SwizzleTable(size_t max_pages) : max_pages_(max_pages) {}
+
+  ~SwizzleTable() {
+    for (auto &chunk : chunks_) {
+      delete[] chunk.load();
+    }
+  }
+
+  /** @return the frame holding page_id, or nullptr if it is not resident */
+  auto Get(page_id_t page_id) const -> Page * {
+    if (page_id < 0 || static_cast<size_t>(page_id) >= MAX_CHUNKS * CHUNK_SIZE) {
+      return nullptr;
+    }
+    std::atomic<Page *> *chunk = chunks_[page_id / CHUNK_SIZE].load(std::memory_order_acquire);
+    return chunk == nullptr ? nullptr : chunk[page_id % CHUNK_SIZE].load(std::memory_order_acquire);
+  }
+
+  /**
+   * Make a pinned page resident, the table takes over the caller's pin.
+   * @return false if the table is full or the page is resident already, the caller keeps its pin then
+   */
+  auto Insert(Page *page) -> bool {
+    page_id_t page_id = page->GetPageId();
+    if (page_id < 0 || static_cast<size_t>(page_id) >= MAX_CHUNKS * CHUNK_SIZE) {
+      return false;
+    }
+    std::scoped_lock lock(latch_);
+    if (size_ >= max_pages_) {
+      return false;
+    }
+    std::atomic<Page *> *chunk = chunks_[page_id / CHUNK_SIZE].load();
+    if (chunk == nullptr) {
+      chunk = new std::atomic<Page *>[CHUNK_SIZE]();
+      chunks_[page_id / CHUNK_SIZE].store(chunk, std::memory_order_release);
+    }
+    if (chunk[page_id % CHUNK_SIZE].load() != nullptr) {
+      return false;
+    }
+    chunk[page_id % CHUNK_SIZE].store(page, std::memory_order_release);
+    size_++;
+    return true;
+  }
+
+  /** @return whether page_id was resident, its pin then goes back to the caller */
+  auto Erase(page_id_t page_id) -> bool {
+    if (page_id < 0 || static_cast<size_t>(page_id) >= MAX_CHUNKS * CHUNK_SIZE) {
+      return false;
+    }
+    std::scoped_lock lock(latch_);
+    std::atomic<Page *> *chunk = chunks_[page_id / CHUNK_SIZE].load();
+    if (chunk == nullptr || chunk[page_id % CHUNK_SIZE].load() == nullptr) {
+      return false;
+    }
+    chunk[page_id % CHUNK_SIZE].store(nullptr);
+    size_--;
+    return true;
+  }
+
+  /** Call f with the page id of every resident page */
+  template <typename F>
+  void ForEach(F &&f) const {
+    std::scoped_lock lock(latch_);
+    for (size_t i = 0; i < MAX_CHUNKS; i++) {
+      std::atomic<Page *> *chunk = chunks_[i].load();
+      for (size_t j = 0; chunk != nullptr && j < CHUNK_SIZE; j++) {
+        if (chunk[j].load() != nullptr) {
+          f(static_cast<page_id_t>(i * CHUNK_SIZE + j));
+        }
+      }
+    }
+  }
+
+  auto Size() const -> size_t {
+    std::scoped_lock lock(latch_);
+    return size_;
+  }
+
+ private:
+  static constexpr size_t CHUNK_SIZE = 4096;
+  static constexpr size_t MAX_CHUNKS = 4096;
+
+  std::array<std::atomic<std::atomic<Page *> *>, MAX_CHUNKS> chunks_{};
+  mutable std::mutex latch_;
+  size_t size_{0};
+  size_t max_pages_;
+};
+
+}  // namespace bustub
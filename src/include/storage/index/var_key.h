@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// var_key.h
+//
+// Identification: src/include/storage/index/var_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/index/normalized_key.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Longest key a VarKey holds, longer keys are truncated like GenericKey truncates at its KeySize. Indexes only use
+ * VarKey for key schemas that fit, see VarKey::Fits.
+ */
+static constexpr size_t VARKEY_MAX_SIZE = 256;
+
+/**
+ * Variable length key, used for key schemas with VARCHAR columns.
+ *
+ * It holds the same normalized form as GenericKey (see NormalizedKey) but
+ * only as many bytes as the key needs, and keys order like their bytes
+ * compared lexicographically. The B+ tree stores it in slotted pages, which
+ * copy just size_ bytes of every key, so that short strings and truncated
+ * separators take little space in a node.
+ */
+class VarKey {
+ public:
+  /**
+   * @return whether every key of key_schema encodes into a VarKey in full, followed by the RID if with_rid (see
+   * SetRid), so that distinct keys stay distinct
+   */
+  static inline auto Fits(const Schema *key_schema, bool with_rid = false) -> bool {
+    return NormalizedKey::MaxEncodedSize(key_schema) + (with_rid ? RID_SIZE : 0) <= VARKEY_MAX_SIZE;
+  }
+
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    size_ = static_cast<uint16_t>(NormalizedKey::Encode(tuple, key_schema, data_, VARKEY_MAX_SIZE));
+  }
+
+  // NOTE: for test purpose only
+  // encode key as a single BIGINT column
+  inline void SetFromInteger(int64_t key) {
+    size_ = static_cast<uint16_t>(NormalizedKey::EncodeInteger(key, data_, VARKEY_MAX_SIZE));
+  }
+
+  /**
+   * Append the RID of the entry, for indexes that allow duplicate keys (see NonUniqueComparator). The page id
+   * is stored with its sign bit flipped and both parts big-endian, so that the default RID sorts first. The
+   * key schema must leave room for it, see Fits.
+   */
+  inline void SetRid(const RID &rid) {
+    BUSTUB_ASSERT(size_ + RID_SIZE <= VARKEY_MAX_SIZE, "no room for the rid behind the key");
+    auto page_id = static_cast<uint32_t>(rid.GetPageId()) ^ 0x80000000U;
+    uint32_t slot_num = rid.GetSlotNum();
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+      data_[size_ + i] = static_cast<char>(page_id >> (8 * (sizeof(uint32_t) - 1 - i)));
+      data_[size_ + sizeof(uint32_t) + i] = static_cast<char>(slot_num >> (8 * (sizeof(uint32_t) - 1 - i)));
+    }
+    size_ += RID_SIZE;
+  }
+
+  inline void SetFromBytes(const char *data, size_t size) {
+    size_ = static_cast<uint16_t>(size);
+    memcpy(data_, data, size);
+  }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+    return NormalizedKey::Decode(data_, size_, schema, column_idx);
+  }
+
+  /**
+   * Suffix truncation: the shortest key k with left < k <= right, which is right cut off just past the first
+   * byte where it differs from left.
+   */
+  static inline auto ShortestSeparator(const VarKey &left, const VarKey &right) -> VarKey {
+    size_t length = 0;
+    size_t common = std::min(left.size_, right.size_);
+    while (length < common && left.data_[length] == right.data_[length]) {
+      length++;
+    }
+    VarKey separator;
+    separator.SetFromBytes(right.data_, std::min<size_t>(length + 1, right.size_));
+    return separator;
+  }
+
+  // NOTE: for test purpose only
+  // interpret the first 8 bytes as a BIGINT column
+  inline auto ToString() const -> int64_t { return NormalizedKey::DecodeInteger(data_, size_); }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const VarKey &key) -> std::ostream & {
+    os << key.ToString();
+    return os;
+  }
+
+  // bytes SetRid appends
+  static constexpr size_t RID_SIZE = sizeof(page_id_t) + sizeof(uint32_t);
+
+  uint16_t size_{0};
+  char data_[VARKEY_MAX_SIZE];
+};
+
+/**
+ * Lexicographic comparison of raw normalized key bytes, a proper prefix sorts first.
+ * @return < 0, 0 or > 0 like memcmp
+ */
+inline auto CompareVarKeyBytes(const char *lhs, size_t lhs_size, const char *rhs, size_t rhs_size) -> int {
+  int cmp = memcmp(lhs, rhs, std::min(lhs_size, rhs_size));
+  if (cmp != 0) {
+    return cmp;
+  }
+  return static_cast<int>(lhs_size > rhs_size) - static_cast<int>(lhs_size < rhs_size);
+}
+
+/**
+ * Function object return is > 0 if lhs > rhs, < 0 if lhs < rhs,
+ * = 0 if lhs = rhs.
+ */
+class VarKeyComparator {
+ public:
+  inline auto operator()(const VarKey &lhs, const VarKey &rhs) const -> int {
+    int cmp = CompareVarKeyBytes(lhs.data_, lhs.size_, rhs.data_, rhs.size_);
+    return (cmp > 0) - (cmp < 0);
+  }
+
+  // the normalized encoding makes the comparison schema independent, it is accepted to match GenericComparator
+  explicit VarKeyComparator(__attribute__((unused)) Schema *key_schema) {}
+};
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_internal_page.h
+//
+// Identification: src/include/storage/page/b_epsilon_internal_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_internal_page.h"
+
+namespace bustub {
+
+#define B_EPSILON_INTERNAL_PAGE_TYPE BEpsilonInternalPage<KeyType, ValueType, KeyComparator>
+// pivots of a B-epsilon internal page, the buffer takes the rest of the page
+#define B_EPSILON_FANOUT 16
+
+/** What a buffered message does to its key once it reaches a leaf. */
+enum class MessageType : int32_t { UPSERT, DELETE };
+
+template <typename KeyType, typename ValueType>
+struct BufferedMessage {
+  KeyType key_;
+  ValueType value_;
+  MessageType type_;
+};
+
+/**
+ * Internal page of a B-epsilon tree: a B+ tree internal page with a small
+ * fanout, whose remaining space buffers insert and delete messages on their
+ * way down to the leaves. The buffer sits at the end of the page, behind room
+ * for max_size + 1 pivots, and is kept sorted by key with at most one message
+ * per key: a newer message for a key replaces the older one.
+ *
+ * Buffer format, ending at the end of the page:
+ *  -------------------------------------------------------------------------
+ * | MESSAGE(0) | MESSAGE(1) | ... | MESSAGE(max - 1) | Size (4) | MaxSize (4) |
+ *  -------------------------------------------------------------------------
+ *
+ * Messages bound for one child are adjacent, since the pivots split the key
+ * space into ranges.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BEpsilonInternalPage : public BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> {
+  using Message = BufferedMessage<KeyType, ValueType>;
+
+ public:
+  // buffer_max_size is capped by the space left behind the pivots, 0 takes all of it
+  void Init(page_id_t page_id, int max_size = B_EPSILON_FANOUT, int buffer_max_size = 0);
+
+  auto GetBufferSize() const -> int;
+  auto GetBufferMaxSize() const -> int;
+  auto IsBufferFull() const -> bool;
+  auto MessageAt(int index) const -> const Message &;
+
+  // the buffered message for key, nullptr if there is none
+  auto FindMessage(const KeyType &key, const KeyComparator &comparator) const -> const Message *;
+  void PutMessage(const Message &message, const KeyComparator &comparator);
+
+  // the child with the most buffered messages, and the removal of the messages bound for a child
+  auto FullestChild(const KeyComparator &comparator) const -> int;
+  void TakeMessages(int child_index, const KeyComparator &comparator, std::vector<Message> *messages);
+
+  // split, the upper half of the pivots and their messages move to recipient
+  auto MoveHalfTo(BEpsilonInternalPage *recipient, const KeyComparator &comparator) -> KeyType;
+
+ private:
+  auto Messages() -> Message *;
+  auto Messages() const -> const Message *;
+  auto SizeField() const -> int32_t *;
+  auto MessageIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+  // messages [begin, end) are bound for child_index
+  auto ChildMessageRange(int child_index, const KeyComparator &comparator) const -> std::pair<int, int>;
+};
+
+}  // namespace bustub
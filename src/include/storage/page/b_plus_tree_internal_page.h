@@ -18,9 +18,9 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24  //内部页头部占用空间
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
-/**                                   (4096 - 24)/ (一对数据的大小) = 一个目录页的总记录数
+#define INTERNAL_PAGE_HEADER_SIZE 28  //内部页头部占用空间(不含 high key)
+#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - sizeof(KeyType)) / (sizeof(MappingType)))
+/**                                   (4096 - 28 - high key)/ (一对数据的大小) = 一个目录页的总记录数
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
  * K(i) <= K < K(i+1).
@@ -32,6 +32,10 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * Like leaves, internal pages link to their right sibling on the same level
+ * (NextPageId) and carry a HighKey that bounds every key below this page.
+ * HighKey is only meaningful while NextPageId is valid.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -39,13 +43,53 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   // must call initialize method after "create" a new node
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
 
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetHighKey() const -> KeyType;
+  void SetHighKey(const KeyType &high_key);
+
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
+  auto CanSetKeyAt(int index, const KeyType &key) const -> bool;
   auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+  auto ValueIndex(const ValueType &value) const -> int;
 
   auto Lookup(const KeyType &key, const KeyComparator &comparator_) const -> ValueType;
 
+  // insertion
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  void Append(const KeyType &key, const ValueType &value);
+  auto InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value) -> int;
+
+  // deletion
+  void Remove(int index);
+  auto RemoveAndReturnOnlyChild() -> ValueType;
+
+  // split, merge and redistribute, children moved to the recipient are re-parented through the buffer pool
+  void InsertAndMoveHalfTo(BPlusTreeInternalPage *recipient, const ValueType &old_value, const KeyType &new_key,
+                           const ValueType &new_value, BufferPoolManager *buffer_pool_manager);
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
+
+  // occupancy, the tree decides on splits, merges and bulk load packing through these
+  auto IsFull() const -> bool;
+  auto IsInsertSafe() const -> bool;
+  auto IsDeleteSafe(double min_fill = 0.5) const -> bool;
+  auto IsUnderflow(double min_fill = 0.5) const -> bool;
+  auto CanAbsorb(const BPlusTreeInternalPage *sibling, const KeyType &middle_key) const -> bool;
+  auto ReachedFillFactor(double fill_factor) const -> bool;
+
  private:
+  void CopyNFrom(const MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
+  void AdoptChild(const ValueType &child, BufferPoolManager *buffer_pool_manager);
+
+  page_id_t next_page_id_;
+  KeyType high_key_;
+
   // Flexible array member for page data.
   MappingType array_[1];
 };
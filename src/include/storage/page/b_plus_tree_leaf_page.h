@@ -18,8 +18,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 32
+#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - sizeof(KeyType)) / sizeof(MappingType))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
@@ -31,13 +31,19 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 32 bytes + key size in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ---------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrevPageId (4) | HighKey (key size)
+ *  ---------------------------------------------------------------------------------
+ *
+ * HighKey is the first key of the right sibling (an upper bound for every key
+ * in this page) and is only meaningful while NextPageId is valid; the
+ * rightmost leaf has an infinite high key. PrevPageId links the leaves
+ * backwards for reverse scans; it is only changed while holding the latches
+ * of both this page and its left neighbour.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -48,12 +54,48 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+  auto GetHighKey() const -> KeyType;
+  void SetHighKey(const KeyType &high_key);
+  void SetLowKey(const KeyType &low_key);
   auto KeyAt(int index) const -> KeyType;
+  void SetKeyAt(int index, const KeyType &key);
+  auto CanSetKeyAt(int index, const KeyType &key) const -> bool;
+  auto ValueAt(int index) const -> ValueType;
+  auto GetItem(int index) -> const MappingType &;
   auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) -> bool;
   auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
 
+  // insertion, returns the size after insertion
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> int;
+
+  // deletion, returns the size after deletion
+  auto RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int;
+
+  // split, merge and redistribute
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+  // occupancy, the tree decides on splits, merges and bulk load packing through these
+  auto IsFull() const -> bool;
+  auto IsInsertSafe() const -> bool;
+  auto IsDeleteSafe(double min_fill = 0.5) const -> bool;
+  auto IsUnderflow(double min_fill = 0.5) const -> bool;
+  auto CanAbsorb(const BPlusTreeLeafPage *sibling) const -> bool;
+  auto CanBorrowFrom(const BPlusTreeLeafPage *sibling) const -> bool;
+  auto ReachedFillFactor(double fill_factor) const -> bool;
+  // the share of the page in use, for statistics
+  auto Fill() const -> double;
+
  private:
+  void CopyNFrom(const MappingType *items, int size);
+
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[1];
 };
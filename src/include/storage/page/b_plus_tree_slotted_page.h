@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_slotted_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "storage/index/var_key.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * Slotted layout shared by the leaf and internal pages of trees over VarKey.
+ * Keys have different lengths, so the page holds an array of fixed size slots
+ * in key order, each pointing at the key bytes in a heap that grows from the
+ * end of the page towards the slots:
+ *  ----------------------------------------------------------------------------
+ * | HEADER | SLOT(1) | SLOT(2) | ... | SLOT(n) | free space | ... KEY(2) KEY(1) |
+ *  ----------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 300 bytes in total):
+ *  --------------------------------------------------------------------------------------------
+ * | BPlusTreePage header (24) | NextPageId (4) | PrevPageId (4) | HeapBegin (2) | KeyBytes (2) |
+ *  --------------------------------------------------------------------------------------------
+ * | PrefixSize (2) | LowKeyOffset (2) | LowKeySize (2) | HighKey (258) |
+ *  ---------------------------------------------------------------------------
+ *  Slot format: | KeyOffset (2) | KeySize (2) | Value |
+ *
+ * PrevPageId and the low key are only maintained for leaves.
+ *
+ * Leaves store their keys prefix compressed. Every key routed to a leaf lies
+ * between its low key (the separator to its left neighbour, kept in the heap)
+ * and its high key, so it starts with the common prefix of the two fences.
+ * That prefix is kept once, as the first PrefixSize bytes of the high key, and
+ * the slots hold only what follows it. Narrowing the fences at a split drops
+ * bytes off the front of the stored keys in place; widening them at a merge or
+ * redistribution writes the bytes back, which the caller makes room for.
+ *
+ * Removing a key leaves its bytes behind in the heap, they are reclaimed by
+ * compacting the heap once a new key does not fit in the contiguous free
+ * space. KeyBytes counts the live key bytes only.
+ *
+ * Fill is measured in bytes instead of entries: a page is full once the
+ * largest possible entry may no longer fit, and underflows when less than half
+ * of it is in use. The max size in the header is only informational.
+ */
+template <typename ValueType>
+class BPlusTreeSlottedPage : public BPlusTreePage {
+ public:
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+  auto GetHighKey() const -> VarKey;
+  void SetHighKey(const VarKey &high_key);
+  // leaves only, the empty key (the default) sorts before every key
+  auto GetLowKey() const -> VarKey;
+  void SetLowKey(const VarKey &low_key);
+
+  auto KeyAt(int index) const -> VarKey;
+  void SetKeyAt(int index, const VarKey &key);
+  auto CanSetKeyAt(int index, const VarKey &key) const -> bool;
+  auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+
+  auto IsFull() const -> bool;
+  auto IsDeleteSafe(double min_fill = 0.5) const -> bool;
+  auto IsUnderflow(double min_fill = 0.5) const -> bool;
+
+ protected:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t size_;
+    ValueType value_;
+  };
+
+  // an entry with the longest possible key
+  static constexpr int MAX_ENTRY_SIZE = static_cast<int>(sizeof(Slot) + VARKEY_MAX_SIZE);
+
+  void InitSlotted(page_id_t page_id, page_id_t parent_id, IndexPageType page_type);
+
+  // first index in [begin, size) whose key is not less than key
+  auto LowerBound(int begin, const VarKey &key) const -> int;
+  auto CompareKeyAt(int index, const VarKey &key) const -> int;
+
+  void InsertAt(int index, const VarKey &key, const ValueType &value);
+  void RemoveAt(int index);
+  // drop every entry from index on
+  void Truncate(int index);
+
+  // bytes in use, header included
+  auto UsedBytes() const -> int;
+  auto FreeBytes() const -> int;
+  // bytes the entries [begin, size) take, slots included
+  auto EntryBytes(int begin) const -> int;
+  // stored bytes, without the prefix
+  auto KeySizeAt(int index) const -> int;
+  auto PrefixSize() const -> int;
+  // the prefix every key of a leaf with these fences shares, none for the rightmost leaf
+  static auto FencePrefixSize(const VarKey &low_key, const VarKey &high_key) -> int;
+
+ private:
+  auto SlotsEnd() const -> int;
+  // < 0, 0 or > 0 as the stored keys are less than, share the prefix of or are greater than key
+  auto ComparePrefix(const VarKey &key) const -> int;
+  auto CompareSuffixAt(int index, const char *suffix, size_t suffix_size) const -> int;
+  auto AllocateKey(const char *data, int size) -> uint16_t;
+  // strip or restore key bytes so that the stored keys go without prefix_size bytes of old_prefix
+  void Reencode(const VarKey &old_prefix, int prefix_size);
+  void Compact(const char *prefix = nullptr, int prefix_size = 0);
+
+  page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  uint16_t heap_begin_;
+  uint16_t key_bytes_;
+  uint16_t prefix_size_;
+  uint16_t low_key_offset_;
+  uint16_t low_key_size_;
+  VarKey high_key_;
+  // Flexible array member for page data.
+  Slot slots_[1];
+};
+
+}  // namespace bustub
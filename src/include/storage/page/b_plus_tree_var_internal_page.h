@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_var_internal_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_var_internal_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/**
+ * Internal page of a tree over variable length keys, stored in the slotted
+ * layout of BPlusTreeSlottedPage. Separators are posted truncated (see
+ * VarKey::ShortestSeparator), so they take only the bytes needed to tell two
+ * children apart and the fan-out grows as keys share longer prefixes. Like in
+ * the fixed size internal page, the first key is not used for searching.
+ */
+template <typename KeyComparator>
+class BPlusTreeInternalPage<VarKey, page_id_t, KeyComparator> : public BPlusTreeSlottedPage<page_id_t> {
+ public:
+  // max_size is ignored, the capacity of a slotted page depends on its keys
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = 0);
+
+  auto ValueIndex(const page_id_t &value) const -> int;
+  auto Lookup(const VarKey &key, const KeyComparator &comparator) const -> page_id_t;
+
+  // insertion
+  void PopulateNewRoot(const page_id_t &old_value, const VarKey &new_key, const page_id_t &new_value);
+  void Append(const VarKey &key, const page_id_t &value);
+  auto InsertNodeAfter(const page_id_t &old_value, const VarKey &new_key, const page_id_t &new_value) -> int;
+
+  // deletion
+  void Remove(int index);
+  auto RemoveAndReturnOnlyChild() -> page_id_t;
+
+  // split, merge and redistribute, children moved to the recipient are re-parented through the buffer pool
+  void InsertAndMoveHalfTo(BPlusTreeInternalPage *recipient, const page_id_t &old_value, const VarKey &new_key,
+                           const page_id_t &new_value, BufferPoolManager *buffer_pool_manager);
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const VarKey &middle_key, BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const VarKey &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const VarKey &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
+
+  // occupancy, see BPlusTreeSlottedPage for IsFull, IsDeleteSafe and IsUnderflow
+  auto IsInsertSafe() const -> bool;
+  auto CanAbsorb(const BPlusTreeInternalPage *sibling, const VarKey &middle_key) const -> bool;
+  auto ReachedFillFactor(double fill_factor) const -> bool;
+
+ private:
+  void AdoptChild(page_id_t child, BufferPoolManager *buffer_pool_manager);
+};
+
+}  // namespace bustub
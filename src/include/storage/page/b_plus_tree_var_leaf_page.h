@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_var_leaf_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_var_leaf_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/**
+ * Leaf page of a tree over variable length keys, stored in the slotted layout
+ * of BPlusTreeSlottedPage. It offers the interface of the fixed size leaf page
+ * that the tree relies on, but splits at half of its bytes rather than half of
+ * its entries and judges its occupancy in bytes. Keys are stored without the
+ * prefix that the fence keys of the page share (see BPlusTreeSlottedPage).
+ *
+ * Keys are compared on their bytes, so KeyComparator only tells unique trees
+ * (VarKeyComparator) from trees whose keys carry their RID
+ * (NonUniqueComparator<VarKeyComparator>).
+ */
+template <typename KeyComparator>
+class BPlusTreeLeafPage<VarKey, RID, KeyComparator> : public BPlusTreeSlottedPage<RID> {
+ public:
+  // max_size is ignored, the capacity of a slotted page depends on its keys
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = 0);
+  auto GetItem(int index) -> std::pair<VarKey, RID>;
+  auto Lookup(const VarKey &key, RID *value, const KeyComparator &comparator) -> bool;
+  auto KeyIndex(const VarKey &key, const KeyComparator &comparator) const -> int;
+
+  // insertion, returns the size after insertion
+  auto Insert(const VarKey &key, const RID &value, const KeyComparator &comparator) -> int;
+
+  // deletion, returns the size after deletion
+  auto RemoveAndDeleteRecord(const VarKey &key, const KeyComparator &comparator) -> int;
+
+  // split, merge and redistribute
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+  // occupancy, see BPlusTreeSlottedPage for IsFull, IsDeleteSafe and IsUnderflow
+  auto IsInsertSafe() const -> bool;
+  auto CanAbsorb(const BPlusTreeLeafPage *sibling) const -> bool;
+  auto CanBorrowFrom(const BPlusTreeLeafPage *sibling) const -> bool;
+  auto ReachedFillFactor(double fill_factor) const -> bool;
+  // the share of the page in use, for statistics
+  auto Fill() const -> double;
+
+ private:
+  // append the entries [begin, size) of this page to recipient
+  void CopyTo(BPlusTreeLeafPage *recipient, int begin) const;
+};
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_run_page.h
+//
+// Identification: src/include/storage/page/lsm_run_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * Page of a sorted run of an LSMTree. A run is written once, in key order, and
+ * never modified afterwards, so entries are only ever appended: the slots grow
+ * from the header towards the end of the page, the entries they point at from
+ * the end of the page towards the slots.
+ *  -----------------------------------------------------------------------------
+ * | Size (4) | HeapBegin (4) | SLOT(0) | ... | SLOT(n-1) | free | ENTRY(n-1) | ... | ENTRY(0) |
+ *  -----------------------------------------------------------------------------
+ *  Slot format: | EntryOffset (2) |
+ *  Entry format: | RID (8) | KeySize (2) | Tombstone (1) | Key |
+ */
+class LSMRunPage {
+ public:
+  void Init();
+
+  auto GetSize() const -> int;
+
+  /** Append an entry, whose key must not be less than the last one. @return false if it does not fit */
+  auto Append(std::string_view key, bool tombstone, RID value) -> bool;
+
+  auto KeyAt(int index) const -> std::string_view;
+  auto ValueAt(int index) const -> RID;
+  auto IsTombstoneAt(int index) const -> bool;
+
+  /** @return the first index whose key is not less than key, GetSize() if there is none */
+  auto LowerBound(std::string_view key) const -> int;
+
+  static constexpr size_t ENTRY_HEADER_SIZE = sizeof(RID) + sizeof(uint16_t) + 1;
+  // a key that fits into an empty page along with its slot and entry header
+  static constexpr size_t MAX_KEY_SIZE =
+      BUSTUB_PAGE_SIZE - 2 * sizeof(uint32_t) - sizeof(uint16_t) - ENTRY_HEADER_SIZE;
+
+ private:
+  auto EntryAt(int index) const -> const char *;
+
+  uint32_t size_;
+  uint32_t heap_begin_;
+  // Flexible array member for page data.
+  uint16_t slots_[1];
+};
+
+}  // namespace bustub
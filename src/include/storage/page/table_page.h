@@ -123,6 +123,15 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * Point a tuple at its bytes within this page instead of copying them out. The view stays valid only as long as
+   * the page data does not change, copying the tuple materializes it.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the view of the tuple
+   * @return true if the tuple exists
+   */
+  auto GetTupleView(const RID &rid, Tuple *tuple) -> bool;
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -138,6 +147,12 @@ class TablePage : public Page {
    */
   auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
 
+  /** @return the size of the largest tuple that InsertTuple still accepts */
+  auto GetInsertableSpace() -> uint32_t {
+    auto remaining = GetFreeSpaceRemaining();
+    return remaining > SIZE_TUPLE ? remaining - SIZE_TUPLE : 0;
+  }
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
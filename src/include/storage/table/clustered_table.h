@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clustered_table.h
+//
+// Identification: src/include/storage/table/clustered_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/var_key.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Index-organized table: rows are stored in full in the leaves of a B+ tree
+ * ordered by primary key, instead of in a TableHeap behind an index of RIDs.
+ * A primary key lookup reads a single root to leaf path and a range scan reads
+ * consecutive leaves, where a heap table adds a page fetch for every row.
+ *
+ * A row is kept like a covering index keeps its entries: as a VarKey holding
+ * the NormalizedKey encoding of the primary key columns followed by the other
+ * columns. The encoding is prefix free, so rows order by primary key, and a
+ * row is found by seeking to the encoded primary key alone, which sorts just
+ * before it. Rows therefore take at most VARKEY_MAX_SIZE encoded bytes, see
+ * Fits, and have no RIDs.
+ *
+ * Readers go through the latch crabbing of the tree. Writers are serialized,
+ * so that checking the primary key and modifying the tree happen atomically.
+ * An update replaces the row in its leaf, unless it is the first or last row
+ * of the leaf or outgrows the room left there. Then it deletes and reinserts
+ * the row, and a concurrent reader may miss the row in between.
+ */
+class ClusteredTable {
+  using TreeType = BPlusTree<VarKey, RID, VarKeyComparator>;
+  using TreeIterator = IndexIterator<VarKey, RID, VarKeyComparator>;
+
+ public:
+  /** Iterator over the rows in primary key order, walking the leaves of the tree */
+  class Iterator {
+   public:
+    auto IsEnd() -> bool { return iter_.IsEnd(); }
+
+    auto operator*() -> const Tuple & { return tuple_; }
+
+    auto operator++() -> Iterator &;
+
+   private:
+    friend class ClusteredTable;
+    Iterator(const ClusteredTable *table, TreeIterator &&iter);
+    void Decode();
+
+    const ClusteredTable *table_;
+    TreeIterator iter_;
+    Tuple tuple_;
+  };
+
+  /**
+   * @param name the name of the table, which the tree is registered under in the header page
+   * @param schema the schema of the rows
+   * @param key_attrs the primary key columns, in key order
+   */
+  ClusteredTable(const std::string &name, BufferPoolManager *buffer_pool_manager, const Schema &schema,
+                 std::vector<uint32_t> key_attrs);
+
+  /** @return whether the rows of schema are guaranteed to fit into a tree entry */
+  static auto Fits(const Schema &schema) -> bool;
+
+  /** @return false if a row with the same primary key exists already */
+  auto InsertTuple(const Tuple &tuple, Transaction *txn) -> bool;
+
+  /** Replace the row with the primary key of tuple, @return false if there is none */
+  auto UpdateTuple(const Tuple &tuple, Transaction *txn) -> bool;
+
+  /** Delete the row with primary key key, a tuple of the key schema, @return false if there is none */
+  auto DeleteTuple(const Tuple &key, Transaction *txn) -> bool;
+
+  /** @return whether there is a row with primary key key, which then goes to result */
+  auto GetTuple(const Tuple &key, Tuple *result, Transaction *txn) -> bool;
+
+  /** @return an iterator at the first row */
+  auto Begin() -> Iterator;
+
+  /** @return an iterator at the first row whose primary key is not less than key */
+  auto Begin(const Tuple &key) -> Iterator;
+
+  /** Append the rows whose primary key lies within the range to result, a null bound leaves the range open */
+  void ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                 std::vector<Tuple> *result, Transaction *txn);
+
+  auto GetSchema() const -> const Schema & { return schema_; }
+
+  auto GetKeySchema() const -> const Schema & { return key_schema_; }
+
+  auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
+
+ private:
+  auto EncodeKey(const Tuple &key) const -> VarKey;
+  auto EncodeRow(const Tuple &tuple) const -> VarKey;
+  auto DecodeRow(const VarKey &row) const -> Tuple;
+  /** @return whether row holds the primary key key */
+  static auto HasKey(const VarKey &row, const VarKey &key) -> bool;
+  /** @return whether there is a row with primary key key, which then goes to row */
+  auto FindRow(const VarKey &key, VarKey *row) -> bool;
+
+  Schema schema_;
+  Schema key_schema_;
+  std::vector<uint32_t> key_attrs_;
+  // the columns in the order they are stored: the primary key, then the others
+  Schema row_schema_;
+  std::vector<uint32_t> row_attrs_;
+  TreeType tree_;
+  std::mutex write_latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks how much room the pages of a TableHeap have left, so
+ * that an insert goes straight to a page that takes its tuple instead of
+ * walking the page chain from the first page.
+ *
+ * Pages are bucketed by their free space into NUM_CATEGORIES categories of
+ * CATEGORY_SIZE bytes each. A request looks only at the categories whose
+ * every page is large enough, smallest first, so that partly filled pages
+ * fill up before empty ones are touched, and takes the page most recently
+ * put into that category. Both lookups and updates take constant time.
+ *
+ * The map is a hint kept next to the pages: the table heap updates it under
+ * the page latch after every change to a page, but an insert still checks
+ * the page it gets, since the map rounds free space down to categories. It
+ * is not persisted, the page headers hold the free space already, and
+ * TableHeap rebuilds it in a single pass over the chain when a table is
+ * opened.
+ *
+ * Inserts claim pages: a claimed page leaves its category until it is
+ * released, so that concurrent inserters each fill a page of their own
+ * instead of all latching the one page with the most fitting space.
+ */
+class FreeSpaceMap {
+ public:
+  static constexpr size_t NUM_CATEGORIES = 32;
+  static constexpr uint32_t CATEGORY_SIZE = BUSTUB_PAGE_SIZE / NUM_CATEGORIES;
+  /** A size to claim that only pages with about all of their room left can take */
+  static constexpr uint32_t EMPTY_PAGE = CATEGORY_SIZE * (NUM_CATEGORIES - 1);
+
+  /** Record that page_id has room for a tuple of free_space bytes, adding the page if it is new */
+  void Update(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Take a page out of the map for the caller to insert into, until it releases the page again.
+   * @param size the size of the tuple to insert
+   * @param[out] page_id a page with room for size bytes, as of its last update
+   * @return true if there is such a page
+   */
+  auto Claim(uint32_t size, page_id_t *page_id) -> bool;
+
+  /** Add a page that is claimed right away, such as one the caller has just appended */
+  void AddClaimed(page_id_t page_id);
+
+  /** Give a claimed page back, with room for a tuple of free_space bytes */
+  void Release(page_id_t page_id, uint32_t free_space);
+
+  /** @return the number of pages tracked */
+  auto GetPageCount() -> size_t;
+
+ private:
+  static auto CategoryOf(uint32_t free_space) -> size_t {
+    return std::min<size_t>(free_space / CATEGORY_SIZE, NUM_CATEGORIES - 1);
+  }
+
+  /** Where a page is: its category, and its position in the pages of that category unless it is claimed */
+  struct Slot {
+    size_t category_;
+    size_t index_;
+    bool claimed_;
+  };
+
+  /** Put a page into a category, or only remember the category while it is claimed */
+  void Link(page_id_t page_id, Slot *slot, size_t category);
+  /** Take a page out of its category */
+  void Unlink(const Slot &slot);
+
+  std::mutex latch_;
+  std::array<std::vector<page_id_t>, NUM_CATEGORIES> categories_;
+  std::unordered_map<page_id_t, Slot> slots_;
+};
+
+}  // namespace bustub
@@ -12,9 +12,15 @@
 
 #pragma once
 
+#include <array>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -23,6 +29,15 @@ namespace bustub {
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Inserts find a page with room through a FreeSpaceMap rather than by walking
+ * the list, and only append a page to the end of it when no page has room.
+ * Each thread inserts through one of several lanes, which claims a page from
+ * the map and keeps filling it until it is full, so that concurrent inserts
+ * latch different pages instead of all waiting for the same one. The lanes
+ * give their pages back to the map when a transaction that inserted into the
+ * table ends (see ReleaseInsertPages), so that the room left on them is not
+ * withheld from other inserters for good.
  */
 class TableHeap {
   friend class TableIterator;
@@ -51,7 +66,8 @@ class TableHeap {
             Transaction *txn);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table, into any page with room for it. If the tuple is too large (>= page_size), return
+   * false.
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
@@ -59,6 +75,16 @@ class TableHeap {
    */
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
 
+  /**
+   * Insert many tuples at once, latching each page only once for all the tuples that go to it. A batch larger than a
+   * page fills empty or freshly appended pages rather than the gaps left in existing ones.
+   * @param tuples tuples to insert
+   * @param[out] rids the rids of the inserted tuples, in the order of tuples
+   * @param txn the transaction performing the insert
+   * @return true iff all tuples were inserted, otherwise rids holds those that were
+   */
+  auto InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool;
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -99,6 +125,23 @@ class TableHeap {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
+  /**
+   * Scan the whole table with several threads, each owning a contiguous run of pages.
+   * @param num_workers number of scanning threads
+   * @param callback invoked as callback(worker, tuple) for every live tuple, concurrently across workers, with a
+   * view into the latched page that the callback has to copy to keep
+   * @param txn transaction performing the scan, aborted if a page cannot be fetched
+   * @return false if a page could not be fetched, in which case only part of the table was scanned
+   */
+  auto ParallelScan(size_t num_workers, const std::function<void(size_t, const Tuple &)> &callback, Transaction *txn)
+      -> bool;
+
+  /**
+   * Give the pages that idle insert lanes hold back to the free space map, with the room they have left. Lanes that
+   * are inserting right now keep theirs. Called when a transaction that inserted into the table commits or aborts.
+   */
+  void ReleaseInsertPages();
+
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
 
@@ -113,6 +156,27 @@ class TableHeap {
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+
+  /** Number of pages that concurrent inserts fill side by side */
+  static constexpr size_t INSERT_LANES = 16;
+
+  /** The page that inserts from the threads assigned to a lane go to, claimed from the free space map */
+  struct alignas(64) InsertLane {
+    std::mutex latch_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** Append an empty page to the end of the table, claimed by the caller. @return its id, or INVALID_PAGE_ID */
+  auto AppendPage(Transaction *txn) -> page_id_t;
+
+  /** Add rids[begin, end) to the write set, a run of consecutive slots as one record */
+  void RecordInserts(const std::vector<RID> &rids, size_t begin, size_t end, Transaction *txn);
+
+  FreeSpaceMap free_space_map_;
+  std::array<InsertLane, INSERT_LANES> insert_lanes_;
+  /** Serializes appending pages, and protects last_page_id_ */
+  std::mutex append_latch_;
+  page_id_t last_page_id_{};
 };
 
 }  // namespace bustub
@@ -13,9 +13,11 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
 #include "common/rid.h"
 #include "concurrency/transaction.h"
+#include "storage/page/table_page.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -24,21 +26,32 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * The iterator reads a page at a time: it pins and read-latches a page once,
+ * copies it into a buffer of its own, and releases it again, so that moving
+ * to the next tuple on the page touches neither the buffer pool nor a latch.
+ * The tuple it yields is a view into that buffer, valid until the iterator
+ * moves on; copying the tuple materializes it when the caller needs to keep
+ * it. Holding the page latch between calls instead would deadlock callers
+ * that write to the table they scan, and pins alone do not keep a page from
+ * being compacted.
  */
 class TableIterator {
   friend class Cursor;
+  friend class TableHeap;
 
  public:
   TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
 
+  /** A copy materializes the tuple, and reads the page again once it moves on */
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_), tuple_(other.tuple_), txn_(other.txn_) {}
 
-  ~TableIterator() { delete tuple_; }
+  TableIterator(TableIterator &&other) noexcept;
 
-  inline auto operator==(const TableIterator &itr) const -> bool {
-    return tuple_->rid_.Get() == itr.tuple_->rid_.Get();
-  }
+  ~TableIterator() = default;
+
+  inline auto operator==(const TableIterator &itr) const -> bool { return tuple_.rid_.Get() == itr.tuple_.rid_.Get(); }
 
   inline auto operator!=(const TableIterator &itr) const -> bool { return !(*this == itr); }
 
@@ -52,15 +65,24 @@ class TableIterator {
 
   auto operator=(const TableIterator &other) -> TableIterator & {
     table_heap_ = other.table_heap_;
-    *tuple_ = *other.tuple_;
+    tuple_ = other.tuple_;
     txn_ = other.txn_;
+    page_.reset();
     return *this;
   }
 
  private:
+  /** Move to the first tuple of the first page from page_id on that has one, or to the end */
+  void Seek(page_id_t page_id);
+
+  /** Copy page page_id into page_ */
+  void ReadPage(page_id_t page_id);
+
   TableHeap *table_heap_;
-  Tuple *tuple_;
+  Tuple tuple_;
   Transaction *txn_;
+  /** The copy of the page the tuple views, allocated once and reused for every page */
+  std::unique_ptr<TablePage> page_;
 };
 
 }  // namespace bustub
@@ -42,10 +42,10 @@ class Tuple {
   // constructor for creating a new tuple based on input value
   Tuple(std::vector<Value> values, const Schema *schema);
 
-  // copy constructor, deep copy
+  // copy constructor, deep copy, also of a tuple that views a page
   Tuple(const Tuple &other);
 
-  // assign operator, deep copy
+  // assign operator, deep copy, also of a tuple that views a page
   auto operator=(const Tuple &other) -> Tuple &;
 
   ~Tuple() {
@@ -64,6 +64,9 @@ class Tuple {
   // return RID of current tuple
   inline auto GetRid() const -> RID { return rid_; }
 
+  // set RID of current tuple, for tuples that stand for a table tuple without living in the table heap
+  inline void SetRid(RID rid) { rid_ = rid; }
+
   // Get the address of this tuple in the table's backing store
   inline auto GetData() const -> char * { return data_; }
 
@@ -75,7 +78,8 @@ class Tuple {
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
   // Generates a key tuple given schemas and attributes
-  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
+      -> Tuple;
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
@@ -1,4 +1,5 @@
 #include "optimizer/optimizer.h"
+#include <cmath>
 #include <optional>
 #include "common/util/string_util.h"
 #include "execution/plans/abstract_plan.h"
@@ -21,6 +22,12 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
 }
 
 auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
+  // every row has an entry in every index of its table
+  for (const auto *index_info : catalog_.GetTableIndexes(table_name)) {
+    if (index_info->stats_.has_value()) {
+      return std::make_optional(static_cast<size_t>(std::llround(index_info->stats_->entries_)));
+    }
+  }
   if (StringUtil::EndsWith(table_name, "_1m")) {
     return std::make_optional(1000000);
   }
@@ -1,8 +1,9 @@
+#include "primer/cow_trie.h"
 #include "primer/p0_trie.h"
 
 // This is a placeholder file for clang-tidy check.
 //
-// With this file, we can fire run_clang_tidy.py to check `p0_trie.h`,
+// With this file, we can fire run_clang_tidy.py to check `p0_trie.h` and `cow_trie.h`,
 // as it will filter out all header files and won't check header-only code.
 //
 // This file is not part of the submission. All of the modifications should
@@ -0,0 +1,911 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.cpp
+//
+// Identification: src/storage/index/adaptive_radix_tree.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/adaptive_radix_tree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>  // NOLINT
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bustub {
+
+/*
+ * Node layouts. Key bytes, counts and prefixes are plain fields that readers
+ * may see torn, they only trust what they read once the version of the node
+ * validates. Children are atomics, so that a reader that loads a pointer sees
+ * the node it points to fully initialized.
+ */
+struct AdaptiveRadixTree::Leaf : public Node {
+  Leaf(std::string key, RID value) : Node(NodeType::LEAF), key_(std::move(key)), value_(value) {}
+  const std::string key_;
+  const RID value_;
+};
+
+struct AdaptiveRadixTree::InnerNode : public Node {
+  explicit InnerNode(NodeType type) : Node(type) {}
+  // bit 0 marks the node obsolete, bit 1 locked, the bits above count the writes
+  std::atomic<uint64_t> version_{0};
+  uint16_t count_{0};
+  // the length of the compressed path, of which the first MAX_PREFIX bytes are stored
+  uint32_t prefix_len_{0};
+  uint8_t prefix_[MAX_PREFIX]{};
+};
+
+struct AdaptiveRadixTree::Node4 : public InnerNode {
+  Node4() : InnerNode(NodeType::NODE4) {}
+  uint8_t keys_[4]{};
+  std::atomic<Node *> children_[4]{};
+};
+
+struct AdaptiveRadixTree::Node16 : public InnerNode {
+  Node16() : InnerNode(NodeType::NODE16) {}
+  alignas(16) uint8_t keys_[16]{};
+  std::atomic<Node *> children_[16]{};
+};
+
+struct AdaptiveRadixTree::Node48 : public InnerNode {
+  static constexpr uint8_t EMPTY = 48;
+  Node48() : InnerNode(NodeType::NODE48) { std::memset(child_index_, EMPTY, sizeof(child_index_)); }
+  uint8_t child_index_[256];
+  std::atomic<Node *> children_[48]{};
+};
+
+struct AdaptiveRadixTree::Node256 : public InnerNode {
+  Node256() : InnerNode(NodeType::NODE256) {}
+  std::atomic<Node *> children_[256]{};
+};
+
+/* The range of a scan, and the last key it reported for resuming after a restart */
+struct AdaptiveRadixTree::ScanState {
+  const std::string *low_;
+  bool low_inclusive_;
+  const std::string *high_;
+  bool high_inclusive_;
+  const std::function<void(const std::string &, RID)> *emit_;
+  bool emitted_{false};
+  std::string last_;
+  std::string resume_;
+};
+
+namespace {
+
+inline auto KeyByte(const std::string &key, size_t depth) -> uint8_t { return static_cast<uint8_t>(key[depth]); }
+
+}  // namespace
+
+/*
+ * The root is a Node256 without a prefix that is never replaced, so every
+ * other node has a parent to be swapped out of.
+ */
+AdaptiveRadixTree::AdaptiveRadixTree() : root_(new Node256()) {}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() { FreeSubtree(root_); }
+
+auto AdaptiveRadixTree::Insert(const std::string &key, RID value) -> bool {
+  EpochGuard guard(&epochs_);
+  bool inserted = false;
+  while (!InsertOptimistic(key, value, &inserted)) {
+  }
+  return inserted;
+}
+
+auto AdaptiveRadixTree::Remove(const std::string &key) -> bool {
+  EpochGuard guard(&epochs_);
+  bool removed = false;
+  while (!RemoveOptimistic(key, &removed)) {
+  }
+  return removed;
+}
+
+auto AdaptiveRadixTree::Lookup(const std::string &key, RID *value) const -> bool {
+  EpochGuard guard(&epochs_);
+  bool found = false;
+  while (!LookupOptimistic(key, value, &found)) {
+  }
+  return found;
+}
+
+/*
+ * A scan that has to restart resumes behind the last key it reported, so
+ * nothing is reported twice.
+ */
+void AdaptiveRadixTree::Scan(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                             const std::function<void(const std::string &, RID)> &emit) const {
+  EpochGuard guard(&epochs_);
+  ScanState state{low, low_inclusive, high, high_inclusive, &emit, false, {}, {}};
+  std::string path;
+  while (true) {
+    path.clear();
+    if (ScanNode(root_, &path, state.low_ == nullptr, state.high_ == nullptr, &state) != ScanStatus::RESTART) {
+      return;
+    }
+    if (state.emitted_) {
+      state.resume_ = state.last_;
+      state.low_ = &state.resume_;
+      state.low_inclusive_ = false;
+    }
+  }
+}
+
+auto AdaptiveRadixTree::GetNodeCounts() const -> std::array<size_t, 4> {
+  EpochGuard guard(&epochs_);
+  std::array<size_t, 4> counts{};
+  std::vector<const Node *> stack{root_};
+  std::vector<std::pair<uint8_t, Node *>> children;
+  while (!stack.empty()) {
+    const Node *node = stack.back();
+    stack.pop_back();
+    if (node->type_ == NodeType::LEAF) {
+      continue;
+    }
+    counts[static_cast<size_t>(node->type_) - static_cast<size_t>(NodeType::NODE4)]++;
+    children.clear();
+    ChildrenInOrder(static_cast<const InnerNode *>(node), &children);
+    for (const auto &[byte, child] : children) {
+      stack.push_back(child);
+    }
+  }
+  return counts;
+}
+
+/*
+ * Descend to the node the key belongs in, verifying every prefix byte on the
+ * way, and change at most the last inner node and its parent:
+ *  - a prefix that diverges from the key is split by a new Node4 in the parent
+ *  - a missing child is added, growing a full node into the next layout
+ *  - a leaf holding a different key is pushed down into a new Node4 together
+ *    with the new leaf, under the prefix both keys share
+ * @return false if the descent has to restart
+ */
+auto AdaptiveRadixTree::InsertOptimistic(const std::string &key, RID value, bool *inserted) -> bool {
+  InnerNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  InnerNode *node = root_;
+  uint64_t version;
+  if (!ReadLock(node, &version)) {
+    return false;
+  }
+  size_t depth = 0;
+  while (true) {
+    uint32_t prefix_len = node->prefix_len_;
+    if (prefix_len > 0) {
+      uint32_t mismatch = PrefixMismatch(node, key, depth);
+      if (!Validate(node, version)) {
+        return false;
+      }
+      if (mismatch < prefix_len) {
+        if (depth + mismatch >= key.size()) {
+          // the key is a prefix of the keys below
+          *inserted = false;
+          return true;
+        }
+        if (!Upgrade(parent, parent_version)) {
+          return false;
+        }
+        if (!Upgrade(node, version)) {
+          WriteUnlock(parent);
+          return false;
+        }
+        const Leaf *below = AnyLeaf(node);
+        auto *split = new Node4();
+        SetPrefix(split, key, depth, mismatch);
+        AddChild(split, KeyByte(below->key_, depth + mismatch), node);
+        AddChild(split, KeyByte(key, depth + mismatch), new Leaf(key, value));
+        SetPrefix(node, below->key_, depth + mismatch + 1, prefix_len - mismatch - 1);
+        ReplaceChild(parent, parent_byte, split);
+        WriteUnlock(node);
+        WriteUnlock(parent);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        *inserted = true;
+        return true;
+      }
+      depth += prefix_len;
+    }
+    if (depth >= key.size()) {
+      *inserted = false;
+      return Validate(node, version);
+    }
+
+    uint8_t byte = KeyByte(key, depth);
+    Node *child = FindChild(node, byte);
+    if (!Validate(node, version)) {
+      return false;
+    }
+
+    if (child == nullptr) {
+      if (IsFull(node)) {
+        if (!Upgrade(parent, parent_version)) {
+          return false;
+        }
+        if (!Upgrade(node, version)) {
+          WriteUnlock(parent);
+          return false;
+        }
+        auto next = static_cast<NodeType>(static_cast<uint8_t>(node->type_) + 1);
+        InnerNode *grown = Resize(node, next);
+        AddChild(grown, byte, new Leaf(key, value));
+        ReplaceChild(parent, parent_byte, grown);
+        WriteUnlockObsolete(node);
+        WriteUnlock(parent);
+        epochs_.Retire(node, DeleteRetired);
+      } else {
+        if (!Upgrade(node, version)) {
+          return false;
+        }
+        AddChild(node, byte, new Leaf(key, value));
+        WriteUnlock(node);
+      }
+      size_.fetch_add(1, std::memory_order_relaxed);
+      *inserted = true;
+      return true;
+    }
+
+    if (child->type_ == NodeType::LEAF) {
+      const auto *leaf = static_cast<const Leaf *>(child);
+      size_t begin = depth + 1;
+      size_t common = 0;
+      while (begin + common < key.size() && begin + common < leaf->key_.size() &&
+             key[begin + common] == leaf->key_[begin + common]) {
+        common++;
+      }
+      if (begin + common >= key.size() || begin + common >= leaf->key_.size()) {
+        // the same key, or one is a prefix of the other
+        *inserted = false;
+        return true;
+      }
+      if (!Upgrade(node, version)) {
+        return false;
+      }
+      auto *expanded = new Node4();
+      SetPrefix(expanded, key, begin, static_cast<uint32_t>(common));
+      AddChild(expanded, KeyByte(leaf->key_, begin + common), child);
+      AddChild(expanded, KeyByte(key, begin + common), new Leaf(key, value));
+      ReplaceChild(node, byte, expanded);
+      WriteUnlock(node);
+      size_.fetch_add(1, std::memory_order_relaxed);
+      *inserted = true;
+      return true;
+    }
+
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = static_cast<InnerNode *>(child);
+    if (!ReadLock(node, &version) || !Validate(parent, parent_version)) {
+      return false;
+    }
+    depth++;
+  }
+}
+
+/*
+ * Unlink the leaf of the key from its node. A Node4 left with a single child
+ * is replaced by that child, which takes over the prefix and the key byte of
+ * the Node4; other nodes shrink into the previous layout once few enough
+ * children remain.
+ * @return false if the descent has to restart
+ */
+auto AdaptiveRadixTree::RemoveOptimistic(const std::string &key, bool *removed) -> bool {
+  InnerNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  InnerNode *node = root_;
+  uint64_t version;
+  if (!ReadLock(node, &version)) {
+    return false;
+  }
+  size_t depth = 0;
+  *removed = false;
+  while (true) {
+    size_t node_depth = depth;
+    uint32_t prefix_len = node->prefix_len_;
+    for (uint32_t i = 0; i < std::min(prefix_len, MAX_PREFIX); i++) {
+      if (depth + i >= key.size() || KeyByte(key, depth + i) != node->prefix_[i]) {
+        return Validate(node, version);
+      }
+    }
+    depth += prefix_len;
+    if (depth >= key.size()) {
+      return Validate(node, version);
+    }
+
+    uint8_t byte = KeyByte(key, depth);
+    Node *child = FindChild(node, byte);
+    if (!Validate(node, version)) {
+      return false;
+    }
+    if (child == nullptr) {
+      return true;
+    }
+
+    if (child->type_ == NodeType::LEAF) {
+      if (static_cast<const Leaf *>(child)->key_ != key) {
+        return true;
+      }
+      if (parent != nullptr && node->type_ == NodeType::NODE4 && node->count_ <= 2) {
+        if (!Upgrade(parent, parent_version)) {
+          return false;
+        }
+        if (!Upgrade(node, version)) {
+          WriteUnlock(parent);
+          return false;
+        }
+        auto *node4 = static_cast<Node4 *>(node);
+        int other = node4->keys_[0] == byte ? 1 : 0;
+        Node *other_child = node4->children_[other].load();
+        if (other_child->type_ != NodeType::LEAF) {
+          // the inner child absorbs the prefix of the Node4 and its own key byte
+          auto *inner = static_cast<InnerNode *>(other_child);
+          uint64_t inner_version;
+          if (!ReadLock(inner, &inner_version) || !Upgrade(inner, inner_version)) {
+            WriteUnlock(node);
+            WriteUnlock(parent);
+            return false;
+          }
+          const Leaf *below = AnyLeaf(inner);
+          SetPrefix(inner, below->key_, node_depth, prefix_len + 1 + inner->prefix_len_);
+          WriteUnlock(inner);
+        }
+        ReplaceChild(parent, parent_byte, other_child);
+        WriteUnlockObsolete(node);
+        WriteUnlock(parent);
+        epochs_.Retire(node, DeleteRetired);
+      } else if (parent != nullptr && IsUnderfull(node)) {
+        if (!Upgrade(parent, parent_version)) {
+          return false;
+        }
+        if (!Upgrade(node, version)) {
+          WriteUnlock(parent);
+          return false;
+        }
+        auto previous = static_cast<NodeType>(static_cast<uint8_t>(node->type_) - 1);
+        InnerNode *shrunk = Resize(node, previous);
+        RemoveChild(shrunk, byte);
+        ReplaceChild(parent, parent_byte, shrunk);
+        WriteUnlockObsolete(node);
+        WriteUnlock(parent);
+        epochs_.Retire(node, DeleteRetired);
+      } else {
+        if (!Upgrade(node, version)) {
+          return false;
+        }
+        RemoveChild(node, byte);
+        WriteUnlock(node);
+      }
+      epochs_.Retire(child, DeleteRetired);
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      *removed = true;
+      return true;
+    }
+
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = static_cast<InnerNode *>(child);
+    if (!ReadLock(node, &version) || !Validate(parent, parent_version)) {
+      return false;
+    }
+    depth++;
+  }
+}
+
+/*
+ * Only the stored prefix bytes are compared on the way down, the leaf decides.
+ * @return false if the descent has to restart
+ */
+auto AdaptiveRadixTree::LookupOptimistic(const std::string &key, RID *value, bool *found) const -> bool {
+  const InnerNode *node = root_;
+  uint64_t version;
+  if (!ReadLock(node, &version)) {
+    return false;
+  }
+  size_t depth = 0;
+  *found = false;
+  while (true) {
+    uint32_t prefix_len = node->prefix_len_;
+    for (uint32_t i = 0; i < std::min(prefix_len, MAX_PREFIX); i++) {
+      if (depth + i >= key.size() || KeyByte(key, depth + i) != node->prefix_[i]) {
+        return Validate(node, version);
+      }
+    }
+    depth += prefix_len;
+    if (depth >= key.size()) {
+      return Validate(node, version);
+    }
+
+    const Node *child = FindChild(node, KeyByte(key, depth));
+    if (!Validate(node, version)) {
+      return false;
+    }
+    if (child == nullptr) {
+      return true;
+    }
+    if (child->type_ == NodeType::LEAF) {
+      // leaves never change, and stay allocated for as long as this operation runs
+      const auto *leaf = static_cast<const Leaf *>(child);
+      if (leaf->key_ == key) {
+        *value = leaf->value_;
+        *found = true;
+      }
+      return true;
+    }
+
+    const auto *next = static_cast<const InnerNode *>(child);
+    uint64_t next_version;
+    if (!ReadLock(next, &next_version) || !Validate(node, version)) {
+      return false;
+    }
+    node = next;
+    version = next_version;
+    depth++;
+  }
+}
+
+/*
+ * Report the entries below node in key order. path holds the key bytes that
+ * lead to node; low_clear and high_clear tell that every key below node is
+ * known to lie above the low bound, and below the high bound, which is always
+ * the case for a missing bound. Every inner node
+ * is read through a validated snapshot of its children.
+ */
+auto AdaptiveRadixTree::ScanNode(const Node *node, std::string *path, bool low_clear, bool high_clear,
+                                 ScanState *state) const -> ScanStatus {
+  if (node->type_ == NodeType::LEAF) {
+    const auto *leaf = static_cast<const Leaf *>(node);
+    if (!low_clear) {
+      int cmp = leaf->key_.compare(*state->low_);
+      if (cmp < 0 || (cmp == 0 && !state->low_inclusive_)) {
+        return ScanStatus::CONTINUE;
+      }
+    }
+    if (!high_clear) {
+      int cmp = leaf->key_.compare(*state->high_);
+      if (cmp > 0 || (cmp == 0 && !state->high_inclusive_)) {
+        return ScanStatus::STOP;
+      }
+    }
+    state->emitted_ = true;
+    state->last_ = leaf->key_;
+    (*state->emit_)(leaf->key_, leaf->value_);
+    return ScanStatus::CONTINUE;
+  }
+
+  const auto *inner = static_cast<const InnerNode *>(node);
+  uint64_t version;
+  if (!ReadLock(inner, &version)) {
+    return ScanStatus::RESTART;
+  }
+  uint32_t prefix_len = inner->prefix_len_;
+  uint8_t prefix[MAX_PREFIX];
+  std::memcpy(prefix, inner->prefix_, MAX_PREFIX);
+  if (!Validate(inner, version)) {
+    return ScanStatus::RESTART;
+  }
+
+  size_t depth = path->size();
+  if (prefix_len <= MAX_PREFIX) {
+    path->append(reinterpret_cast<const char *>(prefix), prefix_len);
+  } else {
+    path->append(AnyLeaf(inner)->key_, depth, prefix_len);
+  }
+  // compare the path with the bounds, keys below node all start with it
+  size_t len = path->size();
+  if (!low_clear) {
+    int cmp = path->compare(0, len, *state->low_, 0, std::min(len, state->low_->size()));
+    if (cmp < 0) {
+      path->resize(depth);
+      return ScanStatus::CONTINUE;
+    }
+    low_clear = cmp > 0 || len >= state->low_->size();
+  }
+  if (!high_clear) {
+    int cmp = path->compare(0, len, *state->high_, 0, std::min(len, state->high_->size()));
+    if (cmp > 0 || (cmp == 0 && len >= state->high_->size())) {
+      path->resize(depth);
+      return ScanStatus::STOP;
+    }
+    high_clear = cmp < 0;
+  }
+
+  // only the children between the next bytes of the bounds can hold keys in range
+  std::vector<std::pair<uint8_t, Node *>> children;
+  ChildrenInOrder(inner, &children, low_clear ? 0 : KeyByte(*state->low_, len),
+                  high_clear ? 0xff : KeyByte(*state->high_, len));
+  if (!Validate(inner, version)) {
+    path->resize(depth);
+    return ScanStatus::RESTART;
+  }
+
+  ScanStatus status = ScanStatus::CONTINUE;
+  for (const auto &[byte, child] : children) {
+    // the path equals the prefix of a bound that is not clear, so the next byte decides
+    bool child_low_clear = low_clear || byte > KeyByte(*state->low_, len);
+    bool child_high_clear = high_clear || byte < KeyByte(*state->high_, len);
+    path->push_back(static_cast<char>(byte));
+    status = ScanNode(child, path, child_low_clear, child_high_clear, state);
+    path->pop_back();
+    if (status != ScanStatus::CONTINUE) {
+      break;
+    }
+  }
+  path->resize(depth);
+  return status;
+}
+
+/*
+ * Version words: a reader waits out a writer and gives up on an obsolete
+ * node, a writer locks by bumping the version from exactly the one it read.
+ */
+auto AdaptiveRadixTree::ReadLock(const InnerNode *node, uint64_t *version) -> bool {
+  uint64_t current = node->version_.load(std::memory_order_acquire);
+  while ((current & 0b10) != 0) {
+    std::this_thread::yield();
+    current = node->version_.load(std::memory_order_acquire);
+  }
+  *version = current;
+  return (current & 0b01) == 0;
+}
+
+auto AdaptiveRadixTree::Validate(const InnerNode *node, uint64_t version) -> bool {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return node->version_.load(std::memory_order_relaxed) == version;
+}
+
+auto AdaptiveRadixTree::Upgrade(InnerNode *node, uint64_t version) -> bool {
+  return node->version_.compare_exchange_strong(version, version + 0b10);
+}
+
+void AdaptiveRadixTree::WriteUnlock(InnerNode *node) { node->version_.fetch_add(0b10); }
+
+void AdaptiveRadixTree::WriteUnlockObsolete(InnerNode *node) { node->version_.fetch_add(0b11); }
+
+auto AdaptiveRadixTree::FindChild(const InnerNode *node, uint8_t byte) -> Node * {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      const auto *node4 = static_cast<const Node4 *>(node);
+      for (int i = 0; i < std::min<int>(node4->count_, 4); i++) {
+        if (node4->keys_[i] == byte) {
+          return node4->children_[i].load(std::memory_order_acquire);
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::NODE16: {
+      const auto *node16 = static_cast<const Node16 *>(node);
+      int count = std::min<int>(node16->count_, 16);
+#if defined(__SSE2__)
+      __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                       _mm_load_si128(reinterpret_cast<const __m128i *>(node16->keys_)));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches)) & ((1U << count) - 1);
+      return mask == 0 ? nullptr : node16->children_[__builtin_ctz(mask)].load(std::memory_order_acquire);
+#else
+      for (int i = 0; i < count; i++) {
+        if (node16->keys_[i] == byte) {
+          return node16->children_[i].load(std::memory_order_acquire);
+        }
+      }
+      return nullptr;
+#endif
+    }
+    case NodeType::NODE48: {
+      const auto *node48 = static_cast<const Node48 *>(node);
+      uint8_t slot = node48->child_index_[byte];
+      return slot >= Node48::EMPTY ? nullptr : node48->children_[slot].load(std::memory_order_acquire);
+    }
+    case NodeType::NODE256:
+      return static_cast<const Node256 *>(node)->children_[byte].load(std::memory_order_acquire);
+    default:
+      return nullptr;
+  }
+}
+
+auto AdaptiveRadixTree::IsFull(const InnerNode *node) -> bool {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return node->count_ >= 4;
+    case NodeType::NODE16:
+      return node->count_ >= 16;
+    case NodeType::NODE48:
+      return node->count_ >= 48;
+    default:
+      return false;
+  }
+}
+
+/* Whether the node should shrink into the previous layout on removing a child, a bit below its capacity */
+auto AdaptiveRadixTree::IsUnderfull(const InnerNode *node) -> bool {
+  switch (node->type_) {
+    case NodeType::NODE16:
+      return node->count_ - 1 <= 3;
+    case NodeType::NODE48:
+      return node->count_ - 1 <= 12;
+    case NodeType::NODE256:
+      return node->count_ - 1 <= 37;
+    default:
+      return false;
+  }
+}
+
+/* The caller makes sure the node has room and no child under byte yet */
+void AdaptiveRadixTree::AddChild(InnerNode *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys = node->type_ == NodeType::NODE4 ? static_cast<Node4 *>(node)->keys_
+                                                     : static_cast<Node16 *>(node)->keys_;
+      std::atomic<Node *> *children = node->type_ == NodeType::NODE4 ? static_cast<Node4 *>(node)->children_
+                                                                     : static_cast<Node16 *>(node)->children_;
+      int pos = 0;
+      while (pos < node->count_ && keys[pos] < byte) {
+        pos++;
+      }
+      for (int i = node->count_; i > pos; i--) {
+        keys[i] = keys[i - 1];
+        children[i].store(children[i - 1].load(std::memory_order_relaxed), std::memory_order_release);
+      }
+      keys[pos] = byte;
+      children[pos].store(child, std::memory_order_release);
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *node48 = static_cast<Node48 *>(node);
+      uint8_t slot = 0;
+      while (node48->children_[slot].load(std::memory_order_relaxed) != nullptr) {
+        slot++;
+      }
+      node48->children_[slot].store(child, std::memory_order_release);
+      node48->child_index_[byte] = slot;
+      break;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte].store(child, std::memory_order_release);
+      break;
+    default:
+      return;
+  }
+  node->count_++;
+}
+
+void AdaptiveRadixTree::ReplaceChild(InnerNode *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *node4 = static_cast<Node4 *>(node);
+      for (int i = 0; i < node4->count_; i++) {
+        if (node4->keys_[i] == byte) {
+          node4->children_[i].store(child, std::memory_order_release);
+        }
+      }
+      break;
+    }
+    case NodeType::NODE16: {
+      auto *node16 = static_cast<Node16 *>(node);
+      for (int i = 0; i < node16->count_; i++) {
+        if (node16->keys_[i] == byte) {
+          node16->children_[i].store(child, std::memory_order_release);
+        }
+      }
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *node48 = static_cast<Node48 *>(node);
+      node48->children_[node48->child_index_[byte]].store(child, std::memory_order_release);
+      break;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte].store(child, std::memory_order_release);
+      break;
+    default:
+      break;
+  }
+}
+
+void AdaptiveRadixTree::RemoveChild(InnerNode *node, uint8_t byte) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys = node->type_ == NodeType::NODE4 ? static_cast<Node4 *>(node)->keys_
+                                                     : static_cast<Node16 *>(node)->keys_;
+      std::atomic<Node *> *children = node->type_ == NodeType::NODE4 ? static_cast<Node4 *>(node)->children_
+                                                                     : static_cast<Node16 *>(node)->children_;
+      int pos = 0;
+      while (pos < node->count_ && keys[pos] != byte) {
+        pos++;
+      }
+      if (pos == node->count_) {
+        return;
+      }
+      for (int i = pos; i + 1 < node->count_; i++) {
+        keys[i] = keys[i + 1];
+        children[i].store(children[i + 1].load(std::memory_order_relaxed), std::memory_order_release);
+      }
+      children[node->count_ - 1].store(nullptr, std::memory_order_release);
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *node48 = static_cast<Node48 *>(node);
+      uint8_t slot = node48->child_index_[byte];
+      if (slot >= Node48::EMPTY) {
+        return;
+      }
+      node48->child_index_[byte] = Node48::EMPTY;
+      node48->children_[slot].store(nullptr, std::memory_order_release);
+      break;
+    }
+    case NodeType::NODE256: {
+      auto *node256 = static_cast<Node256 *>(node);
+      if (node256->children_[byte].load(std::memory_order_relaxed) == nullptr) {
+        return;
+      }
+      node256->children_[byte].store(nullptr, std::memory_order_release);
+      break;
+    }
+    default:
+      return;
+  }
+  node->count_--;
+}
+
+/* A copy of a locked node in another layout that has room for all its children */
+auto AdaptiveRadixTree::Resize(const InnerNode *node, NodeType type) -> InnerNode * {
+  InnerNode *resized;
+  switch (type) {
+    case NodeType::NODE4:
+      resized = new Node4();
+      break;
+    case NodeType::NODE16:
+      resized = new Node16();
+      break;
+    case NodeType::NODE48:
+      resized = new Node48();
+      break;
+    default:
+      resized = new Node256();
+      break;
+  }
+  resized->prefix_len_ = node->prefix_len_;
+  std::memcpy(resized->prefix_, node->prefix_, MAX_PREFIX);
+  std::vector<std::pair<uint8_t, Node *>> children;
+  ChildrenInOrder(node, &children);
+  for (const auto &[byte, child] : children) {
+    AddChild(resized, byte, child);
+  }
+  return resized;
+}
+
+void AdaptiveRadixTree::ChildrenInOrder(const InnerNode *node, std::vector<std::pair<uint8_t, Node *>> *children,
+                                        uint8_t from, uint8_t to) {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      const auto *node4 = static_cast<const Node4 *>(node);
+      for (int i = 0; i < std::min<int>(node4->count_, 4); i++) {
+        if (node4->keys_[i] >= from && node4->keys_[i] <= to) {
+          children->emplace_back(node4->keys_[i], node4->children_[i].load(std::memory_order_acquire));
+        }
+      }
+      break;
+    }
+    case NodeType::NODE16: {
+      const auto *node16 = static_cast<const Node16 *>(node);
+      for (int i = 0; i < std::min<int>(node16->count_, 16); i++) {
+        if (node16->keys_[i] >= from && node16->keys_[i] <= to) {
+          children->emplace_back(node16->keys_[i], node16->children_[i].load(std::memory_order_acquire));
+        }
+      }
+      break;
+    }
+    case NodeType::NODE48: {
+      const auto *node48 = static_cast<const Node48 *>(node);
+      for (int byte = from; byte <= to; byte++) {
+        uint8_t slot = node48->child_index_[byte];
+        Node *child = slot >= Node48::EMPTY ? nullptr : node48->children_[slot].load(std::memory_order_acquire);
+        if (child != nullptr) {
+          children->emplace_back(byte, child);
+        }
+      }
+      break;
+    }
+    case NodeType::NODE256: {
+      const auto *node256 = static_cast<const Node256 *>(node);
+      for (int byte = from; byte <= to; byte++) {
+        Node *child = node256->children_[byte].load(std::memory_order_acquire);
+        if (child != nullptr) {
+          children->emplace_back(byte, child);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  // a torn read of a node being written may show a slot that was just cleared
+  children->erase(std::remove_if(children->begin(), children->end(), [](const auto &entry) { return !entry.second; }),
+                  children->end());
+}
+
+/*
+ * Some leaf below node, whose key holds the full prefix of every node on the
+ * way. Every leaf that ever was below node shares those bytes, so a descent
+ * racing with writers still finds a good one, it only retries when it runs
+ * into a node that is being emptied.
+ */
+auto AdaptiveRadixTree::AnyLeaf(const Node *node) -> const Leaf * {
+  const Node *current = node;
+  std::vector<std::pair<uint8_t, Node *>> children;
+  while (current->type_ != NodeType::LEAF) {
+    children.clear();
+    ChildrenInOrder(static_cast<const InnerNode *>(current), &children);
+    current = children.empty() ? node : children.front().second;
+  }
+  return static_cast<const Leaf *>(current);
+}
+
+/* The number of prefix bytes of node that match key from depth on, reading those past MAX_PREFIX from a leaf */
+auto AdaptiveRadixTree::PrefixMismatch(const InnerNode *node, const std::string &key, size_t depth) -> uint32_t {
+  uint32_t prefix_len = node->prefix_len_;
+  for (uint32_t i = 0; i < std::min(prefix_len, MAX_PREFIX); i++) {
+    if (depth + i >= key.size() || KeyByte(key, depth + i) != node->prefix_[i]) {
+      return i;
+    }
+  }
+  if (prefix_len > MAX_PREFIX) {
+    const Leaf *leaf = AnyLeaf(node);
+    for (uint32_t i = MAX_PREFIX; i < prefix_len; i++) {
+      if (depth + i >= key.size() || depth + i >= leaf->key_.size() || key[depth + i] != leaf->key_[depth + i]) {
+        return i;
+      }
+    }
+  }
+  return prefix_len;
+}
+
+void AdaptiveRadixTree::SetPrefix(InnerNode *node, const std::string &key, size_t begin, uint32_t length) {
+  node->prefix_len_ = length;
+  std::memcpy(node->prefix_, key.data() + begin, std::min(length, MAX_PREFIX));
+}
+
+void AdaptiveRadixTree::FreeSubtree(Node *node) {
+  if (node->type_ != NodeType::LEAF) {
+    std::vector<std::pair<uint8_t, Node *>> children;
+    ChildrenInOrder(static_cast<InnerNode *>(node), &children);
+    for (const auto &[byte, child] : children) {
+      FreeSubtree(child);
+    }
+  }
+  DeleteNode(node);
+}
+
+void AdaptiveRadixTree::DeleteNode(Node *node) {
+  switch (node->type_) {
+    case NodeType::LEAF:
+      delete static_cast<Leaf *>(node);
+      break;
+    case NodeType::NODE4:
+      delete static_cast<Node4 *>(node);
+      break;
+    case NodeType::NODE16:
+      delete static_cast<Node16 *>(node);
+      break;
+    case NodeType::NODE48:
+      delete static_cast<Node48 *>(node);
+      break;
+    case NodeType::NODE256:
+      delete static_cast<Node256 *>(node);
+      break;
+  }
+}
+
+void AdaptiveRadixTree::DeleteRetired(void *node) { DeleteNode(static_cast<Node *>(node)); }
+
+}  // namespace bustub
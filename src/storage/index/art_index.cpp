@@ -0,0 +1,28 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.cpp
+//
+// Identification: src/storage/index/art_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/art_index.h"
+
+namespace bustub {
+
+ARTIndex::ARTIndex(std::unique_ptr<IndexMetadata> &&metadata) : NormalizedKeyIndex(std::move(metadata)) {}
+
+void ARTIndex::InsertKey(const std::string &key, RID rid) { tree_.Insert(key, rid); }
+
+void ARTIndex::RemoveKey(const std::string &key) { tree_.Remove(key); }
+
+auto ARTIndex::LookupKey(const std::string &key, RID *rid) const -> bool { return tree_.Lookup(key, rid); }
+
+void ARTIndex::ScanKeys(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                        const std::function<void(const std::string &, RID)> &emit) const {
+  tree_.Scan(low, low_inclusive, high, high_inclusive, emit);
+}
+
+}  // namespace bustub
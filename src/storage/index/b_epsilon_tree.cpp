@@ -0,0 +1,285 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree.cpp
+//
+// Identification: src/storage/index/b_epsilon_tree.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/b_epsilon_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BEPSILONTREE_TYPE::BEpsilonTree(std::string name, BufferPoolManager *buffer_pool_manager,
+                                const KeyComparator &comparator, int leaf_max_size, int internal_max_size,
+                                int buffer_max_size)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size),
+      buffer_max_size_(buffer_max_size) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BEPSILONTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_PAGE_ID; }
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Walk down to the leaf for key, unless a buffer on the way holds a message
+ * for it: messages are newer than everything below them.
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BEPSILONTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction)
+    -> bool {
+  latch_.RLock();
+  page_id_t page_id = root_page_id_;
+  bool is_exist = false;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = FetchTreePage(page_id);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    if (node->IsLeafPage()) {
+      ValueType value;
+      is_exist = reinterpret_cast<LeafPage *>(node)->Lookup(key, &value, comparator_);
+      if (is_exist) {
+        result->push_back(value);
+      }
+    } else {
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      const Message *message = internal->FindMessage(key, comparator_);
+      if (message == nullptr) {
+        next_page_id = internal->Lookup(key, comparator_);
+      } else if (message->type_ == MessageType::UPSERT) {
+        is_exist = true;
+        result->push_back(message->value_);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  latch_.RUnlock();
+  return is_exist;
+}
+
+/*****************************************************************************
+ * INSERTION AND DELETION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  Put(Message{key, value, MessageType::UPSERT});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  Put(Message{key, ValueType(), MessageType::DELETE});
+}
+
+/*
+ * Hand a message to the root: a root leaf applies it right away, a root
+ * internal page buffers it and flushes once its buffer fills up. A root that
+ * ends up too full is split under a new root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Put(const Message &message) {
+  latch_.WLock();
+  if (IsEmpty()) {
+    if (message.type_ == MessageType::DELETE) {
+      latch_.WUnlock();
+      return;
+    }
+    page_id_t page_id;
+    auto *leaf = reinterpret_cast<LeafPage *>(NewTreePage(&page_id)->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    root_page_id_ = page_id;
+    UpdateRootPageId(1);
+  }
+
+  page_id_t root_page_id = root_page_id_;
+  auto *node = reinterpret_cast<BPlusTreePage *>(FetchTreePage(root_page_id)->GetData());
+  KeyType separator;
+  page_id_t sibling_id = INVALID_PAGE_ID;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    ApplyToLeaf(leaf, message);
+    if (leaf->IsFull()) {
+      sibling_id = SplitLeaf(leaf, &separator);
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    internal->PutMessage(message, comparator_);
+    if (internal->IsBufferFull()) {
+      FlushBuffer(internal);
+    }
+    if (internal->GetSize() > internal->GetMaxSize()) {
+      sibling_id = SplitInternal(internal, &separator);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(root_page_id, true);
+  if (sibling_id != INVALID_PAGE_ID) {
+    GrowRoot(root_page_id, separator, sibling_id);
+  }
+  latch_.WUnlock();
+}
+
+/*
+ * Move the messages bound for the fullest child of node one level down: a
+ * leaf child applies them, an internal child buffers them and flushes its own
+ * buffer when it fills up. Once the child splits, its new sibling is posted to
+ * node and the remaining messages stay in node, to be routed on a later
+ * flush. At least one message leaves node, so its buffer is no longer full;
+ * node may end up with one pivot too many, which the caller splits.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::FlushBuffer(InternalPage *node) {
+  int child_index = node->FullestChild(comparator_);
+  page_id_t child_id = node->ValueAt(child_index);
+  std::vector<Message> messages;
+  node->TakeMessages(child_index, comparator_, &messages);
+
+  auto *child = reinterpret_cast<BPlusTreePage *>(FetchTreePage(child_id)->GetData());
+  KeyType separator;
+  page_id_t sibling_id = INVALID_PAGE_ID;
+  size_t flushed = 0;
+  if (child->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(child);
+    while (flushed < messages.size() && sibling_id == INVALID_PAGE_ID) {
+      ApplyToLeaf(leaf, messages[flushed++]);
+      if (leaf->IsFull()) {
+        sibling_id = SplitLeaf(leaf, &separator);
+      }
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(child);
+    while (flushed < messages.size() && sibling_id == INVALID_PAGE_ID) {
+      internal->PutMessage(messages[flushed++], comparator_);
+      if (internal->IsBufferFull()) {
+        FlushBuffer(internal);
+      }
+      if (internal->GetSize() > internal->GetMaxSize()) {
+        sibling_id = SplitInternal(internal, &separator);
+      }
+    }
+  }
+  buffer_pool_manager_->UnpinPage(child_id, true);
+
+  if (sibling_id != INVALID_PAGE_ID) {
+    node->InsertNodeAfter(child_id, separator, sibling_id);
+  }
+  for (; flushed < messages.size(); flushed++) {
+    node->PutMessage(messages[flushed], comparator_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::ApplyToLeaf(LeafPage *leaf, const Message &message) {
+  leaf->RemoveAndDeleteRecord(message.key_, comparator_);
+  if (message.type_ == MessageType::UPSERT) {
+    leaf->Insert(message.key_, message.value_, comparator_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BEPSILONTREE_TYPE::SplitLeaf(LeafPage *leaf, KeyType *separator) -> page_id_t {
+  page_id_t sibling_id;
+  auto *sibling = reinterpret_cast<LeafPage *>(NewTreePage(&sibling_id)->GetData());
+  sibling->Init(sibling_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->MoveHalfTo(sibling);
+  *separator = sibling->KeyAt(0);
+  leaf->SetHighKey(*separator);
+  if (sibling->GetNextPageId() != INVALID_PAGE_ID) {
+    auto *next = reinterpret_cast<LeafPage *>(FetchTreePage(sibling->GetNextPageId())->GetData());
+    next->SetPrevPageId(sibling_id);
+    buffer_pool_manager_->UnpinPage(next->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(sibling_id, true);
+  return sibling_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BEPSILONTREE_TYPE::SplitInternal(InternalPage *node, KeyType *separator) -> page_id_t {
+  page_id_t sibling_id;
+  auto *sibling = reinterpret_cast<InternalPage *>(NewTreePage(&sibling_id)->GetData());
+  sibling->Init(sibling_id, internal_max_size_, buffer_max_size_);
+  *separator = node->MoveHalfTo(sibling, comparator_);
+  buffer_pool_manager_->UnpinPage(sibling_id, true);
+  return sibling_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::GrowRoot(page_id_t old_root_id, const KeyType &separator, page_id_t sibling_id) {
+  page_id_t root_id;
+  auto *root = reinterpret_cast<InternalPage *>(NewTreePage(&root_id)->GetData());
+  root->Init(root_id, internal_max_size_, buffer_max_size_);
+  root->PopulateNewRoot(old_root_id, separator, sibling_id);
+  buffer_pool_manager_->UnpinPage(root_id, true);
+  root_page_id_ = root_id;
+  UpdateRootPageId();
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BEPSILONTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BEPSILONTREE_TYPE::FetchTreePage(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch b-epsilon tree page, all frames are pinned");
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BEPSILONTREE_TYPE::NewTreePage(page_id_t *page_id) -> Page * {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate b-epsilon tree page, all frames are pinned");
+  }
+  return page;
+}
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ * @parameter: insert_record      default value is false. When set to true,
+ * insert a record <index_name, root_page_id> into header page instead of
+ * updating it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::UpdateRootPageId(int insert_record) {
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  header_page->WLatch();
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  header_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template class BEpsilonTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BEpsilonTree<IntegerKey<int32_t>, RID, IntegerKeyComparator<int32_t>>;
+template class BEpsilonTree<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+
+}  // namespace bustub
@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 #include <string>
+#include <utility>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -14,29 +17,25 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, ConcurrencyMode mode)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {
+      internal_max_size_(internal_max_size),
+      mode_(mode) {
   LOG_INFO("leaf_max_size: %d", leaf_max_size);
   LOG_INFO("intermal_max_size: %d", internal_max_size_);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key) -> Page * {
-  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
-  auto tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
-
-  while (!tree_page->IsLeafPage()) {
-    auto interbal_page = reinterpret_cast<InternalPage *>(tree_page);
-    auto page_id = interbal_page->Lookup(key, comparator_);
-    page = buffer_pool_manager_->FetchPage(page_id);
-    tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
+BPLUSTREE_TYPE::~BPlusTree() {
+  RetryFreePages();
+  if (!pending_free_pages_.empty()) {
+    LOG_WARN("%s: %zu freed pages are still pinned and were not deleted", index_name_.c_str(),
+             pending_free_pages_.size());
   }
-  return page;
 }
 
 /*
@@ -53,19 +52,299 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_P
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  std::cout << "getvalue key:" << key << std::endl;
-  Page *page = FindLeaf(key);
+auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction,
+                              page_id_t *leaf_page_id) -> bool {
+  Page *page =
+      mode_ == ConcurrencyMode::B_LINK ? FindLeafBLink(key, Operation::SEARCH) : FindLeaf(key, Operation::SEARCH);
+  if (page == nullptr) {
+    return false;
+  }
   auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
   ValueType value;
   bool is_exist = leaf_page->Lookup(key, &value, comparator_);
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  if (leaf_page_id != nullptr) {
+    *leaf_page_id = page->GetPageId();
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
   if (is_exist) {
     result->push_back(value);
   }
   return is_exist;
 }
 
+/*
+ * Copy the entries of the leaf covering key under its read latch, e.g. to
+ * cache a hot leaf outside of the buffer pool.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetLeafEntries(const KeyType &key, std::vector<MappingType> *entries) -> page_id_t {
+  Page *page =
+      mode_ == ConcurrencyMode::B_LINK ? FindLeafBLink(key, Operation::SEARCH) : FindLeaf(key, Operation::SEARCH);
+  if (page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    entries->emplace_back(leaf->GetItem(i));
+  }
+  page_id_t page_id = page->GetPageId();
+  ReleaseLeaf(page, false, false);
+  return page_id;
+}
+
+/*
+ * Look up many keys with one descent per leaf instead of one per key: visit
+ * the keys in sorted order and keep the leaf latched while they stay below
+ * its high key. The keys in between cannot be in another leaf, since every
+ * key routed to the leaf was not below its lower bound either.
+ * @return : the number of keys found
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValueBatch(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                                   Transaction *transaction) -> int {
+  results->resize(keys.size());
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t a, size_t b) { return comparator_(keys[a], keys[b]) < 0; });
+
+  int found = 0;
+  Page *page = nullptr;
+  for (size_t i : order) {
+    const KeyType &key = keys[i];
+    if (page != nullptr && NeedMoveRight(reinterpret_cast<BPlusTreePage *>(page->GetData()), key, LeafTarget::KEY)) {
+      ReleaseLeaf(page, false, false);
+      page = nullptr;
+    }
+    if (page == nullptr) {
+      page =
+          mode_ == ConcurrencyMode::B_LINK ? FindLeafBLink(key, Operation::SEARCH) : FindLeaf(key, Operation::SEARCH);
+      if (page == nullptr) {
+        return 0;
+      }
+    }
+    ValueType value;
+    if (reinterpret_cast<LeafPage *>(page->GetData())->Lookup(key, &value, comparator_)) {
+      (*results)[i].push_back(value);
+      found++;
+    }
+  }
+  if (page != nullptr) {
+    ReleaseLeaf(page, false, false);
+  }
+  return found;
+}
+
+/*****************************************************************************
+ * LATCH CRABBING
+ *****************************************************************************/
+/*
+ * Optimistic descent: read latch every internal page on the way down, always
+ * holding the parent until the child is latched. The leaf is read latched for
+ * SEARCH and write latched for INSERT/DELETE.
+ * @return : the latched and pinned leaf page, or nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, Operation operation, LeafTarget target) -> Page * {
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  bool resident = false;
+  Page *page = FetchUpperPage(root_page_id_, &resident);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  // a page cannot change type while its parent (or the root latch) is held, so peeking before latching is safe
+  if (node->IsLeafPage() && operation != Operation::SEARCH) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  root_latch_.RUnlock();
+
+  while (!node->IsLeafPage()) {
+    resident = resident || Swizzle(page);
+    page_id_t child_id = ChildFor(reinterpret_cast<InternalPage *>(node), key, target);
+    bool child_resident = false;
+    Page *child = FetchUpperPage(child_id, &child_resident);
+    auto *child_node = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    if (child_node->IsLeafPage() && operation != Operation::SEARCH) {
+      child->WLatch();
+    } else {
+      child->RLatch();
+    }
+    page->RUnlatch();
+    if (!resident) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    page = child;
+    node = child_node;
+    resident = child_resident;
+  }
+  return page;
+}
+
+/*
+ * Pessimistic descent: write latch every page on the way down and release all
+ * ancestors (including the root latch) once a page is safe for the operation.
+ * Every latch still held, including the returned leaf, stays in the page set.
+ * @return : the leaf page, or nullptr if the tree is empty (root latch held)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, Operation operation, Transaction *transaction)
+    -> Page * {
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  if (IsEmpty()) {
+    return nullptr;
+  }
+  page_id_t next_page_id = root_page_id_;
+  while (true) {
+    Page *page = FetchTreePage(next_page_id);
+    page->WLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, operation)) {
+      ReleaseLatchFromQueue(transaction, false);
+    }
+    transaction->AddIntoPageSet(page);
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    next_page_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+  }
+}
+
+/*
+ * A node is safe when the operation cannot propagate a structural change to
+ * its parent: an insert will not split it and a delete will not underflow it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, Operation operation) -> bool {
+  if (operation == Operation::SEARCH) {
+    return true;
+  }
+  if (operation == Operation::INSERT) {
+    return node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->IsInsertSafe()
+                              : reinterpret_cast<InternalPage *>(node)->IsInsertSafe();
+  }
+  if (node->IsRootPage()) {
+    // a root leaf only disappears when emptied, a root internal page when left with one child
+    return node->IsLeafPage() ? node->GetSize() > 1 : node->GetSize() > 2;
+  }
+  return node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->IsDeleteSafe(min_fill_)
+                            : reinterpret_cast<InternalPage *>(node)->IsDeleteSafe(min_fill_);
+}
+
+/*
+ * Release every latch recorded in the page set, oldest first, and unpin the
+ * pages. A nullptr entry stands for the root latch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLatchFromQueue(Transaction *transaction, bool is_dirty) {
+  auto page_set = transaction->GetPageSet();
+  while (!page_set->empty()) {
+    Page *page = page_set->front();
+    page_set->pop_front();
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+      continue;
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchTreePage(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch b+ tree page, all frames are pinned");
+  }
+  return page;
+}
+
+/*
+ * Resident pages are used without a pin of their own: the swizzle table's pin
+ * keeps them in their frame, and they are only unswizzled while write latched.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchUpperPage(page_id_t page_id, bool *resident) -> Page * {
+  if (swizzle_table_ != nullptr) {
+    Page *page = swizzle_table_->Get(page_id);
+    if (page != nullptr) {
+      *resident = true;
+      return page;
+    }
+  }
+  *resident = false;
+  return FetchTreePage(page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Swizzle(Page *page) -> bool {
+  return swizzle_table_ != nullptr && swizzle_table_->Insert(page);
+}
+
+/* Release the swizzle table's pin of a page about to be freed */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Unswizzle(page_id_t page_id) {
+  if (swizzle_table_ != nullptr && swizzle_table_->Erase(page_id)) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewTreePage(page_id_t *page_id) -> Page * {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate b+ tree page, all frames are pinned");
+  }
+  return page;
+}
+
+/* The child of node a descent towards target continues with */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ChildFor(InternalPage *node, const KeyType &key, LeafTarget target) -> page_id_t {
+  switch (target) {
+    case LeafTarget::LEFTMOST:
+      return node->ValueAt(0);
+    case LeafTarget::RIGHTMOST:
+      return node->ValueAt(node->GetSize() - 1);
+    default:
+      return node->Lookup(key, comparator_);
+  }
+}
+
+/* Unlatch and unpin a leaf returned by a descent */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLeaf(Page *page, bool exclusive, bool is_dirty) {
+  if (exclusive) {
+    page->WUnlatch();
+  } else {
+    page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+}
+
+/*
+ * Point the prev link of leaf page_id (if any) at prev_page_id. The caller
+ * holds the write latch of that new left neighbour: writers latch leaves left
+ * to right, reverse iterators only ever try to latch a left neighbour while
+ * holding a leaf, so this cannot deadlock.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetPrevLink(page_id_t page_id, page_id_t prev_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  Page *page = FetchTreePage(page_id);
+  page->WLatch();
+  reinterpret_cast<LeafPage *>(page->GetData())->SetPrevPageId(prev_page_id);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -78,7 +357,210 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-  return false;
+  if (mode_ == ConcurrencyMode::B_LINK) {
+    return InsertBLink(key, value);
+  }
+  Page *page = FindLeaf(key, Operation::INSERT);
+  if (page != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    ValueType existing;
+    if (leaf->Lookup(key, &existing, comparator_)) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return false;
+    }
+    if (IsSafe(leaf, Operation::INSERT)) {
+      leaf->Insert(key, value, comparator_);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      return true;
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  // the leaf would split (or the tree is empty), retry holding write latches from the root
+  return InsertIntoLeafPessimistic(key, value, transaction);
+}
+
+/*
+ * Insert many entries with one descent per leaf instead of one per entry:
+ * sort the entries and keep the write latched leaf while the following keys
+ * stay below its high key and it has room for them. Entries that would split
+ * the leaf, or that belong to another one, release it and go through Insert,
+ * the next entry then descends again.
+ * @return : the number of entries inserted
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBatch(std::vector<MappingType> *entries, Transaction *transaction) -> int {
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) < 0; });
+
+  int inserted = 0;
+  Page *page = nullptr;
+  bool is_dirty = false;
+  for (auto &[key, value] : *entries) {
+    if (page != nullptr && NeedMoveRight(reinterpret_cast<BPlusTreePage *>(page->GetData()), key, LeafTarget::KEY)) {
+      ReleaseLeaf(page, true, is_dirty);
+      page = nullptr;
+    }
+    if (page == nullptr) {
+      page =
+          mode_ == ConcurrencyMode::B_LINK ? FindLeafBLink(key, Operation::INSERT) : FindLeaf(key, Operation::INSERT);
+      is_dirty = false;
+    }
+    if (page != nullptr) {
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      ValueType existing;
+      if (leaf->Lookup(key, &existing, comparator_)) {
+        continue;
+      }
+      if (IsSafe(leaf, Operation::INSERT)) {
+        leaf->Insert(key, value, comparator_);
+        is_dirty = true;
+        inserted++;
+        continue;
+      }
+      ReleaseLeaf(page, true, is_dirty);
+      page = nullptr;
+    }
+    // the leaf would split (or the tree is empty)
+    if (Insert(key, value, transaction)) {
+      inserted++;
+    }
+  }
+  if (page != nullptr) {
+    ReleaseLeaf(page, true, is_dirty);
+  }
+  return inserted;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertIntoLeafPessimistic(const KeyType &key, const ValueType &value, Transaction *transaction)
+    -> bool {
+  if (transaction == nullptr) {
+    Transaction local_transaction(INVALID_TXN_ID);
+    return InsertIntoLeafPessimistic(key, value, &local_transaction);
+  }
+  Page *page = FindLeafPessimistic(key, Operation::INSERT, transaction);
+  if (page == nullptr) {
+    StartNewTree(key, value);
+    ReleaseLatchFromQueue(transaction, false);
+    return true;
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType existing;
+  if (leaf->Lookup(key, &existing, comparator_)) {
+    ReleaseLatchFromQueue(transaction, false);
+    return false;
+  }
+  leaf->Insert(key, value, comparator_);
+  if (leaf->IsFull()) {
+    page_id_t new_page_id;
+    Page *new_page = NewTreePage(&new_page_id);
+    auto *new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+    new_leaf->Init(new_page_id, leaf->GetParentPageId(), leaf_max_size_);
+    leaf->MoveHalfTo(new_leaf);
+    SetPrevLink(new_leaf->GetNextPageId(), new_page_id);
+    KeyType separator = LeafSeparator(leaf, new_leaf);
+    leaf->SetHighKey(separator);
+    InsertIntoParent(leaf, separator, new_leaf, transaction);
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+  }
+  ReleaseLatchFromQueue(transaction, true);
+  return true;
+}
+
+/*
+ * Insert constant key & value pair into an empty tree
+ * User needs to first ask for new page from buffer pool manager, then update
+ * b+ tree's root page id and insert entry directly into leaf page.
+ * Caller must hold the root latch in write mode.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id;
+  Page *page = NewTreePage(&page_id);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->Insert(key, value, comparator_);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+/*
+ * Insert key & value pair into internal page after split
+ * @param   old_node      input page from split() method
+ * @param   key
+ * @param   new_node      returned page from split() method
+ * User needs to first find the parent page of old_node, parent node must be
+ * adjusted to take info of new_node into account. Remember to deal with split
+ * recursively if necessary. The parent is already write latched by the caller.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    page_id_t root_id;
+    Page *root_page = NewTreePage(&root_id);
+    auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+    root->Init(root_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(root_id);
+    new_node->SetParentPageId(root_id);
+    root_page_id_ = root_id;
+    UpdateRootPageId(0);
+    buffer_pool_manager_->UnpinPage(root_id, true);
+    return;
+  }
+
+  page_id_t parent_id = old_node->GetParentPageId();
+  Page *parent_page = FetchTreePage(parent_id);
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  new_node->SetParentPageId(parent_id);
+  if (!parent->IsFull()) {
+    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+    buffer_pool_manager_->UnpinPage(parent_id, true);
+    return;
+  }
+
+  page_id_t sibling_id;
+  Page *sibling_page = NewTreePage(&sibling_id);
+  auto *sibling = reinterpret_cast<InternalPage *>(sibling_page->GetData());
+  sibling->Init(sibling_id, parent->GetParentPageId(), internal_max_size_);
+  parent->InsertAndMoveHalfTo(sibling, old_node->GetPageId(), key, new_node->GetPageId(), buffer_pool_manager_);
+  InsertIntoParent(parent, sibling->KeyAt(0), sibling, transaction);
+  buffer_pool_manager_->UnpinPage(sibling_id, true);
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+}
+
+/*
+ * Replace the key of an entry in place, keeping its value. Separators above a
+ * leaf only bound its first and last entries, so an entry in between may take
+ * any key that still sorts between its neighbours without leaving the key
+ * range of its leaf.
+ * @return : false, leaving the tree unchanged, if key is not in the tree, is
+ * the first or last entry of its leaf, new_key sorts outside its neighbours
+ * or does not fit into the leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ReplaceKey(const KeyType &key, const KeyType &new_key) -> bool {
+  Page *page =
+      mode_ == ConcurrencyMode::B_LINK ? FindLeafBLink(key, Operation::INSERT) : FindLeaf(key, Operation::INSERT);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  bool replace = index > 0 && index < leaf->GetSize() - 1 && comparator_(leaf->KeyAt(index), key) == 0 &&
+                 comparator_(leaf->KeyAt(index - 1), new_key) < 0 && comparator_(new_key, leaf->KeyAt(index + 1)) < 0 &&
+                 leaf->CanSetKeyAt(index, new_key);
+  if (replace) {
+    leaf->SetKeyAt(index, new_key);
+  }
+  ReleaseLeaf(page, true, replace);
+  return replace;
 }
 
 /*****************************************************************************
@@ -92,7 +574,587 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  if (mode_ == ConcurrencyMode::B_LINK) {
+    RemoveBLink(key);
+    return;
+  }
+  Page *page = FindLeaf(key, Operation::DELETE);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType existing;
+  if (!leaf->Lookup(key, &existing, comparator_)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return;
+  }
+  if (IsSafe(leaf, Operation::DELETE)) {
+    leaf->RemoveAndDeleteRecord(key, comparator_);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    return;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  // the leaf would underflow, retry holding write latches from the root
+  RemovePessimistic(key, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemovePessimistic(const KeyType &key, Transaction *transaction) {
+  if (transaction == nullptr) {
+    Transaction local_transaction(INVALID_TXN_ID);
+    RemovePessimistic(key, &local_transaction);
+    return;
+  }
+  Page *page = FindLeafPessimistic(key, Operation::DELETE, transaction);
+  if (page == nullptr) {
+    ReleaseLatchFromQueue(transaction, false);
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int old_size = leaf->GetSize();
+  if (leaf->RemoveAndDeleteRecord(key, comparator_) == old_size) {
+    ReleaseLatchFromQueue(transaction, false);
+    return;
+  }
+  CoalesceOrRedistribute(leaf, transaction);
+  ReleaseLatchFromQueue(transaction, true);
+
+  auto deleted_pages = transaction->GetDeletedPageSet();
+  FreePages(std::vector<page_id_t>(deleted_pages->begin(), deleted_pages->end()));
+  deleted_pages->clear();
+  RetryFreePages();
+}
+
+/*
+ * Delete pages that were unlinked from the tree. A reader that fetched one
+ * just before it was unlinked may still hold a pin, in which case DeletePage
+ * fails; such pages are remembered and retried by RetryFreePages.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FreePages(const std::vector<page_id_t> &page_ids) {
+  std::vector<page_id_t> pinned;
+  for (page_id_t page_id : page_ids) {
+    Unswizzle(page_id);
+    if (!buffer_pool_manager_->DeletePage(page_id)) {
+      pinned.push_back(page_id);
+    }
+  }
+  if (!pinned.empty()) {
+    std::scoped_lock lock(pending_free_latch_);
+    pending_free_pages_.insert(pending_free_pages_.end(), pinned.begin(), pinned.end());
+  }
+}
+
+/*
+ * Retry deleting the pages FreePages could not delete, keeping those that are
+ * still pinned. Called after every pessimistic delete and on destruction.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RetryFreePages() {
+  std::scoped_lock lock(pending_free_latch_);
+  auto still_pinned = std::remove_if(pending_free_pages_.begin(), pending_free_pages_.end(),
+                                     [&](page_id_t page_id) { return buffer_pool_manager_->DeletePage(page_id); });
+  pending_free_pages_.erase(still_pinned, pending_free_pages_.end());
+}
+
+/*
+ * User needs to first find the sibling of input page. If the pair fits in one
+ * page (see CanAbsorb), merge. Otherwise, redistribute.
+ * The parent is already write latched by the caller; the sibling is latched
+ * here and recorded in the page set so that it is released with the path.
+ * Pages emptied by a merge are recorded in the deleted page set.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CoalesceOrRedistribute(BPlusTreePage *node, Transaction *transaction) {
+  if (node->IsRootPage()) {
+    AdjustRoot(node, transaction);
+    return;
+  }
+  bool underflow = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->IsUnderflow(min_fill_)
+                                      : reinterpret_cast<InternalPage *>(node)->IsUnderflow(min_fill_);
+  if (!underflow) {
+    return;
+  }
+
+  page_id_t parent_id = node->GetParentPageId();
+  Page *parent_page = FetchTreePage(parent_id);
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  int index = parent->ValueIndex(node->GetPageId());
+  // prefer the left sibling, the leftmost child borrows from / merges with its right sibling
+  int sibling_index = index == 0 ? 1 : index - 1;
+  Page *sibling_page = FetchTreePage(parent->ValueAt(sibling_index));
+  sibling_page->WLatch();
+  transaction->AddIntoPageSet(sibling_page);
+  auto *sibling = reinterpret_cast<BPlusTreePage *>(sibling_page->GetData());
+
+  // always merge the right page of the pair into the left one
+  BPlusTreePage *left = index == 0 ? node : sibling;
+  BPlusTreePage *right = index == 0 ? sibling : node;
+  int right_index = index == 0 ? 1 : index;
+  bool fits = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(left)->CanAbsorb(reinterpret_cast<LeafPage *>(right))
+                                 : reinterpret_cast<InternalPage *>(left)->CanAbsorb(
+                                       reinterpret_cast<InternalPage *>(right), parent->KeyAt(right_index));
+  if (fits) {
+    if (node->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(right)->MoveAllTo(reinterpret_cast<LeafPage *>(left));
+      SetPrevLink(reinterpret_cast<LeafPage *>(left)->GetNextPageId(), left->GetPageId());
+    } else {
+      reinterpret_cast<InternalPage *>(right)->MoveAllTo(reinterpret_cast<InternalPage *>(left),
+                                                         parent->KeyAt(right_index), buffer_pool_manager_);
+    }
+    parent->Remove(right_index);
+    transaction->AddIntoDeletedPageSet(right->GetPageId());
+    CoalesceOrRedistribute(parent, transaction);
+    buffer_pool_manager_->UnpinPage(parent_id, true);
+    return;
+  }
+
+  // moving one entry across changes the separator in the parent and the fence keys of leaves, which for
+  // variable length keys may not fit there, the node is then left underfull
+  int sibling_size = sibling->GetSize();
+  KeyType separator;
+  if (node->IsLeafPage()) {
+    auto *sibling_leaf = reinterpret_cast<LeafPage *>(sibling);
+    separator = index == 0 ? KeyType::ShortestSeparator(sibling_leaf->KeyAt(0), sibling_leaf->KeyAt(1))
+                           : KeyType::ShortestSeparator(sibling_leaf->KeyAt(sibling_size - 2),
+                                                        sibling_leaf->KeyAt(sibling_size - 1));
+  } else {
+    auto *sibling_internal = reinterpret_cast<InternalPage *>(sibling);
+    separator = index == 0 ? sibling_internal->KeyAt(1) : sibling_internal->KeyAt(sibling_size - 1);
+  }
+  bool fence_fits = !node->IsLeafPage() ||
+                    reinterpret_cast<LeafPage *>(node)->CanBorrowFrom(reinterpret_cast<LeafPage *>(sibling));
+  if (!parent->CanSetKeyAt(right_index, separator) || !fence_fits) {
+    buffer_pool_manager_->UnpinPage(parent_id, false);
+    return;
+  }
+
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    auto *sibling_leaf = reinterpret_cast<LeafPage *>(sibling);
+    if (index == 0) {
+      sibling_leaf->MoveFirstToEndOf(leaf);
+    } else {
+      sibling_leaf->MoveLastToFrontOf(leaf);
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    auto *sibling_internal = reinterpret_cast<InternalPage *>(sibling);
+    if (index == 0) {
+      sibling_internal->MoveFirstToEndOf(internal, parent->KeyAt(1), buffer_pool_manager_);
+    } else {
+      sibling_internal->MoveLastToFrontOf(internal, parent->KeyAt(index), buffer_pool_manager_);
+    }
+  }
+  parent->SetKeyAt(right_index, separator);
+  if (left->IsLeafPage()) {
+    reinterpret_cast<LeafPage *>(left)->SetHighKey(separator);
+  } else {
+    reinterpret_cast<InternalPage *>(left)->SetHighKey(separator);
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+}
+
+/*
+ * Rebalancing eagerly at half full makes delete-then-reinsert churn pay for a
+ * merge or a redistribution and then a split, each writing several pages. A
+ * lower min_fill lets pages drain further before they are touched; at 0 a
+ * leaf is only merged away once it is empty. B-link trees never rebalance.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetMinFill(double min_fill) { min_fill_ = std::clamp(min_fill, 0.0, 0.5); }
+
+/*
+ * Offline compaction: copy every entry out of the leaves, free all pages and
+ * bulk load the entries back with pages packed to fill_factor. Reclaims the
+ * sparse pages that relaxed rebalancing (see SetMinFill) or B-link deletes
+ * leave behind.
+ * @return : the number of pages the tree shrank by
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Compact(double fill_factor) -> int {
+  std::vector<page_id_t> old_pages;
+  CollectPages(&old_pages);
+  std::vector<MappingType> entries;
+  for (auto iterator = Begin(); !iterator.IsEnd(); ++iterator) {
+    entries.push_back(*iterator);
+  }
+  FreePages(old_pages);
+  root_page_id_ = INVALID_PAGE_ID;
+  if (entries.empty()) {
+    UpdateRootPageId(0);
+  } else {
+    BulkLoad(&entries, fill_factor);
+  }
+  std::vector<page_id_t> new_pages;
+  CollectPages(&new_pages);
+  return static_cast<int>(old_pages.size()) - static_cast<int>(new_pages.size());
+}
+
+/*
+ * Statistics pass: read the internal levels breadth first, which yields the
+ * height and the ids of all leaves in key order, then sample the leaves.
+ * Only about one page in fanout is internal, so a large tree is summed up
+ * from a small share of its pages. Pages are read latched one at a time.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectStatistics(size_t sample_leaves, IndexStatistics *stats,
+                                       std::vector<std::vector<KeyType>> *sample) {
+  page_id_t root_page_id = GetRootPageId();
+  if (root_page_id == INVALID_PAGE_ID || sample_leaves == 0) {
+    return;
+  }
+  auto is_leaf = [this](page_id_t page_id) {
+    Page *page = FetchTreePage(page_id);
+    bool leaf = reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return leaf;
+  };
+  std::vector<page_id_t> level{root_page_id};
+  stats->height_ = 1;
+  while (!is_leaf(level[0])) {
+    std::vector<page_id_t> children;
+    for (page_id_t page_id : level) {
+      Page *page = FetchTreePage(page_id);
+      page->RLatch();
+      auto *internal = reinterpret_cast<InternalPage *>(page->GetData());
+      for (int i = 0; i < internal->GetSize(); i++) {
+        children.push_back(internal->ValueAt(i));
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    stats->internal_pages_ += level.size();
+    stats->height_++;
+    level = std::move(children);
+  }
+
+  const size_t num_leaves = level.size();
+  const size_t num_samples = std::min(sample_leaves, num_leaves);
+  size_t sampled_entries = 0;
+  double fill = 0;
+  for (size_t i = 0; i < num_samples; i++) {
+    page_id_t page_id = level[i * num_leaves / num_samples];
+    Page *page = FetchTreePage(page_id);
+    page->RLatch();
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    auto &keys = sample->emplace_back();
+    for (int j = 0; j < leaf->GetSize(); j++) {
+      keys.push_back(leaf->KeyAt(j));
+    }
+    sampled_entries += keys.size();
+    fill += leaf->Fill();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  stats->leaf_pages_ = num_leaves;
+  stats->leaf_fill_ = fill / static_cast<double>(num_samples);
+  stats->entries_ =
+      static_cast<double>(sampled_entries) * static_cast<double>(num_leaves) / static_cast<double>(num_samples);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectPages(std::vector<page_id_t> *page_ids) {
+  if (IsEmpty()) {
+    return;
+  }
+  page_ids->push_back(root_page_id_);
+  for (size_t i = 0; i < page_ids->size(); i++) {
+    Page *page = FetchTreePage((*page_ids)[i]);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (!node->IsLeafPage()) {
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      for (int j = 0; j < internal->GetSize(); j++) {
+        page_ids->push_back(internal->ValueAt(j));
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+}
+
+/*
+ * Update root page if necessary
+ * NOTE: size of root page can be less than min size and this method is only
+ * called within CoalesceOrRedistribute() method
+ * case 1: when you delete the last element in root page, but root page still
+ * has one last child
+ * case 2: when you delete the last element in whole b+ tree
+ * Caller must hold the root latch in write mode.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, Transaction *transaction) {
+  if (!old_root_node->IsLeafPage() && old_root_node->GetSize() == 1) {
+    page_id_t child_id = reinterpret_cast<InternalPage *>(old_root_node)->RemoveAndReturnOnlyChild();
+    Page *child_page = FetchTreePage(child_id);
+    reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(child_id, true);
+    root_page_id_ = child_id;
+    UpdateRootPageId(0);
+    transaction->AddIntoDeletedPageSet(old_root_node->GetPageId());
+    return;
+  }
+  if (old_root_node->IsLeafPage() && old_root_node->GetSize() == 0) {
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId(0);
+    transaction->AddIntoDeletedPageSet(old_root_node->GetPageId());
+  }
+}
+
+/*****************************************************************************
+ * B-LINK
+ *****************************************************************************/
+/*
+ * Descend holding at most one latch: read the child pointer under the latch,
+ * release it, then latch the child. A split that happens in between is
+ * detected through the high key and followed through the right link. The
+ * leaf is write latched unless operation is SEARCH.
+ * @return : the latched and pinned leaf page, or nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafBLink(const KeyType &key, Operation operation, std::vector<page_id_t> *path,
+                                   LeafTarget target) -> Page * {
+  page_id_t root_page_id = root_page_id_.load();
+  if (root_page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  bool resident = false;
+  Page *page = FetchUpperPage(root_page_id, &resident);
+  while (true) {
+    // pages never change type in this mode, so peeking before latching is safe
+    bool exclusive = reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage() && operation != Operation::SEARCH;
+    if (exclusive) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+    if (resident && NeedMoveRight(reinterpret_cast<BPlusTreePage *>(page->GetData()), key, target)) {
+      // MoveRight unpins the pages it leaves, pin this one after all
+      FetchTreePage(page->GetPageId());
+      resident = false;
+    }
+    page = MoveRight(page, key, exclusive, target);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    resident = resident || Swizzle(page);
+    page_id_t child_id = ChildFor(reinterpret_cast<InternalPage *>(node), key, target);
+    if (path != nullptr) {
+      path->push_back(page->GetPageId());
+    }
+    page->RUnlatch();
+    if (!resident) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    page = FetchUpperPage(child_id, &resident);
+  }
+}
+
+/*
+ * Whether key lies beyond the high key of node, i.e. in a right sibling. The
+ * leftmost page of a level never needs to move right, the rightmost page is
+ * the one without a right sibling.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NeedMoveRight(BPlusTreePage *node, const KeyType &key, LeafTarget target) -> bool {
+  if (target == LeafTarget::LEFTMOST) {
+    return false;
+  }
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    return leaf->GetNextPageId() != INVALID_PAGE_ID &&
+           (target == LeafTarget::RIGHTMOST || comparator_(key, leaf->GetHighKey()) >= 0);
+  }
+  auto *internal_page = reinterpret_cast<InternalPage *>(node);
+  return internal_page->GetNextPageId() != INVALID_PAGE_ID &&
+         (target == LeafTarget::RIGHTMOST || comparator_(key, internal_page->GetHighKey()) >= 0);
+}
+
+/*
+ * Follow right links from a latched page until key is within its high key.
+ * Readers drop the latch before taking the next one; writers couple left to
+ * right so that a concurrent split of the same level cannot be skipped.
+ * @return : the latched and pinned page covering key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::MoveRight(Page *page, const KeyType &key, bool exclusive, LeafTarget target) -> Page * {
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (NeedMoveRight(node, key, target)) {
+    page_id_t next_page_id = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->GetNextPageId()
+                                                : reinterpret_cast<InternalPage *>(node)->GetNextPageId();
+    Page *next_page = FetchTreePage(next_page_id);
+    if (exclusive) {
+      next_page->WLatch();
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+      next_page->RLatch();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBLink(const KeyType &key, const ValueType &value) -> bool {
+  std::vector<page_id_t> path;
+  Page *page = FindLeafBLink(key, Operation::INSERT, &path);
+  if (page == nullptr) {
+    root_latch_.WLock();
+    if (IsEmpty()) {
+      StartNewTree(key, value);
+      root_latch_.WUnlock();
+      return true;
+    }
+    // lost the race to create the root
+    root_latch_.WUnlock();
+    return InsertBLink(key, value);
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType existing;
+  if (leaf->Lookup(key, &existing, comparator_)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+  leaf->Insert(key, value, comparator_);
+  if (!leaf->IsFull()) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    return true;
+  }
+
+  page_id_t new_page_id;
+  Page *new_page = NewTreePage(&new_page_id);
+  // the new leaf is reachable through the right link once MoveHalfTo returns, keep it latched until its parent
+  // entry is posted so that its parent id is only rewritten under its own latch
+  new_page->WLatch();
+  auto *new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+  new_leaf->Init(new_page_id, leaf->GetParentPageId(), leaf_max_size_);
+  leaf->MoveHalfTo(new_leaf);
+  SetPrevLink(new_leaf->GetNextPageId(), new_page_id);
+  KeyType separator = LeafSeparator(leaf, new_leaf);
+  leaf->SetHighKey(separator);
+  InsertIntoParentBLink(page, separator, new_page, &path);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  return true;
+}
+
+/*
+ * Post the separator for a split page to its parent. old_page and new_page,
+ * its new right sibling, are write latched and are only released once the
+ * parent is latched, so a second split of the same page cannot overtake this
+ * one. Latching the parent while holding them follows the bottom-up, left to
+ * right order of this mode. The parent is the last page on path, or a right
+ * sibling of it if the parent split meanwhile.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParentBLink(Page *old_page, const KeyType &key, Page *new_page,
+                                           std::vector<page_id_t> *path) {
+  page_id_t old_page_id = old_page->GetPageId();
+  auto *new_node = reinterpret_cast<BPlusTreePage *>(new_page->GetData());
+  if (path->empty()) {
+    root_latch_.WLock();
+    if (root_page_id_ == old_page_id) {
+      page_id_t root_id;
+      Page *root_page = NewTreePage(&root_id);
+      auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+      root->Init(root_id, INVALID_PAGE_ID, internal_max_size_);
+      root->PopulateNewRoot(old_page_id, key, new_node->GetPageId());
+      reinterpret_cast<BPlusTreePage *>(old_page->GetData())->SetParentPageId(root_id);
+      new_node->SetParentPageId(root_id);
+      root_page_id_ = root_id;
+      UpdateRootPageId(0);
+      root_latch_.WUnlock();
+      buffer_pool_manager_->UnpinPage(root_id, true);
+      new_page->WUnlatch();
+      old_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(old_page_id, true);
+      return;
+    }
+    // the tree grew above the old root while we were splitting
+    page_id_t root_page_id = root_page_id_;
+    root_latch_.WUnlock();
+    RecoverPathBLink(root_page_id, old_page_id, key, path);
+  }
+
+  page_id_t parent_id = path->back();
+  path->pop_back();
+  Page *parent_page = FetchTreePage(parent_id);
+  parent_page->WLatch();
+  parent_page = MoveRight(parent_page, key, true);
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  BUSTUB_ASSERT(parent->ValueIndex(old_page_id) >= 0, "split page must be a child of the covering parent");
+  new_node->SetParentPageId(parent->GetPageId());
+  new_page->WUnlatch();
+  old_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(old_page_id, true);
+
+  if (!parent->IsFull()) {
+    parent->InsertNodeAfter(old_page_id, key, new_node->GetPageId());
+    parent_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+    return;
+  }
+
+  page_id_t sibling_id;
+  Page *sibling_page = NewTreePage(&sibling_id);
+  // like a split leaf, the sibling stays latched until it is posted to the grandparent
+  sibling_page->WLatch();
+  auto *sibling = reinterpret_cast<InternalPage *>(sibling_page->GetData());
+  sibling->Init(sibling_id, parent->GetParentPageId(), internal_max_size_);
+  parent->InsertAndMoveHalfTo(sibling, old_page_id, key, new_node->GetPageId(), buffer_pool_manager_);
+  InsertIntoParentBLink(parent_page, sibling->KeyAt(0), sibling_page, path);
+  buffer_pool_manager_->UnpinPage(sibling_id, true);
+}
+
+/*
+ * Rebuild the path from the current root down to the internal page that holds
+ * child_id, used when the page that split was the root at descent time.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RecoverPathBLink(page_id_t root_page_id, page_id_t child_id, const KeyType &key,
+                                      std::vector<page_id_t> *path) {
+  Page *page = FetchTreePage(root_page_id);
+  while (true) {
+    page->RLatch();
+    page = MoveRight(page, key, false);
+    auto *internal_page = reinterpret_cast<InternalPage *>(page->GetData());
+    path->push_back(page->GetPageId());
+    page_id_t next_page_id = internal_page->Lookup(key, comparator_);
+    bool found = internal_page->ValueIndex(child_id) >= 0;
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (found) {
+      return;
+    }
+    page = FetchTreePage(next_page_id);
+  }
+}
+
+/*
+ * Remove the key from its leaf without rebalancing, underfull and even empty
+ * leaves stay linked in so that page ids held by readers remain valid.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveBLink(const KeyType &key) {
+  Page *page = FindLeafBLink(key, Operation::DELETE);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int old_size = leaf->GetSize();
+  bool is_dirty = leaf->RemoveAndDeleteRecord(key, comparator_) != old_size;
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -103,7 +1165,16 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  Page *page = mode_ == ConcurrencyMode::B_LINK
+                   ? FindLeafBLink(KeyType{}, Operation::SEARCH, nullptr, LeafTarget::LEFTMOST)
+                   : FindLeaf(KeyType{}, Operation::SEARCH, LeafTarget::LEFTMOST);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
+  }
+  page->RUnlatch();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -111,7 +1182,16 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  Page *page =
+      mode_ == ConcurrencyMode::B_LINK ? FindLeafBLink(key, Operation::SEARCH) : FindLeaf(key, Operation::SEARCH);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, comparator_);
+  page->RUnlatch();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -121,11 +1201,177 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return IN
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
 
+/*
+ * Find the rightmost leaf page and construct an index iterator at its last
+ * entry, to be moved backwards with operator--
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ReverseBegin() -> INDEXITERATOR_TYPE {
+  Page *page = mode_ == ConcurrencyMode::B_LINK
+                   ? FindLeafBLink(KeyType{}, Operation::SEARCH, nullptr, LeafTarget::RIGHTMOST)
+                   : FindLeaf(KeyType{}, Operation::SEARCH, LeafTarget::RIGHTMOST);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->GetSize() - 1;
+  page->RUnlatch();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index, true);
+}
+
+/*
+ * Input parameter is high key, find the leaf page that contains the input key
+ * first, then construct an index iterator at the last entry not greater than
+ * it, to be moved backwards with operator--
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ReverseBegin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  Page *page =
+      mode_ == ConcurrencyMode::B_LINK ? FindLeafBLink(key, Operation::SEARCH) : FindLeaf(key, Operation::SEARCH);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) > 0) {
+    // every entry left of the leaf covering key is less than key, so an index of -1 moves on to them
+    index--;
+  }
+  page->RUnlatch();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index, true);
+}
+
 /**
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  root_latch_.RLock();
+  page_id_t root_page_id = root_page_id_;
+  root_latch_.RUnlock();
+  return root_page_id;
+}
+
+/*
+ * Separator to post between two adjacent leaves: the shortest key that is
+ * greater than everything in left and not greater than anything in right, so
+ * that internal pages and high keys hold truncated keys where the key type
+ * allows it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LeafSeparator(LeafPage *left, LeafPage *right) -> KeyType {
+  return KeyType::ShortestSeparator(left->KeyAt(left->GetSize() - 1), right->KeyAt(0));
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the tree bottom-up instead of inserting entries one by one: sort the
+ * entries, pack them left to right into linked leaves, then build each
+ * internal level from the first keys of the level below. Duplicate keys keep
+ * their first occurrence, like repeated Insert calls would.
+ * @return : false if the tree is not empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<MappingType> *entries, double fill_factor) -> bool {
+  root_latch_.WLock();
+  if (!IsEmpty() || entries->empty()) {
+    root_latch_.WUnlock();
+    return entries->empty();
+  }
+  auto less = [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) < 0; };
+  auto equal = [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) == 0; };
+  if (!std::is_sorted(entries->begin(), entries->end(), less)) {
+    std::stable_sort(entries->begin(), entries->end(), less);
+  }
+  entries->erase(std::unique(entries->begin(), entries->end(), equal), entries->end());
+
+  // (first key, page id) of every node on the level being built
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  LeafPage *prev_leaf = nullptr;
+  LeafPage *leaf = nullptr;
+  for (auto &[key, value] : *entries) {
+    if (leaf == nullptr || leaf->ReachedFillFactor(fill_factor)) {
+      if (prev_leaf != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+      }
+      prev_leaf = leaf;
+      page_id_t page_id;
+      leaf = reinterpret_cast<LeafPage *>(NewTreePage(&page_id)->GetData());
+      leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+      if (prev_leaf != nullptr) {
+        prev_leaf->SetNextPageId(page_id);
+        leaf->SetPrevPageId(prev_leaf->GetPageId());
+        // fence the leaves before the new one fills up, a slotted leaf keeps its low key in its heap
+        KeyType separator = KeyType::ShortestSeparator(prev_leaf->KeyAt(prev_leaf->GetSize() - 1), key);
+        prev_leaf->SetHighKey(separator);
+        leaf->SetLowKey(separator);
+      }
+      level.emplace_back(key, page_id);
+    }
+    leaf->Insert(key, value, comparator_);
+  }
+  if (prev_leaf != nullptr) {
+    // top up the last leaf from its left neighbour, which was filled past half
+    while (leaf->IsUnderflow() && prev_leaf->IsDeleteSafe()) {
+      prev_leaf->MoveLastToFrontOf(leaf);
+    }
+    buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+  // post truncated separators now that the contents of every leaf are final
+  for (size_t i = 1; i < level.size(); i++) {
+    auto *left = reinterpret_cast<LeafPage *>(FetchTreePage(level[i - 1].second)->GetData());
+    auto *right = reinterpret_cast<LeafPage *>(FetchTreePage(level[i].second)->GetData());
+    level[i].first = LeafSeparator(left, right);
+    left->SetHighKey(level[i].first);
+    buffer_pool_manager_->UnpinPage(level[i].second, false);
+    buffer_pool_manager_->UnpinPage(level[i - 1].second, true);
+  }
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    InternalPage *prev_node = nullptr;
+    InternalPage *node = nullptr;
+    for (auto &[key, child_id] : level) {
+      if (node == nullptr || node->ReachedFillFactor(fill_factor)) {
+        if (prev_node != nullptr) {
+          buffer_pool_manager_->UnpinPage(prev_node->GetPageId(), true);
+        }
+        prev_node = node;
+        page_id_t page_id;
+        node = reinterpret_cast<InternalPage *>(NewTreePage(&page_id)->GetData());
+        node->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+        if (prev_node != nullptr) {
+          prev_node->SetNextPageId(page_id);
+          prev_node->SetHighKey(key);
+        }
+        parents.emplace_back(key, page_id);
+      }
+      node->Append(key, child_id);
+      auto *child_node = reinterpret_cast<BPlusTreePage *>(FetchTreePage(child_id)->GetData());
+      child_node->SetParentPageId(node->GetPageId());
+      buffer_pool_manager_->UnpinPage(child_id, true);
+    }
+    if (prev_node != nullptr) {
+      while (node->IsUnderflow() && prev_node->IsDeleteSafe()) {
+        prev_node->MoveLastToFrontOf(node, parents.back().first, buffer_pool_manager_);
+        parents.back().first = node->KeyAt(0);
+      }
+      prev_node->SetHighKey(parents.back().first);
+      buffer_pool_manager_->UnpinPage(prev_node->GetPageId(), true);
+    }
+    buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
+    level = std::move(parents);
+  }
+
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
+  return true;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -141,16 +1387,40 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
+  // the header page is shared by every index
+  header_page->WLatch();
+  // a tree that was emptied and regrown already owns a record
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
+  header_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
+/*
+ * Pin the internal pages descents pass in the buffer pool, up to max_pages of
+ * them, and resolve them through swizzled frame pointers from then on. The
+ * root and the levels below it are read by every descent, so they fill the
+ * budget first. Pages stay resident until they are freed or this is called
+ * with 0, which unpins all of them.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetResidentUpperLevels(size_t max_pages) {
+  if (swizzle_table_ != nullptr) {
+    swizzle_table_->ForEach([&](page_id_t page_id) { buffer_pool_manager_->UnpinPage(page_id, false); });
+    swizzle_table_.reset();
+  }
+  if (max_pages > 0) {
+    swizzle_table_ = std::make_unique<SwizzleTable>(max_pages);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetResidentPageCount() -> size_t {
+  return swizzle_table_ == nullptr ? 0 : swizzle_table_->Size();
+}
+
 /*
  * This method is used for test only
  * Read data from file and insert one by one
@@ -344,5 +1614,22 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTree<IntegerKey<int32_t>, RID, IntegerKeyComparator<int32_t>>;
+template class BPlusTree<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+template class BPlusTree<VarKey, RID, VarKeyComparator>;
+template class BPlusTree<NonUniqueKey<GenericKey<4>>, RID, NonUniqueComparator<GenericComparator<4>>>;
+template class BPlusTree<NonUniqueKey<GenericKey<8>>, RID, NonUniqueComparator<GenericComparator<8>>>;
+template class BPlusTree<NonUniqueKey<GenericKey<16>>, RID, NonUniqueComparator<GenericComparator<16>>>;
+template class BPlusTree<NonUniqueKey<GenericKey<32>>, RID, NonUniqueComparator<GenericComparator<32>>>;
+template class BPlusTree<NonUniqueKey<GenericKey<64>>, RID, NonUniqueComparator<GenericComparator<64>>>;
+template class BPlusTree<NonUniqueKey<IntegerKey<int32_t>>, RID, NonUniqueComparator<IntegerKeyComparator<int32_t>>>;
+template class BPlusTree<NonUniqueKey<IntegerKey<int64_t>>, RID, NonUniqueComparator<IntegerKeyComparator<int64_t>>>;
+template class BPlusTree<VarKey, RID, NonUniqueComparator<VarKeyComparator>>;
+template class BPlusTree<GenericKey<16>, RID, CoveringComparator<GenericComparator<16>>>;
+template class BPlusTree<NonUniqueKey<GenericKey<16>>, RID,
+                         NonUniqueComparator<CoveringComparator<GenericComparator<16>>>>;
+template class BPlusTree<GenericKey<64>, RID, CoveringComparator<GenericComparator<64>>>;
+template class BPlusTree<NonUniqueKey<GenericKey<64>>, RID,
+                         NonUniqueComparator<CoveringComparator<GenericComparator<64>>>>;
 
 }  // namespace bustub
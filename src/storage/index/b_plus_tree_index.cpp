@@ -11,6 +11,8 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+
 namespace bustub {
 /*
  * Constructor
@@ -19,33 +21,259 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_),
+      adaptive_hash_(comparator_) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
-
-  container_.Insert(index_key, rid, transaction);
+  container_.Insert(MakeKey(key, rid), rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
-
+  // construct delete index key, which picks out this rid among equal keys
+  KeyType index_key = MakeKey(key, rid);
   container_.Remove(index_key, transaction);
+  if constexpr (SUPPORTS_ADAPTIVE_HASH) {
+    if (adaptive_hash_enabled_) {
+      adaptive_hash_.Invalidate(index_key);
+    }
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
-  // construct scan index key
+  // construct scan index key, the default rid sorts before every entry with an equal key
+  KeyType index_key = MakeSearchKey(key, RID());
+
+  if constexpr (SUPPORTS_ADAPTIVE_HASH) {
+    if (adaptive_hash_enabled_) {
+      ValueType value;
+      if (adaptive_hash_.Lookup(index_key, &value)) {
+        result->push_back(value);
+        return;
+      }
+      // hash the leaf the lookup ends in once it turns out to be hot
+      page_id_t leaf_page_id = INVALID_PAGE_ID;
+      container_.GetValue(index_key, result, transaction, &leaf_page_id);
+      if (leaf_page_id != INVALID_PAGE_ID && adaptive_hash_.RecordLeafAccess(leaf_page_id)) {
+        uint64_t epoch = adaptive_hash_.GetEpoch();
+        std::vector<std::pair<KeyType, ValueType>> entries;
+        container_.GetLeafEntries(index_key, &entries);
+        adaptive_hash_.AddLeaf(entries, epoch);
+      }
+      return;
+    }
+  }
+  if constexpr (IS_UNIQUE) {
+    container_.GetValue(index_key, result, transaction);
+  } else {
+    // duplicates are adjacent in the leaves, walk them from the first one on
+    for (auto iter = container_.Begin(index_key); !iter.IsEnd(); ++iter) {
+      if (comparator_.CompareKey((*iter).first, index_key) != 0) {
+        break;
+      }
+      result->push_back((*iter).second);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids,
+                                         Transaction *transaction) {
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  entries.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    entries.emplace_back(MakeKey(keys[i], rids[i]), rids[i]);
+  }
+  container_.InsertBatch(&entries, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  if constexpr (IS_UNIQUE) {
+    std::vector<KeyType> index_keys;
+    index_keys.reserve(keys.size());
+    for (const auto &key : keys) {
+      index_keys.push_back(MakeSearchKey(key, RID()));
+    }
+    container_.GetValueBatch(index_keys, results, transaction);
+  } else {
+    // every key is a range of duplicates, which ScanKey walks with an iterator
+    Index::ScanKeys(keys, results, transaction);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                     bool high_inclusive, bool reverse, std::vector<RID> *result,
+                                     __attribute__((unused)) Transaction *transaction) {
+  ForEachInRange(low_key, low_inclusive, high_key, high_inclusive, reverse,
+                 [result](const KeyType &key, const RID &rid) { result->push_back(rid); });
+}
+
+/*
+ * The entry columns are decoded from the stored keys, which hold them in full
+ * for covering indexes (the catalog makes sure they fit).
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanRangeEntries(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                            bool high_inclusive, bool reverse, std::vector<Tuple> *result,
+                                            __attribute__((unused)) Transaction *transaction) {
+  Schema *entry_schema = GetEntrySchema();
+  ForEachInRange(low_key, low_inclusive, high_key, high_inclusive, reverse,
+                 [result, entry_schema](const KeyType &key, const RID &rid) {
+                   std::vector<Value> values;
+                   values.reserve(entry_schema->GetColumnCount());
+                   for (uint32_t i = 0; i < entry_schema->GetColumnCount(); i++) {
+                     values.push_back(key.ToValue(entry_schema, i));
+                   }
+                   result->emplace_back(values, entry_schema);
+                   result->back().SetRid(rid);
+                 });
+}
+
+/*
+ * Distinct keys are counted on the whole key, the histogram only covers the
+ * first key column.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::CollectStatistics(IndexStatistics *stats, __attribute__((unused)) Transaction *transaction)
+    -> bool {
+  std::vector<std::vector<KeyType>> sample;
+  container_.CollectStatistics(IndexStatistics::SAMPLE_LEAVES, stats, &sample);
+  Schema *entry_schema = GetEntrySchema();
+  std::vector<std::vector<Value>> leaves;
+  size_t pairs = 0;
+  size_t changes = 0;
+  for (const auto &keys : sample) {
+    auto &values = leaves.emplace_back();
+    for (size_t i = 0; i < keys.size(); i++) {
+      values.push_back(keys[i].ToValue(entry_schema, 0));
+      if (i > 0) {
+        pairs++;
+        changes += CompareKeys(keys[i - 1], keys[i]) == 0 ? 0 : 1;
+      }
+    }
+  }
+  stats->distinct_keys_ = IndexStatistics::EstimateDistinct(stats->entries_, pairs, changes);
+  stats->BuildHistogram(leaves, IndexStatistics::HISTOGRAM_BUCKETS);
+  return true;
+}
+
+/*
+ * Non-unique indexes probe excluded bounds with a rid past all their duplicates, so that the iterator starts behind
+ * them. Unique indexes start at an excluded bound itself, which is skipped.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template <typename Emit>
+void BPLUSTREE_INDEX_TYPE::ForEachInRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                          bool high_inclusive, bool reverse, Emit &&emit) {
+  KeyType low;
+  KeyType high;
+  if (low_key != nullptr) {
+    low = MakeSearchKey(*low_key, low_inclusive ? RID() : LAST_RID);
+  }
+  if (high_key != nullptr) {
+    high = MakeSearchKey(*high_key, high_inclusive ? LAST_RID : RID());
+  }
+  auto below_low = [&](const KeyType &key) {
+    int cmp = CompareKeys(key, low);
+    return low_key != nullptr && (cmp < 0 || (cmp == 0 && !low_inclusive));
+  };
+  auto above_high = [&](const KeyType &key) {
+    int cmp = CompareKeys(key, high);
+    return high_key != nullptr && (cmp > 0 || (cmp == 0 && !high_inclusive));
+  };
+
+  if (!reverse) {
+    auto iter = low_key == nullptr ? container_.Begin() : container_.Begin(low);
+    iter.EnablePrefetch();
+    for (; !iter.IsEnd(); ++iter) {
+      const auto &[key, rid] = *iter;
+      if (above_high(key)) {
+        break;
+      }
+      if (!below_low(key)) {
+        emit(key, rid);
+      }
+    }
+    return;
+  }
+  auto iter = high_key == nullptr ? container_.ReverseBegin() : container_.ReverseBegin(high);
+  iter.EnablePrefetch();
+  for (; !iter.IsEnd(); --iter) {
+    const auto &[key, rid] = *iter;
+    if (below_low(key)) {
+      break;
+    }
+    if (!above_high(key)) {
+      emit(key, rid);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::SetAdaptiveHashIndex(bool enabled) -> bool {
+  if constexpr (!SUPPORTS_ADAPTIVE_HASH) {
+    return !enabled;
+  }
+  adaptive_hash_enabled_ = enabled;
+  if (!enabled) {
+    adaptive_hash_.Clear();
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetAdaptiveHashIndexStats() -> AdaptiveHashIndexStats { return adaptive_hash_.GetStats(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::CompareKeys(const KeyType &lhs, const KeyType &rhs) const -> int {
+  if constexpr (IS_UNIQUE) {
+    return comparator_(lhs, rhs);
+  } else {
+    return comparator_.CompareKey(lhs, rhs);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeKey(const Tuple &key, __attribute__((unused)) RID rid) const -> KeyType {
+  KeyType index_key;
+  index_key.SetFromKey(key, GetEntrySchema());
+  if constexpr (!IS_UNIQUE) {
+    index_key.SetRid(rid);
+  }
+  return index_key;
+}
+
+/*
+ * The key columns lead the encoding of an entry, so a key without the
+ * included columns orders like every entry with that key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeSearchKey(const Tuple &key, __attribute__((unused)) RID rid) const -> KeyType {
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
+  if constexpr (!IS_UNIQUE) {
+    index_key.SetRid(rid);
+  }
+  return index_key;
+}
 
-  container_.GetValue(index_key, result, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<EntryType> *entries, double fill_factor) -> bool {
+  // reject duplicates before the tree allocates any page, BPlusTree::BulkLoad would only drop them
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const auto &left, const auto &right) { return comparator_(left.first, right.first) < 0; });
+  if (std::adjacent_find(entries->begin(), entries->end(), [this](const auto &left, const auto &right) {
+        return comparator_(left.first, right.first) == 0;
+      }) != entries->end()) {
+    return false;
+  }
+  return container_.BulkLoad(entries, fill_factor);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -62,5 +290,24 @@ template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<IntegerKey<int32_t>, RID, IntegerKeyComparator<int32_t>>;
+template class BPlusTreeIndex<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+template class BPlusTreeIndex<VarKey, RID, VarKeyComparator>;
+template class BPlusTreeIndex<NonUniqueKey<GenericKey<4>>, RID, NonUniqueComparator<GenericComparator<4>>>;
+template class BPlusTreeIndex<NonUniqueKey<GenericKey<8>>, RID, NonUniqueComparator<GenericComparator<8>>>;
+template class BPlusTreeIndex<NonUniqueKey<GenericKey<16>>, RID, NonUniqueComparator<GenericComparator<16>>>;
+template class BPlusTreeIndex<NonUniqueKey<GenericKey<32>>, RID, NonUniqueComparator<GenericComparator<32>>>;
+template class BPlusTreeIndex<NonUniqueKey<GenericKey<64>>, RID, NonUniqueComparator<GenericComparator<64>>>;
+template class BPlusTreeIndex<NonUniqueKey<IntegerKey<int32_t>>, RID,
+                              NonUniqueComparator<IntegerKeyComparator<int32_t>>>;
+template class BPlusTreeIndex<NonUniqueKey<IntegerKey<int64_t>>, RID,
+                              NonUniqueComparator<IntegerKeyComparator<int64_t>>>;
+template class BPlusTreeIndex<VarKey, RID, NonUniqueComparator<VarKeyComparator>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, CoveringComparator<GenericComparator<16>>>;
+template class BPlusTreeIndex<NonUniqueKey<GenericKey<16>>, RID,
+                              NonUniqueComparator<CoveringComparator<GenericComparator<16>>>>;
+template class BPlusTreeIndex<GenericKey<64>, RID, CoveringComparator<GenericComparator<64>>>;
+template class BPlusTreeIndex<NonUniqueKey<GenericKey<64>>, RID,
+                              NonUniqueComparator<CoveringComparator<GenericComparator<64>>>>;
 
 }  // namespace bustub
@@ -1,7 +1,9 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
+#include <thread>  // NOLINT
 
 #include "storage/index/index_iterator.h"
 
@@ -15,16 +17,153 @@ INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index, bool reverse)
+    : buffer_pool_manager_(buffer_pool_manager), page_(page), index_(index) {
+  if (reverse) {
+    SkipExhaustedLeavesBackward();
+  } else {
+    SkipExhaustedLeaves();
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_),
+      page_(other.page_),
+      index_(other.index_),
+      item_(other.item_),
+      prefetch_(other.prefetch_) {
+  other.page_ = nullptr;
+  other.index_ = 0;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> INDEXITERATOR_TYPE & {
+  if (this != &other) {
+    if (page_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    }
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    page_ = other.page_;
+    index_ = other.index_;
+    item_ = other.item_;
+    prefetch_ = other.prefetch_;
+    other.page_ = nullptr;
+    other.index_ = 0;
+  }
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE::~IndexIterator() {  // NOLINT
+  if (page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_ == nullptr; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  page_->RLatch();
+  item_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page_->GetData())->GetItem(index_);
+  page_->RUnlatch();
+  return item_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  index_++;
+  SkipExhaustedLeaves();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator--() -> INDEXITERATOR_TYPE & {
+  index_--;
+  SkipExhaustedLeavesBackward();
+  return *this;
+}
+
+/*
+ * Read-ahead starts with the next leaf the iterator enters, so that scans that
+ * stay within one or two leaves do not pay for it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::EnablePrefetch() { prefetch_ = true; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  bool entered = false;
+  while (page_ != nullptr) {
+    page_->RLatch();
+    auto *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page_->GetData());
+    if (entered && prefetch_) {
+      Prefetch(leaf->GetNextPageId());
+    }
+    if (index_ < leaf->GetSize()) {
+      page_->RUnlatch();
+      return;
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    index_ = 0;
+    page_ = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+    entered = true;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeavesBackward() {
+  bool entered = false;
+  while (page_ != nullptr) {
+    page_->RLatch();
+    auto *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page_->GetData());
+    if (entered && prefetch_) {
+      Prefetch(leaf->GetPrevPageId());
+    }
+    // entries may have been removed since the index was taken
+    index_ = std::min(index_, leaf->GetSize() - 1);
+    if (index_ >= 0) {
+      page_->RUnlatch();
+      return;
+    }
+    page_id_t prev_page_id = leaf->GetPrevPageId();
+    Page *prev_page = prev_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(prev_page_id);
+    if (prev_page == nullptr) {
+      page_->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+      page_ = nullptr;
+      return;
+    }
+    if (!prev_page->TryRLatch()) {
+      // a writer holding the left neighbour may be waiting for this leaf
+      page_->RUnlatch();
+      buffer_pool_manager_->UnpinPage(prev_page_id, false);
+      std::this_thread::yield();
+      continue;
+    }
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = prev_page;
+    index_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page_->GetData())->GetSize() - 1;
+    page_->RUnlatch();
+    entered = true;
+  }
+}
+
+/*
+ * Queue page_id with the prefetch thread of the buffer pool, which reads it in
+ * without pinning it, the iterator fetches it as usual once it gets there.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Prefetch(page_id_t page_id) {
+  if (page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager_->PrefetchPage(page_id);
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -36,4 +175,38 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<IntegerKey<int32_t>, RID, IntegerKeyComparator<int32_t>>;
+
+template class IndexIterator<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+
+template class IndexIterator<VarKey, RID, VarKeyComparator>;
+
+template class IndexIterator<NonUniqueKey<GenericKey<4>>, RID, NonUniqueComparator<GenericComparator<4>>>;
+
+template class IndexIterator<NonUniqueKey<GenericKey<8>>, RID, NonUniqueComparator<GenericComparator<8>>>;
+
+template class IndexIterator<NonUniqueKey<GenericKey<16>>, RID, NonUniqueComparator<GenericComparator<16>>>;
+
+template class IndexIterator<NonUniqueKey<GenericKey<32>>, RID, NonUniqueComparator<GenericComparator<32>>>;
+
+template class IndexIterator<NonUniqueKey<GenericKey<64>>, RID, NonUniqueComparator<GenericComparator<64>>>;
+
+template class IndexIterator<NonUniqueKey<IntegerKey<int32_t>>, RID,
+                             NonUniqueComparator<IntegerKeyComparator<int32_t>>>;
+
+template class IndexIterator<NonUniqueKey<IntegerKey<int64_t>>, RID,
+                             NonUniqueComparator<IntegerKeyComparator<int64_t>>>;
+
+template class IndexIterator<VarKey, RID, NonUniqueComparator<VarKeyComparator>>;
+
+template class IndexIterator<GenericKey<16>, RID, CoveringComparator<GenericComparator<16>>>;
+
+template class IndexIterator<NonUniqueKey<GenericKey<16>>, RID,
+                             NonUniqueComparator<CoveringComparator<GenericComparator<16>>>>;
+
+template class IndexIterator<GenericKey<64>, RID, CoveringComparator<GenericComparator<64>>>;
+
+template class IndexIterator<NonUniqueKey<GenericKey<64>>, RID,
+                             NonUniqueComparator<CoveringComparator<GenericComparator<64>>>>;
+
 }  // namespace bustub
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_statistics.cpp
+//
+// Identification: src/storage/index/index_statistics.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_statistics.h"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+namespace {
+
+auto IsEqual(const Value &left, const Value &right) -> bool { return left.CompareEquals(right) == CmpBool::CmpTrue; }
+
+auto IsLess(const Value &left, const Value &right) -> bool { return left.CompareLessThan(right) == CmpBool::CmpTrue; }
+
+/** @return whether value is a number, which then goes to result */
+auto AsDouble(const Value &value, double *result) -> bool {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      *result = value.GetAs<int8_t>();
+      return true;
+    case TypeId::SMALLINT:
+      *result = value.GetAs<int16_t>();
+      return true;
+    case TypeId::INTEGER:
+      *result = value.GetAs<int32_t>();
+      return true;
+    case TypeId::BIGINT:
+      *result = static_cast<double>(value.GetAs<int64_t>());
+      return true;
+    case TypeId::DECIMAL:
+      *result = value.GetAs<double>();
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @return the share of the entries of bucket within [low, high], where the bucket starts at bucket_low, inclusive
+ * for the first bucket only
+ */
+auto Overlap(const HistogramBucket &bucket, const Value &bucket_low, bool first, const Value *low, const Value *high)
+    -> double {
+  if ((low != nullptr && IsLess(bucket.upper_, *low)) ||
+      (high != nullptr && (first ? IsLess(*high, bucket_low) : !IsLess(bucket_low, *high)))) {
+    return 0;
+  }
+  bool covers_low = low == nullptr || !IsLess(bucket_low, *low);
+  bool covers_high = high == nullptr || !IsLess(*high, bucket.upper_);
+  if (covers_low && covers_high) {
+    return 1;
+  }
+  // interpolate between the bounds of the bucket where they are numbers, and count at least one value
+  double fraction = 0.5;
+  double from = 0;
+  double to = 0;
+  double range_low = 0;
+  double range_high = 0;
+  if (AsDouble(bucket_low, &from) && AsDouble(bucket.upper_, &to) && to > from &&
+      (covers_low || AsDouble(*low, &range_low)) && (covers_high || AsDouble(*high, &range_high))) {
+    range_low = covers_low ? from : range_low;
+    range_high = covers_high ? to : range_high;
+    fraction = std::clamp((range_high - range_low) / (to - from), 0.0, 1.0);
+  }
+  return std::max(fraction, 1 / std::max(bucket.distinct_, 1.0));
+}
+
+}  // namespace
+
+auto IndexStatistics::EstimateDistinct(double entries, size_t pairs, size_t changes) -> double {
+  if (entries <= 0 || pairs == 0) {
+    return std::max(entries, 0.0);
+  }
+  return std::max(1.0, 1 + (entries - 1) * static_cast<double>(changes) / static_cast<double>(pairs));
+}
+
+/*
+ * Buckets get about the same number of sampled entries, except that equal
+ * values never straddle two buckets, so a frequent value may fill a bucket
+ * of its own.
+ */
+void IndexStatistics::BuildHistogram(const std::vector<std::vector<Value>> &leaves, size_t num_buckets) {
+  histogram_.clear();
+  // whether values[i] follows values[i - 1] on the same leaf, only such neighbours are adjacent in the index
+  std::vector<const Value *> values;
+  std::vector<bool> same_leaf;
+  for (const auto &leaf : leaves) {
+    for (size_t i = 0; i < leaf.size(); i++) {
+      values.push_back(&leaf[i]);
+      same_leaf.push_back(i > 0);
+    }
+  }
+  if (values.empty() || num_buckets == 0) {
+    return;
+  }
+  lowest_ = *values[0];
+  const size_t n = values.size();
+  const double scale = entries_ / static_cast<double>(n);
+  num_buckets = std::min(num_buckets, n);
+  for (size_t begin = 0, bucket = 0; begin < n; bucket++) {
+    // the entries left are spread evenly over the buckets left
+    size_t end = bucket + 1 >= num_buckets ? n : begin + std::max<size_t>(1, (n - begin) / (num_buckets - bucket));
+    while (end < n && IsEqual(*values[end], *values[end - 1])) {
+      end++;
+    }
+    size_t pairs = 0;
+    size_t changes = 0;
+    for (size_t i = begin + 1; i < end; i++) {
+      if (same_leaf[i]) {
+        pairs++;
+        changes += IsEqual(*values[i], *values[i - 1]) ? 0 : 1;
+      }
+    }
+    double count = static_cast<double>(end - begin) * scale;
+    histogram_.push_back({*values[end - 1], count, EstimateDistinct(count, pairs, changes)});
+    begin = end;
+  }
+}
+
+auto IndexStatistics::EstimateEqual(const Value &value) const -> double {
+  if (histogram_.empty() || IsLess(value, lowest_)) {
+    return 0;
+  }
+  for (const auto &bucket : histogram_) {
+    if (!IsLess(bucket.upper_, value)) {
+      return bucket.count_ / std::max(bucket.distinct_, 1.0);
+    }
+  }
+  return 0;
+}
+
+auto IndexStatistics::EstimateRange(const Value *low, const Value *high) const -> double {
+  double estimate = 0;
+  const Value *bucket_low = &lowest_;
+  for (size_t i = 0; i < histogram_.size(); i++) {
+    estimate += histogram_[i].count_ * Overlap(histogram_[i], *bucket_low, i == 0, low, high);
+    bucket_low = &histogram_[i].upper_;
+  }
+  return estimate;
+}
+
+auto IndexStatistics::ToString() const -> std::string {
+  std::vector<std::string> bounds;
+  if (!histogram_.empty()) {
+    bounds.push_back(lowest_.ToString());
+  }
+  for (const auto &bucket : histogram_) {
+    bounds.push_back(bucket.upper_.ToString());
+  }
+  return fmt::format(
+      "{{ height={}, internal_pages={}, leaf_pages={}, leaf_fill={:.2f}, entries={:.0f}, distinct_keys={:.0f}, "
+      "histogram=[{}] }}",
+      height_, internal_pages_, leaf_pages_, leaf_fill_, entries_, distinct_keys_, fmt::join(bounds, ", "));
+}
+
+}  // namespace bustub
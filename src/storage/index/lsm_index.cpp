@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_index.cpp
+//
+// Identification: src/storage/index/lsm_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/lsm_index.h"
+
+namespace bustub {
+
+LSMIndex::LSMIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+    : NormalizedKeyIndex(std::move(metadata)), tree_(buffer_pool_manager) {}
+
+/*
+ * The keys of a non-unique index include the RID, so only a unique index has to
+ * look for the key before writing, at the cost of a read on every insert.
+ */
+void LSMIndex::InsertKey(const std::string &key, RID rid) {
+  if (GetMetadata()->IsUnique()) {
+    tree_.Insert(key, rid);
+  } else {
+    tree_.Put(key, rid);
+  }
+}
+
+void LSMIndex::RemoveKey(const std::string &key) { tree_.Remove(key); }
+
+auto LSMIndex::LookupKey(const std::string &key, RID *rid) const -> bool { return tree_.Lookup(key, rid); }
+
+void LSMIndex::ScanKeys(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                        const std::function<void(const std::string &, RID)> &emit) const {
+  tree_.Scan(low, low_inclusive, high, high_inclusive, emit);
+}
+
+}  // namespace bustub
@@ -0,0 +1,673 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree.cpp
+//
+// Identification: src/storage/index/lsm_tree.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/lsm_tree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <random>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/page/lsm_run_page.h"
+
+namespace bustub {
+
+namespace {
+
+auto FetchRunPage(BufferPoolManager *buffer_pool_manager, page_id_t page_id) -> const LSMRunPage * {
+  Page *page = buffer_pool_manager->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch lsm run page, all frames are pinned");
+  }
+  return reinterpret_cast<const LSMRunPage *>(page->GetData());
+}
+
+// bloom filters take 10 bits per key and 7 probes, for a false positive rate of about 1%
+constexpr size_t BLOOM_BITS_PER_KEY = 10;
+constexpr size_t BLOOM_PROBES = 7;
+
+auto BloomHash(std::string_view key) -> uint64_t { return std::hash<std::string_view>{}(key); }
+
+/* Double hashing: probe i sets bit h1 + i * h2, h2 being the hash rotated */
+template <typename Probe>
+void ForEachBloomBit(uint64_t hash, size_t num_bits, Probe &&probe) {
+  uint64_t delta = (hash >> 33) | (hash << 31) | 1;
+  for (size_t i = 0; i < BLOOM_PROBES; i++) {
+    probe(hash % num_bits);
+    hash += delta;
+  }
+}
+
+}  // namespace
+
+/*****************************************************************************
+ * MEMTABLE
+ *****************************************************************************/
+/**
+ * Skiplist of entries ordered by key, and newest first among the entries of a
+ * key. There is one writer at a time, readers run alongside it without any
+ * latch: a node is fully built before it is linked in, bottom level first, with
+ * release stores that readers pair with acquire loads.
+ */
+class LSMTree::MemTable {
+ public:
+  struct Node {
+    Node(std::string_view key, uint64_t sequence, bool tombstone, RID value, int height)
+        : key_(key), sequence_(sequence), tombstone_(tombstone), value_(value), next_(new std::atomic<Node *>[height]) {
+      for (int i = 0; i < height; i++) {
+        next_[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    auto Next(int level) const -> Node * { return next_[level].load(std::memory_order_acquire); }
+
+    std::string key_;
+    uint64_t sequence_;
+    bool tombstone_;
+    RID value_;
+    std::unique_ptr<std::atomic<Node *>[]> next_;
+  };
+
+  MemTable() : head_(new Node({}, 0, false, RID(), MAX_HEIGHT)) {}
+
+  ~MemTable() {
+    Node *node = head_;
+    while (node != nullptr) {
+      Node *next = node->Next(0);
+      delete node;
+      node = next;
+    }
+  }
+
+  MemTable(const MemTable &) = delete;
+  auto operator=(const MemTable &) -> MemTable & = delete;
+
+  /** Only one thread may add at a time */
+  void Add(std::string_view key, uint64_t sequence, bool tombstone, RID value) {
+    Node *prev[MAX_HEIGHT];
+    FindGreaterOrEqual(key, sequence, prev);
+    int height = 1;
+    while (height < MAX_HEIGHT && rng_() % BRANCHING == 0) {
+      height++;
+    }
+    int current_height = height_.load(std::memory_order_relaxed);
+    if (height > current_height) {
+      for (int i = current_height; i < height; i++) {
+        prev[i] = head_;
+      }
+      // readers that see the new height before the links find null pointers up there, which is fine
+      height_.store(height, std::memory_order_relaxed);
+    }
+    auto *node = new Node(key, sequence, tombstone, value, height);
+    for (int i = 0; i < height; i++) {
+      node->next_[i].store(prev[i]->next_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      prev[i]->next_[i].store(node, std::memory_order_release);
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(sizeof(Node) + key.size() + height * sizeof(Node *), std::memory_order_relaxed);
+    visible_sequence_.store(sequence + 1, std::memory_order_release);
+  }
+
+  /** @return the newest entry of a key not less than key, nullptr if there is none */
+  auto Seek(std::string_view key) const -> const Node * {
+    return FindGreaterOrEqual(key, std::numeric_limits<uint64_t>::max(), nullptr);
+  }
+
+  auto First() const -> const Node * { return head_->Next(0); }
+
+  auto Empty() const -> bool { return size_.load(std::memory_order_relaxed) == 0; }
+
+  auto ApproximateBytes() const -> size_t { return bytes_.load(std::memory_order_relaxed); }
+
+  /** @return the sequence below which every entry added so far lies, entries added later are at or above it */
+  auto VisibleSequence() const -> uint64_t { return visible_sequence_.load(std::memory_order_acquire); }
+
+ private:
+  static constexpr int MAX_HEIGHT = 12;
+  static constexpr uint32_t BRANCHING = 4;
+
+  /** @return the first node at or after (key, sequence), with its predecessor on every level going to prev */
+  auto FindGreaterOrEqual(std::string_view key, uint64_t sequence, Node **prev) const -> Node * {
+    Node *node = head_;
+    int level = height_.load(std::memory_order_relaxed) - 1;
+    while (true) {
+      Node *next = node->Next(level);
+      if (next != nullptr && (next->key_ < key || (next->key_ == key && next->sequence_ > sequence))) {
+        node = next;
+        continue;
+      }
+      if (prev != nullptr) {
+        prev[level] = node;
+      }
+      if (level == 0) {
+        return next;
+      }
+      level--;
+    }
+  }
+
+  Node *head_;
+  std::atomic<int> height_{1};
+  std::atomic<size_t> size_{0};
+  std::atomic<size_t> bytes_{0};
+  std::atomic<uint64_t> visible_sequence_{0};
+  std::mt19937 rng_{15445};
+};
+
+/*****************************************************************************
+ * SORTED RUNS
+ *****************************************************************************/
+/** An immutable sorted run, its pages are given back to the buffer pool once it is dropped */
+struct LSMTree::Run {
+  explicit Run(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+  ~Run() {
+    for (auto page_id : pages_) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+  }
+
+  Run(const Run &) = delete;
+  auto operator=(const Run &) -> Run & = delete;
+
+  /** @return the page that holds key if any does, the first one for keys before the run */
+  auto FindPage(std::string_view key) const -> size_t {
+    auto it = std::upper_bound(fences_.begin(), fences_.end(), key,
+                               [](std::string_view key, const std::string &fence) { return key < fence; });
+    return it == fences_.begin() ? 0 : it - fences_.begin() - 1;
+  }
+
+  auto MayContain(std::string_view key) const -> bool {
+    if (key < fences_.front() || key > last_key_) {
+      return false;
+    }
+    bool contained = true;
+    ForEachBloomBit(BloomHash(key), bloom_.size() * 64, [this, &contained](size_t bit) {
+      contained = contained && ((bloom_[bit / 64] >> (bit % 64)) & 1) != 0;
+    });
+    return contained;
+  }
+
+  BufferPoolManager *buffer_pool_manager_;
+  std::vector<page_id_t> pages_;
+  // the first key of every page
+  std::vector<std::string> fences_;
+  std::string last_key_;
+  std::vector<uint64_t> bloom_;
+  size_t size_{0};
+};
+
+/** Fills the pages of a new run with entries in key order */
+class LSMTree::RunBuilder {
+ public:
+  explicit RunBuilder(BufferPoolManager *buffer_pool_manager)
+      : buffer_pool_manager_(buffer_pool_manager), run_(std::make_shared<Run>(buffer_pool_manager)) {}
+
+  ~RunBuilder() { ReleasePage(); }
+
+  RunBuilder(const RunBuilder &) = delete;
+  auto operator=(const RunBuilder &) -> RunBuilder & = delete;
+
+  void Add(std::string_view key, bool tombstone, RID value) {
+    BUSTUB_ASSERT(key.size() <= LSMRunPage::MAX_KEY_SIZE, "key does not fit into an lsm run page");
+    if (page_ == nullptr || !page_->Append(key, tombstone, value)) {
+      ReleasePage();
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(&page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate lsm run page, all frames are pinned");
+      }
+      page_ = reinterpret_cast<LSMRunPage *>(page->GetData());
+      page_->Init();
+      page_->Append(key, tombstone, value);
+      run_->pages_.push_back(page_id);
+      run_->fences_.emplace_back(key);
+    }
+    hashes_.push_back(BloomHash(key));
+    run_->last_key_.assign(key);
+    run_->size_++;
+  }
+
+  /** @return the run, nullptr if it is empty */
+  auto Finish() -> std::shared_ptr<const Run> {
+    ReleasePage();
+    if (run_->size_ == 0) {
+      return nullptr;
+    }
+    size_t num_bits = std::max<size_t>(64, run_->size_ * BLOOM_BITS_PER_KEY);
+    run_->bloom_.assign((num_bits + 63) / 64, 0);
+    num_bits = run_->bloom_.size() * 64;
+    for (auto hash : hashes_) {
+      ForEachBloomBit(hash, num_bits, [this](size_t bit) { run_->bloom_[bit / 64] |= 1ULL << (bit % 64); });
+    }
+    hashes_.clear();
+    return std::move(run_);
+  }
+
+ private:
+  void ReleasePage() {
+    if (page_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(run_->pages_.back(), true);
+      page_ = nullptr;
+    }
+  }
+
+  BufferPoolManager *buffer_pool_manager_;
+  std::shared_ptr<Run> run_;
+  LSMRunPage *page_{nullptr};
+  // hashes of the keys for the bloom filter, which is sized once the number of entries is known
+  std::vector<uint64_t> hashes_;
+};
+
+/*****************************************************************************
+ * CURSORS
+ *****************************************************************************/
+/** Walks the entries of a memtable or a run in order */
+class LSMTree::Cursor {
+ public:
+  virtual ~Cursor() = default;
+  /** Move to the first entry whose key is not less than key, the very first one for nullptr */
+  virtual void Seek(const std::string *key) = 0;
+  virtual auto Valid() const -> bool = 0;
+  virtual void Next() = 0;
+  virtual auto Key() const -> std::string_view = 0;
+  virtual auto IsTombstone() const -> bool = 0;
+  virtual auto Value() const -> RID = 0;
+};
+
+/** Skips the entries at or above sequence_limit, which were added after the cursor was made */
+class LSMTree::MemTableCursor : public Cursor {
+ public:
+  explicit MemTableCursor(const MemTable *memtable,
+                          uint64_t sequence_limit = std::numeric_limits<uint64_t>::max())
+      : memtable_(memtable), sequence_limit_(sequence_limit) {}
+
+  void Seek(const std::string *key) override {
+    node_ = key == nullptr ? memtable_->First() : memtable_->Seek(*key);
+    SkipNewer();
+  }
+  auto Valid() const -> bool override { return node_ != nullptr; }
+  void Next() override {
+    node_ = node_->Next(0);
+    SkipNewer();
+  }
+  auto Key() const -> std::string_view override { return node_->key_; }
+  auto IsTombstone() const -> bool override { return node_->tombstone_; }
+  auto Value() const -> RID override { return node_->value_; }
+
+ private:
+  void SkipNewer() {
+    while (node_ != nullptr && node_->sequence_ >= sequence_limit_) {
+      node_ = node_->Next(0);
+    }
+  }
+
+  const MemTable *memtable_;
+  uint64_t sequence_limit_;
+  const MemTable::Node *node_{nullptr};
+};
+
+/** Keeps the page it is on pinned */
+class LSMTree::RunCursor : public Cursor {
+ public:
+  RunCursor(const Run *run, BufferPoolManager *buffer_pool_manager)
+      : run_(run), buffer_pool_manager_(buffer_pool_manager) {}
+
+  ~RunCursor() override { ReleasePage(); }
+
+  RunCursor(const RunCursor &) = delete;
+  auto operator=(const RunCursor &) -> RunCursor & = delete;
+
+  void Seek(const std::string *key) override {
+    ReleasePage();
+    if (key != nullptr && *key > run_->last_key_) {
+      return;
+    }
+    page_index_ = key == nullptr ? 0 : run_->FindPage(*key);
+    page_ = FetchRunPage(buffer_pool_manager_, run_->pages_[page_index_]);
+    slot_ = key == nullptr ? 0 : page_->LowerBound(*key);
+    SkipExhaustedPage();
+  }
+
+  auto Valid() const -> bool override { return page_ != nullptr; }
+
+  void Next() override {
+    slot_++;
+    SkipExhaustedPage();
+  }
+
+  auto Key() const -> std::string_view override { return page_->KeyAt(slot_); }
+  auto IsTombstone() const -> bool override { return page_->IsTombstoneAt(slot_); }
+  auto Value() const -> RID override { return page_->ValueAt(slot_); }
+
+ private:
+  void SkipExhaustedPage() {
+    if (slot_ < page_->GetSize()) {
+      return;
+    }
+    ReleasePage();
+    if (++page_index_ < run_->pages_.size()) {
+      page_ = FetchRunPage(buffer_pool_manager_, run_->pages_[page_index_]);
+      slot_ = 0;
+    }
+  }
+
+  void ReleasePage() {
+    if (page_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(run_->pages_[page_index_], false);
+      page_ = nullptr;
+    }
+  }
+
+  const Run *run_;
+  BufferPoolManager *buffer_pool_manager_;
+  size_t page_index_{0};
+  const LSMRunPage *page_{nullptr};
+  int slot_{0};
+};
+
+/*****************************************************************************
+ * TREE
+ *****************************************************************************/
+LSMTree::LSMTree(BufferPoolManager *buffer_pool_manager, size_t memtable_size, size_t level_fanout)
+    : buffer_pool_manager_(buffer_pool_manager),
+      memtable_size_(memtable_size),
+      level_fanout_(std::max<size_t>(2, level_fanout)) {
+  auto version = std::make_shared<Version>();
+  version->mem_ = std::make_shared<MemTable>();
+  version_ = std::move(version);
+  background_thread_ = std::thread(&LSMTree::BackgroundWork, this);
+}
+
+LSMTree::~LSMTree() {
+  {
+    std::scoped_lock lock(latch_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  background_thread_.join();
+}
+
+void LSMTree::Put(const std::string &key, RID value) { Write(key, false, value); }
+
+auto LSMTree::Insert(const std::string &key, RID value) -> bool { return Write(key, false, value, true); }
+
+void LSMTree::Remove(const std::string &key) { Write(key, true, RID()); }
+
+auto LSMTree::Lookup(const std::string &key, RID *value) const -> bool {
+  auto version = CurrentVersion();
+  for (const auto *memtable : {version->mem_.get(), version->imm_.get()}) {
+    if (memtable == nullptr) {
+      continue;
+    }
+    const auto *node = memtable->Seek(key);
+    if (node != nullptr && node->key_ == key) {
+      *value = node->value_;
+      return !node->tombstone_;
+    }
+  }
+  for (const auto &level : version->levels_) {
+    for (const auto &run : level) {
+      if (!run->MayContain(key)) {
+        continue;
+      }
+      page_id_t page_id = run->pages_[run->FindPage(key)];
+      const auto *page = FetchRunPage(buffer_pool_manager_, page_id);
+      int slot = page->LowerBound(key);
+      bool found = slot < page->GetSize() && page->KeyAt(slot) == key;
+      bool tombstone = found && page->IsTombstoneAt(slot);
+      if (found) {
+        *value = page->ValueAt(slot);
+      }
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      if (found) {
+        return !tombstone;
+      }
+    }
+  }
+  return false;
+}
+
+void LSMTree::Scan(const std::string *low, bool low_inclusive, const std::string *high, bool high_inclusive,
+                   const std::function<void(const std::string &, RID)> &emit) const {
+  auto version = CurrentVersion();
+  auto cursors = MakeCursors(*version);
+  for (auto &cursor : cursors) {
+    cursor->Seek(low);
+  }
+  std::string key;
+  Merge(cursors, [&](std::string_view entry_key, bool tombstone, RID value) {
+    if (high != nullptr) {
+      int cmp = entry_key.compare(*high);
+      if (cmp > 0 || (cmp == 0 && !high_inclusive)) {
+        return false;
+      }
+    }
+    if (!tombstone && (low == nullptr || low_inclusive || entry_key != *low)) {
+      key.assign(entry_key);
+      emit(key, value);
+    }
+    return true;
+  });
+}
+
+/*
+ * The run goes to the level whose runs are about its size, so that it is not
+ * merged again right away with the runs the next memtables turn into
+ */
+void LSMTree::BulkLoad(const std::vector<std::pair<std::string, RID>> &entries) {
+  RunBuilder builder(buffer_pool_manager_);
+  size_t bytes = 0;
+  for (const auto &[key, value] : entries) {
+    builder.Add(key, false, value);
+    bytes += key.size() + LSMRunPage::ENTRY_HEADER_SIZE + sizeof(uint16_t);
+  }
+  auto run = builder.Finish();
+  if (run == nullptr) {
+    return;
+  }
+  size_t level = 0;
+  for (size_t level_bytes = memtable_size_; level_bytes < bytes; level_bytes *= level_fanout_) {
+    level++;
+  }
+
+  std::scoped_lock lock(latch_);
+  auto version = CurrentVersion();
+  BUSTUB_ASSERT(version->mem_->Empty() && version->imm_ == nullptr && version->levels_.empty(),
+                "only an empty lsm tree can be bulk loaded");
+  auto next = std::make_shared<Version>(*version);
+  next->levels_.resize(level + 1);
+  next->levels_[level].push_back(std::move(run));
+  Publish(std::move(next));
+  work_cv_.notify_one();
+}
+
+void LSMTree::Flush() {
+  std::unique_lock lock(latch_);
+  if (!CurrentVersion()->mem_->Empty()) {
+    done_cv_.wait(lock, [this] { return CurrentVersion()->imm_ == nullptr; });
+    FreezeMemTable();
+  }
+  done_cv_.wait(lock, [this] {
+    auto version = CurrentVersion();
+    return version->imm_ == nullptr && !compacting_ && PickCompaction(*version) < 0;
+  });
+}
+
+auto LSMTree::GetRunCounts() const -> std::vector<size_t> {
+  auto version = CurrentVersion();
+  std::vector<size_t> counts;
+  for (const auto &level : version->levels_) {
+    counts.push_back(level.size());
+  }
+  return counts;
+}
+
+auto LSMTree::CurrentVersion() const -> std::shared_ptr<const Version> { return std::atomic_load(&version_); }
+
+void LSMTree::Publish(std::shared_ptr<const Version> version) { std::atomic_store(&version_, std::move(version)); }
+
+/* Writers are serialized by latch_, so nothing can add key between the check of if_absent and the write */
+auto LSMTree::Write(const std::string &key, bool tombstone, RID value, bool if_absent) -> bool {
+  BUSTUB_ASSERT(key.size() <= LSMRunPage::MAX_KEY_SIZE, "key does not fit into an lsm run page");
+  std::unique_lock lock(latch_);
+  if (CurrentVersion()->mem_->ApproximateBytes() >= memtable_size_) {
+    // the writers stall until the background thread catches up
+    done_cv_.wait(lock, [this] { return CurrentVersion()->imm_ == nullptr; });
+    FreezeMemTable();
+  }
+  RID existing;
+  if (if_absent && Lookup(key, &existing)) {
+    return false;
+  }
+  CurrentVersion()->mem_->Add(key, next_sequence_++, tombstone, value);
+  return true;
+}
+
+/* Called under latch_, once there is no frozen memtable */
+void LSMTree::FreezeMemTable() {
+  auto next = std::make_shared<Version>(*CurrentVersion());
+  next->imm_ = std::move(next->mem_);
+  next->mem_ = std::make_shared<MemTable>();
+  Publish(std::move(next));
+  work_cv_.notify_one();
+}
+
+/*
+ * Writing out the frozen memtable comes first, so that writers do not stall
+ * for long, then the compactions. The runs are written without holding latch_,
+ * the new version is put together under it. Levels only change here, so the
+ * merged runs of a level are still its oldest ones by then.
+ */
+void LSMTree::BackgroundWork() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    work_cv_.wait(lock, [this] {
+      auto version = CurrentVersion();
+      return stop_ || version->imm_ != nullptr || PickCompaction(*version) >= 0;
+    });
+    if (stop_) {
+      return;
+    }
+    auto version = CurrentVersion();
+    compacting_ = true;
+    if (version->imm_ != nullptr) {
+      lock.unlock();
+      std::vector<std::unique_ptr<Cursor>> cursors;
+      cursors.push_back(std::make_unique<MemTableCursor>(version->imm_.get()));
+      cursors[0]->Seek(nullptr);
+      // tombstones only hide entries of the runs beneath
+      auto run = WriteRun(cursors, version->levels_.empty());
+      lock.lock();
+      auto next = std::make_shared<Version>(*CurrentVersion());
+      next->imm_ = nullptr;
+      if (run != nullptr) {
+        if (next->levels_.empty()) {
+          next->levels_.emplace_back();
+        }
+        next->levels_[0].insert(next->levels_[0].begin(), std::move(run));
+      }
+      Publish(std::move(next));
+    } else {
+      auto level = static_cast<size_t>(PickCompaction(*version));
+      const auto inputs = version->levels_[level];
+      const bool bottom = level + 1 == version->levels_.size();
+      lock.unlock();
+      std::vector<std::unique_ptr<Cursor>> cursors;
+      for (const auto &run : inputs) {
+        cursors.push_back(std::make_unique<RunCursor>(run.get(), buffer_pool_manager_));
+        cursors.back()->Seek(nullptr);
+      }
+      auto run = WriteRun(cursors, bottom);
+      cursors.clear();
+      lock.lock();
+      auto next = std::make_shared<Version>(*CurrentVersion());
+      auto &runs = next->levels_[level];
+      runs.resize(runs.size() - inputs.size());
+      if (run != nullptr) {
+        if (next->levels_.size() == level + 1) {
+          next->levels_.emplace_back();
+        }
+        next->levels_[level + 1].insert(next->levels_[level + 1].begin(), std::move(run));
+      }
+      while (!next->levels_.empty() && next->levels_.back().empty()) {
+        next->levels_.pop_back();
+      }
+      Publish(std::move(next));
+    }
+    compacting_ = false;
+    done_cv_.notify_all();
+  }
+}
+
+auto LSMTree::PickCompaction(const Version &version) const -> int {
+  for (size_t level = 0; level < version.levels_.size(); level++) {
+    if (version.levels_[level].size() >= level_fanout_) {
+      return static_cast<int>(level);
+    }
+  }
+  return -1;
+}
+
+auto LSMTree::MakeCursors(const Version &version) const -> std::vector<std::unique_ptr<Cursor>> {
+  std::vector<std::unique_ptr<Cursor>> cursors;
+  cursors.push_back(std::make_unique<MemTableCursor>(version.mem_.get(), version.mem_->VisibleSequence()));
+  if (version.imm_ != nullptr) {
+    cursors.push_back(std::make_unique<MemTableCursor>(version.imm_.get()));
+  }
+  for (const auto &level : version.levels_) {
+    for (const auto &run : level) {
+      cursors.push_back(std::make_unique<RunCursor>(run.get(), buffer_pool_manager_));
+    }
+  }
+  return cursors;
+}
+
+auto LSMTree::WriteRun(const std::vector<std::unique_ptr<Cursor>> &cursors, bool drop_tombstones)
+    -> std::shared_ptr<const Run> {
+  RunBuilder builder(buffer_pool_manager_);
+  Merge(cursors, [&builder, drop_tombstones](std::string_view key, bool tombstone, RID value) {
+    if (!tombstone || !drop_tombstones) {
+      builder.Add(key, tombstone, value);
+    }
+    return true;
+  });
+  return builder.Finish();
+}
+
+void LSMTree::Merge(const std::vector<std::unique_ptr<Cursor>> &cursors,
+                    const std::function<bool(std::string_view, bool, RID)> &emit) {
+  std::string key;
+  while (true) {
+    // on a tie the earlier cursor wins, which holds the newer entry
+    Cursor *newest = nullptr;
+    for (const auto &cursor : cursors) {
+      if (cursor->Valid() && (newest == nullptr || cursor->Key() < newest->Key())) {
+        newest = cursor.get();
+      }
+    }
+    if (newest == nullptr) {
+      return;
+    }
+    key.assign(newest->Key());
+    if (!emit(key, newest->IsTombstone(), newest->Value())) {
+      return;
+    }
+    for (const auto &cursor : cursors) {
+      while (cursor->Valid() && cursor->Key() == key) {
+        cursor->Next();
+      }
+    }
+  }
+}
+
+}  // namespace bustub
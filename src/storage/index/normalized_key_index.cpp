@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key_index.cpp
+//
+// Identification: src/storage/index/normalized_key_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/normalized_key_index.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+// one byte longer than the RID suffix, all ones
+const std::string NormalizedKeyIndex::PAST_ALL_RIDS(sizeof(RID) + 1, '\xff');
+
+NormalizedKeyIndex::NormalizedKeyIndex(std::unique_ptr<IndexMetadata> &&metadata)
+    : Index(std::move(metadata)),
+      key_capacity_(NormalizedKey::MaxEncodedSize(GetKeySchema())),
+      is_unique_(GetMetadata()->IsUnique()) {}
+
+void NormalizedKeyIndex::InsertEntry(const Tuple &key, RID rid, __attribute__((unused)) Transaction *transaction) {
+  InsertKey(MakeKey(key, rid), rid);
+}
+
+void NormalizedKeyIndex::DeleteEntry(const Tuple &key, RID rid, __attribute__((unused)) Transaction *transaction) {
+  RemoveKey(MakeKey(key, rid));
+}
+
+void NormalizedKeyIndex::ScanKey(const Tuple &key, std::vector<RID> *result,
+                                 __attribute__((unused)) Transaction *transaction) {
+  std::string index_key = EncodeKey(key);
+  if (is_unique_) {
+    RID rid;
+    if (LookupKey(index_key, &rid)) {
+      result->push_back(rid);
+    }
+    return;
+  }
+  // the entries of a key are the ones its encoding is a prefix of
+  std::string high = index_key + PAST_ALL_RIDS;
+  ScanKeys(&index_key, true, &high, false, [result](const std::string &entry, RID rid) { result->push_back(rid); });
+}
+
+void NormalizedKeyIndex::ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                   bool high_inclusive, bool reverse, std::vector<RID> *result,
+                                   __attribute__((unused)) Transaction *transaction) {
+  size_t begin = result->size();
+  ForEachInRange(low_key, low_inclusive, high_key, high_inclusive,
+                 [result](const std::string &entry, RID rid) { result->push_back(rid); });
+  if (reverse) {
+    std::reverse(result->begin() + begin, result->end());
+  }
+}
+
+/* The entry columns are decoded from the stored keys, which hold the key columns in full */
+void NormalizedKeyIndex::ScanRangeEntries(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                          bool high_inclusive, bool reverse, std::vector<Tuple> *result,
+                                          __attribute__((unused)) Transaction *transaction) {
+  Schema *entry_schema = GetEntrySchema();
+  size_t begin = result->size();
+  ForEachInRange(low_key, low_inclusive, high_key, high_inclusive,
+                 [result, entry_schema](const std::string &entry, RID rid) {
+                   std::vector<Value> values;
+                   values.reserve(entry_schema->GetColumnCount());
+                   for (uint32_t i = 0; i < entry_schema->GetColumnCount(); i++) {
+                     values.push_back(NormalizedKey::Decode(entry.data(), entry.size(), entry_schema, i));
+                   }
+                   result->emplace_back(values, entry_schema);
+                   result->back().SetRid(rid);
+                 });
+  if (reverse) {
+    std::reverse(result->begin() + begin, result->end());
+  }
+}
+
+auto NormalizedKeyIndex::EncodeKey(const Tuple &key) const -> std::string {
+  std::string encoded(key_capacity_, '\0');
+  encoded.resize(NormalizedKey::Encode(key, GetKeySchema(), encoded.data(), key_capacity_));
+  return encoded;
+}
+
+auto NormalizedKeyIndex::MakeKey(const Tuple &key, RID rid) const -> std::string {
+  std::string encoded = EncodeKey(key);
+  if (!is_unique_) {
+    auto page_id = static_cast<uint32_t>(rid.GetPageId());
+    uint32_t slot_num = rid.GetSlotNum();
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      encoded.push_back(static_cast<char>(page_id >> shift));
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      encoded.push_back(static_cast<char>(slot_num >> shift));
+    }
+  }
+  return encoded;
+}
+
+/*
+ * Non-unique indexes widen the bounds to the runs of entries of the bound
+ * keys: an included bound starts before its first entry or ends past its last
+ * one, an excluded bound the other way round. Keys are prefix free, so no
+ * other key falls between a bound key and its entries.
+ */
+void NormalizedKeyIndex::ForEachInRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                        bool high_inclusive,
+                                        const std::function<void(const std::string &, RID)> &emit) const {
+  std::string low;
+  std::string high;
+  if (low_key != nullptr) {
+    low = EncodeKey(*low_key);
+    if (!is_unique_ && !low_inclusive) {
+      low += PAST_ALL_RIDS;
+    }
+  }
+  if (high_key != nullptr) {
+    high = EncodeKey(*high_key);
+    if (!is_unique_ && high_inclusive) {
+      high += PAST_ALL_RIDS;
+    }
+  }
+  ScanKeys(low_key == nullptr ? nullptr : &low, low_inclusive, high_key == nullptr ? nullptr : &high, high_inclusive,
+           emit);
+}
+
+}  // namespace bustub
@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skiplist_index.cpp
+//
+// Identification: src/storage/index/skiplist_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/skiplist_index.h"
+
+namespace bustub {
+
+SkipListIndex::SkipListIndex(std::unique_ptr<IndexMetadata> &&metadata) : NormalizedKeyIndex(std::move(metadata)) {}
+
+void SkipListIndex::InsertKey(const std::string &key, RID rid) { list_.Insert(key, rid); }
+
+void SkipListIndex::RemoveKey(const std::string &key) { list_.Remove(key); }
+
+auto SkipListIndex::LookupKey(const std::string &key, RID *rid) const -> bool { return list_.Lookup(key, rid); }
+
+void SkipListIndex::ScanKeys(const std::string *low, bool low_inclusive, const std::string *high,
+                             bool high_inclusive, const std::function<void(const std::string &, RID)> &emit) const {
+  auto it = low == nullptr ? list_.Begin() : list_.LowerBound(*low);
+  if (low != nullptr && !low_inclusive && !it.IsEnd() && it.Key() == *low) {
+    ++it;
+  }
+  for (; !it.IsEnd(); ++it) {
+    if (high != nullptr && (it.Key() > *high || (it.Key() == *high && !high_inclusive))) {
+      break;
+    }
+    emit(it.Key(), it.Value());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_internal_page.cpp
+//
+// Identification: src/storage/page/b_epsilon_internal_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/page/b_epsilon_internal_page.h"
+
+namespace bustub {
+
+/*
+ * Init method after creating a new internal page. The buffer gets the bytes
+ * behind the header, the high key and max_size + 1 pivots, the one extra
+ * pivot being room for the tree to post a split before splitting this page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int max_size, int buffer_max_size) {
+  BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>::Init(page_id, INVALID_PAGE_ID, max_size);
+  using Pivot = std::pair<KeyType, page_id_t>;
+  const int pivots_end = INTERNAL_PAGE_HEADER_SIZE + sizeof(KeyType) + alignof(Pivot) + (max_size + 1) * sizeof(Pivot);
+  const int capacity =
+      (BUSTUB_PAGE_SIZE - pivots_end - 2 * static_cast<int>(sizeof(int32_t))) / static_cast<int>(sizeof(Message));
+  BUSTUB_ASSERT(capacity > 1, "no room for a message buffer");
+  int32_t *fields = SizeField();
+  fields[0] = 0;
+  fields[1] = buffer_max_size == 0 ? capacity : std::min(buffer_max_size, capacity);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::GetBufferSize() const -> int { return SizeField()[0]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::GetBufferMaxSize() const -> int { return SizeField()[1]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::IsBufferFull() const -> bool { return GetBufferSize() >= GetBufferMaxSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::MessageAt(int index) const -> const Message & { return Messages()[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::FindMessage(const KeyType &key, const KeyComparator &comparator) const
+    -> const Message * {
+  int index = MessageIndex(key, comparator);
+  if (index == GetBufferSize() || comparator(Messages()[index].key_, key) != 0) {
+    return nullptr;
+  }
+  return Messages() + index;
+}
+
+/*
+ * Buffer a message, replacing an older one for the same key. The caller makes
+ * sure the buffer is not full.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_INTERNAL_PAGE_TYPE::PutMessage(const Message &message, const KeyComparator &comparator) {
+  Message *messages = Messages();
+  int size = GetBufferSize();
+  int index = MessageIndex(message.key_, comparator);
+  if (index < size && comparator(messages[index].key_, message.key_) == 0) {
+    messages[index] = message;
+    return;
+  }
+  BUSTUB_ASSERT(size < GetBufferMaxSize(), "message buffer overflow");
+  std::move_backward(messages + index, messages + size, messages + size + 1);
+  messages[index] = message;
+  SizeField()[0] = size + 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::FullestChild(const KeyComparator &comparator) const -> int {
+  int fullest = 0;
+  int most = -1;
+  for (int i = 0; i < this->GetSize(); i++) {
+    auto [begin, end] = ChildMessageRange(i, comparator);
+    if (end - begin > most) {
+      fullest = i;
+      most = end - begin;
+    }
+  }
+  return fullest;
+}
+
+/* Remove the messages bound for child_index from the buffer and append them to messages, in key order */
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_INTERNAL_PAGE_TYPE::TakeMessages(int child_index, const KeyComparator &comparator,
+                                                std::vector<Message> *messages) {
+  auto [begin, end] = ChildMessageRange(child_index, comparator);
+  Message *buffer = Messages();
+  int size = GetBufferSize();
+  messages->insert(messages->end(), buffer + begin, buffer + end);
+  std::move(buffer + end, buffer + size, buffer + begin);
+  SizeField()[0] = size - (end - begin);
+}
+
+/*
+ * Move the upper half of the pivots to recipient, which was initialized with
+ * the same sizes, along with the messages bound for them.
+ * @return : the key separating this page from recipient
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::MoveHalfTo(BEpsilonInternalPage *recipient, const KeyComparator &comparator)
+    -> KeyType {
+  int size = this->GetSize();
+  int keep = size / 2;
+  KeyType separator = this->KeyAt(keep);
+  for (int i = keep; i < size; i++) {
+    recipient->Append(this->KeyAt(i), this->ValueAt(i));
+  }
+  this->SetSize(keep);
+
+  int split = MessageIndex(separator, comparator);
+  int buffer_size = GetBufferSize();
+  std::copy(Messages() + split, Messages() + buffer_size, recipient->Messages());
+  recipient->SizeField()[0] = buffer_size - split;
+  SizeField()[0] = split;
+  return separator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::Messages() -> Message * {
+  return reinterpret_cast<Message *>(reinterpret_cast<char *>(SizeField()) - GetBufferMaxSize() * sizeof(Message));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::Messages() const -> const Message * {
+  return reinterpret_cast<const Message *>(reinterpret_cast<const char *>(SizeField()) -
+                                           GetBufferMaxSize() * sizeof(Message));
+}
+
+/* The buffer size and capacity, in the last bytes of the page */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::SizeField() const -> int32_t * {
+  auto *page_end = reinterpret_cast<char *>(const_cast<BEpsilonInternalPage *>(this)) + BUSTUB_PAGE_SIZE;
+  return reinterpret_cast<int32_t *>(page_end) - 2;
+}
+
+/* The first buffered message whose key is not less than key */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::MessageIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  const Message *messages = Messages();
+  const Message *found = std::lower_bound(
+      messages, messages + GetBufferSize(), key,
+      [&comparator](const Message &message, const KeyType &key) { return comparator(message.key_, key) < 0; });
+  return static_cast<int>(found - messages);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_INTERNAL_PAGE_TYPE::ChildMessageRange(int child_index, const KeyComparator &comparator) const
+    -> std::pair<int, int> {
+  int begin = child_index == 0 ? 0 : MessageIndex(this->KeyAt(child_index), comparator);
+  int end =
+      child_index + 1 == this->GetSize() ? GetBufferSize() : MessageIndex(this->KeyAt(child_index + 1), comparator);
+  return {begin, end};
+}
+
+template class BEpsilonInternalPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonInternalPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonInternalPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonInternalPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonInternalPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BEpsilonInternalPage<IntegerKey<int32_t>, RID, IntegerKeyComparator<int32_t>>;
+template class BEpsilonInternalPage<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+
+}  // namespace bustub
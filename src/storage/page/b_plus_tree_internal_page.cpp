@@ -13,6 +13,7 @@
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -34,7 +35,23 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
   SetMaxSize(max_size);
   SetSize(0);
   SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetNextPageId(INVALID_PAGE_ID);
 }
+
+/*
+ * Helper methods to set/get the right sibling link and the high key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> KeyType { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
@@ -50,6 +67,13 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
 
+/* Fixed size keys always fit in place of another */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanSetKeyAt(__attribute__((unused)) int index,
+                                                 __attribute__((unused)) const KeyType &key) const -> bool {
+  return true;
+}
+
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
@@ -59,23 +83,274 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { ret
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
-  auto target = std::lower_bound(array_ + 1, array_ + GetSize(), key,
-                                 [&comparator](const auto &pair, auto key) { return comparator(pair.first, key) < 0; });
+  // the child left of the first separator greater than key, keys from index 1 on are separators
+  int index = BranchlessLowerBound(array_, 1, GetSize(), key, comparator);
+  if (index < GetSize() && comparator(array_[index].first, key) == 0) {
+    return array_[index].second;
+  }
+  return array_[index - 1].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
 
-  if (target == array_ + GetSize()) {
-    return ValueAt(GetSize() - 1);
+/*
+ * Helper method to find and return array index(or offset), so that its value
+ * equals to input "value"
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (array_[i].second == value) {
+      return i;
+    }
   }
-  if (comparator(target->first, key) == 0) {
-    return target->second;
+  return -1;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Populate new root page with old_value + new_key & new_value
+ * When the insertion cause overflow from leaf page all the way upto the root
+ * page, you should create a new root page and populate its elements.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  array_[0].second = old_value;
+  array_[1].first = new_key;
+  array_[1].second = new_value;
+  SetSize(2);
+}
+
+/* Add a pair behind the last one, used to fill pages in key order */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  array_[GetSize()] = MappingType(key, value);
+  IncreaseSize(1);
+}
+
+/*
+ * Insert new_key & new_value pair right after the pair with its value ==
+ * old_value
+ * @return:  new size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) -> int {
+  int idx = ValueIndex(old_value) + 1;
+  std::move_backward(array_ + idx, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[idx].first = new_key;
+  array_[idx].second = new_value;
+  IncreaseSize(1);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+/*
+ * Insert new_key & new_value after old_value into a full page and move the
+ * upper half of the resulting max_size + 1 pairs to recipient. The insertion
+ * is staged in a scratch buffer so that a page filled to its physical capacity
+ * never overflows. Afterwards recipient->KeyAt(0) is the key to push up.
+ * The recipient is linked in as the right sibling before anything points at
+ * it from above.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAndMoveHalfTo(BPlusTreeInternalPage *recipient, const ValueType &old_value,
+                                                         const KeyType &new_key, const ValueType &new_value,
+                                                         BufferPoolManager *buffer_pool_manager) {
+  std::vector<MappingType> items(array_, array_ + GetSize());
+  int idx = ValueIndex(old_value) + 1;
+  items.insert(items.begin() + idx, MappingType(new_key, new_value));
+
+  int total = static_cast<int>(items.size());
+  int keep = total / 2;
+  std::copy(items.begin(), items.begin() + keep, array_);
+  SetSize(keep);
+  recipient->CopyNFrom(items.data() + keep, total - keep, buffer_pool_manager);
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetHighKey(GetHighKey());
+  SetNextPageId(recipient->GetPageId());
+  SetHighKey(recipient->KeyAt(0));
+
+  // the freshly inserted child may have landed on this side of the split
+  if (idx < keep) {
+    AdoptChild(new_value, buffer_pool_manager);
   }
+}
 
-  return std::prev(target)->second;
+/* Copy entries into myself, re-parenting every child that is moved */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const MappingType *items, int size,
+                                               BufferPoolManager *buffer_pool_manager) {
+  std::copy(items, items + size, array_ + GetSize());
+  for (int i = 0; i < size; i++) {
+    AdoptChild(items[i].second, buffer_pool_manager);
+  }
+  IncreaseSize(size);
+}
+
+/*
+ * Point the parent page id of child at this page. The child is not latched: in
+ * B-link mode its writer may hold it while waiting for the latch of this page.
+ * Only the parent id is touched, which BPlusTreePage accesses atomically.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::AdoptChild(const ValueType &child, BufferPoolManager *buffer_pool_manager) {
+  Page *page = buffer_pool_manager->FetchPage(child);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch child page while re-parenting");
+  }
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(child, true);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Remove the key & value pair in internal page according to input index(a.k.a
+ * array offset)
+ * NOTE: store key&value pair continuously after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
+}
+
+/*
+ * Remove the only key & value pair in internal page and return the value
+ * NOTE: only call this method within AdjustRoot()(in b_plus_tree.cpp)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() -> ValueType {
+  ValueType only_child = ValueAt(0);
+  SetSize(0);
+  return only_child;
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+/*
+ * Remove all of key & value pairs from this page to "recipient" page.
+ * The middle_key is the separation key you should get from the parent. You need
+ * to make sure the middle key is added to the recipient to maintain the invariant.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                               BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  recipient->CopyNFrom(array_, GetSize(), buffer_pool_manager);
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetHighKey(GetHighKey());
+  SetSize(0);
+}
+
+/*****************************************************************************
+ * REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Remove the first key & value pair from this page to tail of "recipient" page.
+ * Afterwards KeyAt(0) holds the separator that should replace middle_key in
+ * the parent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                      BufferPoolManager *buffer_pool_manager) {
+  MappingType first(middle_key, ValueAt(0));
+  recipient->CopyNFrom(&first, 1, buffer_pool_manager);
+  Remove(0);
+}
+
+/*
+ * Remove the last key & value pair from this page to head of "recipient" page.
+ * Afterwards recipient->KeyAt(0) holds the separator that should replace
+ * middle_key in the parent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  MappingType last = array_[GetSize() - 1];
+  IncreaseSize(-1);
+
+  std::move_backward(recipient->array_, recipient->array_ + recipient->GetSize(),
+                     recipient->array_ + recipient->GetSize() + 1);
+  recipient->array_[1].first = middle_key;
+  recipient->array_[0] = last;
+  recipient->IncreaseSize(1);
+  recipient->AdoptChild(last.second, buffer_pool_manager);
 }
 
 // valuetype for internalNode should be page id_t
+/*****************************************************************************
+ * OCCUPANCY
+ *****************************************************************************/
+/*
+ * An internal page only splits when a child is added to a full page, so it is
+ * safe for an insert while it has room for one more child.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsFull() const -> bool { return GetSize() >= GetMaxSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsInsertSafe() const -> bool { return GetSize() < GetMaxSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsDeleteSafe(double min_fill) const -> bool {
+  return GetSize() > std::max(GetMinSize(min_fill), 2);
+}
+
+/* A page left with a single child only routes, it underflows however low min_fill is */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderflow(double min_fill) const -> bool {
+  return GetSize() < std::max(GetMinSize(min_fill), 2);
+}
+
+/* Whether all children of sibling, with middle_key pulled down from the parent, fit in here */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanAbsorb(const BPlusTreeInternalPage *sibling,
+                                               __attribute__((unused)) const KeyType &middle_key) const -> bool {
+  return GetSize() + sibling->GetSize() <= GetMaxSize();
+}
+
+/* Whether a bulk load should move on to the next page, see the leaf page counterpart */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ReachedFillFactor(double fill_factor) const -> bool {
+  int capacity = GetMaxSize();
+  int target = std::clamp(static_cast<int>(fill_factor * capacity), std::max(2 * GetMinSize() - 1, 1), capacity);
+  return GetSize() >= target;
+}
+
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
 template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<IntegerKey<int32_t>, page_id_t, IntegerKeyComparator<int32_t>>;
+template class BPlusTreeInternalPage<IntegerKey<int64_t>, page_id_t, IntegerKeyComparator<int64_t>>;
+template class BPlusTreeInternalPage<NonUniqueKey<GenericKey<4>>, page_id_t, NonUniqueComparator<GenericComparator<4>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<GenericKey<8>>, page_id_t, NonUniqueComparator<GenericComparator<8>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<GenericKey<16>>, page_id_t,
+                                     NonUniqueComparator<GenericComparator<16>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<GenericKey<32>>, page_id_t,
+                                     NonUniqueComparator<GenericComparator<32>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<GenericKey<64>>, page_id_t,
+                                     NonUniqueComparator<GenericComparator<64>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<IntegerKey<int32_t>>, page_id_t,
+                                     NonUniqueComparator<IntegerKeyComparator<int32_t>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<IntegerKey<int64_t>>, page_id_t,
+                                     NonUniqueComparator<IntegerKeyComparator<int64_t>>>;
+template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, CoveringComparator<GenericComparator<16>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<GenericKey<16>>, page_id_t,
+                                     NonUniqueComparator<CoveringComparator<GenericComparator<16>>>>;
+template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, CoveringComparator<GenericComparator<64>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<GenericKey<64>>, page_id_t,
+                                     NonUniqueComparator<CoveringComparator<GenericComparator<64>>>>;
+
 }  // namespace bustub
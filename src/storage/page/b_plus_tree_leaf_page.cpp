@@ -27,7 +27,7 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next/prev page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
@@ -35,6 +35,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, in
   SetMaxSize(max_size);
   SetSize(0);
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
   SetParentPageId(parent_id);
   SetPageId(page_id);
 }
@@ -48,6 +49,28 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return nex
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+/**
+ * Helper methods to set/get prev page id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
+/**
+ * Helper methods to set/get the high key, only valid with a next page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const -> KeyType { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
+
+/* Fixed size keys are stored whole, so the low key that bounds a prefix is not kept */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetLowKey(__attribute__((unused)) const KeyType &low_key) {}
+
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
@@ -58,12 +81,19 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   return array_[index].first;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+
+/* Fixed size keys always fit in place of another */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanSetKeyAt(__attribute__((unused)) int index,
+                                             __attribute__((unused)) const KeyType &key) const -> bool {
+  return true;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
-  // replace with your own code
-  auto it = std::lower_bound(array_, array_ + GetSize(), key,
-                             [&comparator](const auto &pair, auto key) { return comparator(pair.first, key) < 0; });
-  return std::distance(array_, it);
+  return BranchlessLowerBound(array_, 0, GetSize(), key, comparator);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -77,9 +107,197 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, co
   return true;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+
+/*
+ * Helper method to find and return the key & value pair associated with input
+ * "index"(a.k.a array offset)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) -> const MappingType & { return array_[index]; }
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert key & value pair into leaf page ordered by key
+ * @return page size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
+    -> int {
+  int idx = KeyIndex(key, comparator);
+  std::move_backward(array_ + idx, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[idx].first = key;
+  array_[idx].second = value;
+  IncreaseSize(1);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+/*
+ * Remove half of key & value pairs from this page to "recipient" page and link
+ * the recipient in as the right sibling. The prev link of the page after the
+ * recipient is left to the caller, which has to latch that page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  int keep = GetSize() / 2;
+  recipient->CopyNFrom(array_ + keep, GetSize() - keep);
+  SetSize(keep);
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetPrevPageId(GetPageId());
+  recipient->SetHighKey(GetHighKey());
+  SetNextPageId(recipient->GetPageId());
+  SetHighKey(recipient->KeyAt(0));
+}
+
+/*
+ * Copy starting from items, and copy {size} number of elements into me.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  std::copy(items, items + size, array_ + GetSize());
+  IncreaseSize(size);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * First look through leaf page to see whether delete key exist or not. If
+ * exist, perform deletion, otherwise return immediately.
+ * NOTE: store key&value pair continuously after deletion
+ * @return  page size after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int {
+  int idx = KeyIndex(key, comparator);
+  if (idx == GetSize() || comparator(array_[idx].first, key) != 0) {
+    return GetSize();
+  }
+  std::move(array_ + idx + 1, array_ + GetSize(), array_ + idx);
+  IncreaseSize(-1);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+/*
+ * Remove all of key & value pairs from this page to "recipient" page. Don't forget
+ * to update the next_page id in the sibling page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  recipient->CopyNFrom(array_, GetSize());
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetHighKey(GetHighKey());
+  SetSize(0);
+}
+
+/*****************************************************************************
+ * REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Remove the first key & value pair from this page to "recipient" page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->CopyNFrom(array_, 1);
+  std::move(array_ + 1, array_ + GetSize(), array_);
+  IncreaseSize(-1);
+}
+
+/*
+ * Remove the last key & value pair from this page to "recipient" page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  std::move_backward(recipient->array_, recipient->array_ + recipient->GetSize(),
+                     recipient->array_ + recipient->GetSize() + 1);
+  recipient->array_[0] = array_[GetSize() - 1];
+  recipient->IncreaseSize(1);
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * OCCUPANCY
+ *****************************************************************************/
+/*
+ * A leaf splits as soon as it reaches max size, so it is safe for an insert
+ * while one more entry keeps it below that, and for a delete while it stays
+ * at or above min size afterwards.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsFull() const -> bool { return GetSize() >= GetMaxSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsInsertSafe() const -> bool { return GetSize() + 1 < GetMaxSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsDeleteSafe(double min_fill) const -> bool {
+  return GetSize() > GetMinSize(min_fill);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderflow(double min_fill) const -> bool { return GetSize() < GetMinSize(min_fill); }
+
+/* Whether all entries of sibling fit in here without making this page full */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanAbsorb(const BPlusTreeLeafPage *sibling) const -> bool {
+  return GetSize() + sibling->GetSize() < GetMaxSize();
+}
+
+/* Whether one entry of sibling fits in here, which holds for any underfull page */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanBorrowFrom(__attribute__((unused)) const BPlusTreeLeafPage *sibling) const
+    -> bool {
+  return true;
+}
+
+/*
+ * Whether a bulk load should move on to the next leaf. The fill is clamped to
+ * [2 * min size - 1, max size - 1], so that the last leaf can always be
+ * topped up to min size from its left neighbour.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ReachedFillFactor(double fill_factor) const -> bool {
+  int capacity = GetMaxSize() - 1;
+  int target = std::clamp(static_cast<int>(fill_factor * capacity), std::max(2 * GetMinSize() - 1, 1), capacity);
+  return GetSize() >= target;
+}
+
+/* The share of the entries a leaf holds at most, which is one less than max size */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Fill() const -> double {
+  return static_cast<double>(GetSize()) / std::max(GetMaxSize() - 1, 1);
+}
+
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeLeafPage<IntegerKey<int32_t>, RID, IntegerKeyComparator<int32_t>>;
+template class BPlusTreeLeafPage<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>>;
+template class BPlusTreeLeafPage<NonUniqueKey<GenericKey<4>>, RID, NonUniqueComparator<GenericComparator<4>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<GenericKey<8>>, RID, NonUniqueComparator<GenericComparator<8>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<GenericKey<16>>, RID, NonUniqueComparator<GenericComparator<16>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<GenericKey<32>>, RID, NonUniqueComparator<GenericComparator<32>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<GenericKey<64>>, RID, NonUniqueComparator<GenericComparator<64>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<IntegerKey<int32_t>>, RID,
+                                 NonUniqueComparator<IntegerKeyComparator<int32_t>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<IntegerKey<int64_t>>, RID,
+                                 NonUniqueComparator<IntegerKeyComparator<int64_t>>>;
+template class BPlusTreeLeafPage<GenericKey<16>, RID, CoveringComparator<GenericComparator<16>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<GenericKey<16>>, RID,
+                                 NonUniqueComparator<CoveringComparator<GenericComparator<16>>>>;
+template class BPlusTreeLeafPage<GenericKey<64>, RID, CoveringComparator<GenericComparator<64>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<GenericKey<64>>, RID,
+                                 NonUniqueComparator<CoveringComparator<GenericComparator<64>>>>;
+
 }  // namespace bustub
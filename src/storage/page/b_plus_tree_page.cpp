@@ -9,6 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cmath>
+
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
@@ -18,7 +21,7 @@ namespace bustub {
  * Page type enum class is defined in b_plus_tree_page.h
  */
 auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
-auto BPlusTreePage::IsRootPage() const -> bool { return page_type_ == IndexPageType::INTERNAL_PAGE; }
+auto BPlusTreePage::IsRootPage() const -> bool { return GetParentPageId() == INVALID_PAGE_ID; }
 void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
@@ -37,15 +40,27 @@ void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
- * Generally, min page size == max page size / 2
+ * Generally, min page size == max page size / 2. An internal page counts
+ * children rather than keys, so it rounds up to keep at least half of them.
+ * A lower min_fill relaxes this, but a leaf keeps at least one entry and an
+ * internal page at least one child.
  */
-auto BPlusTreePage::GetMinSize() const -> int { return max_size_ / 2; }
+auto BPlusTreePage::GetMinSize(double min_fill) const -> int {
+  if (IsLeafPage()) {
+    return std::max(static_cast<int>(max_size_ * min_fill), 1);
+  }
+  return std::max(static_cast<int>(std::ceil(max_size_ * min_fill)), 1);
+}
 
 /*
  * Helper methods to get/set parent page id
+ * A split re-parents the children it moves while holding only the latch of
+ * their new parent, so the field is accessed atomically.
  */
-auto BPlusTreePage::GetParentPageId() const -> page_id_t { return parent_page_id_; }
-void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) { parent_page_id_ = parent_page_id; }
+auto BPlusTreePage::GetParentPageId() const -> page_id_t { return __atomic_load_n(&parent_page_id_, __ATOMIC_RELAXED); }
+void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) {
+  __atomic_store_n(&parent_page_id_, parent_page_id, __ATOMIC_RELAXED);
+}
 
 /*
  * Helper methods to get/set self page id
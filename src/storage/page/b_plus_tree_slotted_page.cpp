@@ -0,0 +1,358 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_slotted_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::InitSlotted(page_id_t page_id, page_id_t parent_id, IndexPageType page_type) {
+  SetPageType(page_type);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  heap_begin_ = BUSTUB_PAGE_SIZE;
+  key_bytes_ = 0;
+  prefix_size_ = 0;
+  low_key_offset_ = BUSTUB_PAGE_SIZE;
+  low_key_size_ = 0;
+  high_key_.size_ = 0;
+  // as many entries as fit with empty keys
+  SetMaxSize((BUSTUB_PAGE_SIZE - SlotsEnd()) / static_cast<int>(sizeof(Slot)));
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetNextPageId() const -> page_id_t {
+  return next_page_id_;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetNextPageId(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetPrevPageId() const -> page_id_t {
+  return prev_page_id_;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetPrevPageId(page_id_t prev_page_id) {
+  prev_page_id_ = prev_page_id;
+}
+
+/*
+ * The high key lives in the header, so replacing it only needs heap space
+ * when it widens the key range of a leaf and shortens its prefix
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetHighKey() const -> VarKey {
+  return high_key_;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetHighKey(const VarKey &high_key) {
+  // the stored keys go without the first bytes of the old high key
+  VarKey old_prefix = high_key_;
+  high_key_.SetFromBytes(high_key.data_, high_key.size_);
+  Reencode(old_prefix, IsLeafPage() ? FencePrefixSize(GetLowKey(), high_key_) : 0);
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::GetLowKey() const -> VarKey {
+  VarKey key;
+  key.SetFromBytes(reinterpret_cast<const char *>(this) + low_key_offset_, low_key_size_);
+  return key;
+}
+
+/*
+ * The low key is kept in the heap, the caller makes sure it fits together
+ * with the bytes a shorter prefix gives back to the stored keys
+ */
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetLowKey(const VarKey &low_key) {
+  key_bytes_ -= low_key_size_;
+  low_key_size_ = 0;
+  low_key_offset_ = AllocateKey(low_key.data_, low_key.size_);
+  low_key_size_ = low_key.size_;
+  Reencode(high_key_, FencePrefixSize(low_key, high_key_));
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::PrefixSize() const -> int {
+  return prefix_size_;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::FencePrefixSize(const VarKey &low_key, const VarKey &high_key) -> int {
+  if (high_key.size_ == 0) {
+    return 0;
+  }
+  int common = std::min(low_key.size_, high_key.size_);
+  int size = 0;
+  while (size < common && low_key.data_[size] == high_key.data_[size]) {
+    size++;
+  }
+  return size;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::KeyAt(int index) const -> VarKey {
+  VarKey key;
+  std::memcpy(key.data_, high_key_.data_, prefix_size_);
+  std::memcpy(key.data_ + prefix_size_, reinterpret_cast<const char *>(this) + slots_[index].offset_,
+              slots_[index].size_);
+  key.size_ = prefix_size_ + slots_[index].size_;
+  return key;
+}
+
+/*
+ * Replace the key at index, the caller makes sure it fits (see CanSetKeyAt)
+ */
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetKeyAt(int index, const VarKey &key) {
+  key_bytes_ -= slots_[index].size_;
+  slots_[index].size_ = 0;
+  slots_[index].offset_ = AllocateKey(key.data_ + prefix_size_, key.size_ - prefix_size_);
+  slots_[index].size_ = key.size_ - prefix_size_;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::CanSetKeyAt(int index, const VarKey &key) const -> bool {
+  return FreeBytes() + slots_[index].size_ >= key.size_ - prefix_size_;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::ValueAt(int index) const -> ValueType {
+  return slots_[index].value_;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetValueAt(int index, const ValueType &value) {
+  slots_[index].value_ = value;
+}
+
+/*
+ * Compare the stored key at index with key without copying it out
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::CompareKeyAt(int index, const VarKey &key) const -> int {
+  int cmp = ComparePrefix(key);
+  if (cmp != 0) {
+    return cmp;
+  }
+  return CompareSuffixAt(index, key.data_ + prefix_size_, key.size_ - prefix_size_);
+}
+
+/*
+ * The prefix is compared once, the search then runs on the stored suffixes
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::LowerBound(int begin, const VarKey &key) const -> int {
+  int end = GetSize();
+  if (begin >= end) {
+    return begin;
+  }
+  int cmp = ComparePrefix(key);
+  if (cmp != 0) {
+    return cmp > 0 ? begin : end;
+  }
+  const char *suffix = key.data_ + prefix_size_;
+  size_t suffix_size = key.size_ - prefix_size_;
+  int base = begin;
+  int n = end - begin;
+  while (n > 1) {
+    int half = n / 2;
+    base = CompareSuffixAt(base + half, suffix, suffix_size) < 0 ? base + half : base;
+    n -= half;
+  }
+  return base + static_cast<int>(CompareSuffixAt(base, suffix, suffix_size) < 0);
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::ComparePrefix(const VarKey &key) const -> int {
+  int cmp = std::memcmp(high_key_.data_, key.data_, std::min<size_t>(prefix_size_, key.size_));
+  if (cmp != 0) {
+    return cmp;
+  }
+  // a proper prefix of the prefix sorts before every stored key
+  return static_cast<int>(key.size_ < prefix_size_);
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::CompareSuffixAt(int index, const char *suffix, size_t suffix_size) const
+    -> int {
+  return CompareVarKeyBytes(reinterpret_cast<const char *>(this) + slots_[index].offset_, slots_[index].size_, suffix,
+                            suffix_size);
+}
+
+/*****************************************************************************
+ * SLOTS AND HEAP
+ *****************************************************************************/
+/*
+ * Insert an entry at index, shifting the later slots. The caller makes sure
+ * the page is not full, the heap is compacted here when the free space is
+ * fragmented.
+ */
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::InsertAt(int index, const VarKey &key, const ValueType &value) {
+  int size = key.size_ - prefix_size_;
+  // make room for the slot before allocating, so that the key cannot end up under the slot array
+  if (heap_begin_ - SlotsEnd() < static_cast<int>(sizeof(Slot)) + size) {
+    Compact();
+  }
+  std::memmove(slots_ + index + 1, slots_ + index, (GetSize() - index) * sizeof(Slot));
+  IncreaseSize(1);
+  slots_[index].size_ = 0;
+  slots_[index].offset_ = AllocateKey(key.data_ + prefix_size_, size);
+  slots_[index].size_ = size;
+  slots_[index].value_ = value;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::RemoveAt(int index) {
+  key_bytes_ -= slots_[index].size_;
+  std::memmove(slots_ + index, slots_ + index + 1, (GetSize() - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::Truncate(int index) {
+  for (int i = index; i < GetSize(); i++) {
+    key_bytes_ -= slots_[i].size_;
+  }
+  SetSize(index);
+  if (index == 0 && low_key_size_ == 0) {
+    heap_begin_ = BUSTUB_PAGE_SIZE;
+  }
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::UsedBytes() const -> int {
+  return SlotsEnd() + key_bytes_;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::FreeBytes() const -> int {
+  return BUSTUB_PAGE_SIZE - UsedBytes();
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::EntryBytes(int begin) const -> int {
+  int bytes = 0;
+  for (int i = begin; i < GetSize(); i++) {
+    bytes += static_cast<int>(sizeof(Slot)) + slots_[i].size_;
+  }
+  return bytes;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::KeySizeAt(int index) const -> int {
+  return slots_[index].size_;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::SlotsEnd() const -> int {
+  return static_cast<int>(reinterpret_cast<const char *>(slots_ + GetSize()) - reinterpret_cast<const char *>(this));
+}
+
+/* Copy the key bytes to the heap, compacting it first if they do not fit in the contiguous free space */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::AllocateKey(const char *data, int size) -> uint16_t {
+  if (heap_begin_ - SlotsEnd() < size) {
+    Compact();
+  }
+  heap_begin_ -= size;
+  key_bytes_ += size;
+  std::memcpy(reinterpret_cast<char *>(this) + heap_begin_, data, size);
+  return heap_begin_;
+}
+
+/*
+ * A longer prefix only drops bytes off the front of the stored keys. A
+ * shorter one puts its lost bytes back in front of every key, which rewrites
+ * the heap.
+ */
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::Reencode(const VarKey &old_prefix, int prefix_size) {
+  int dropped = prefix_size - prefix_size_;
+  if (dropped > 0) {
+    for (int i = 0; i < GetSize(); i++) {
+      slots_[i].offset_ += dropped;
+      slots_[i].size_ -= dropped;
+    }
+    key_bytes_ -= GetSize() * dropped;
+  } else if (dropped < 0) {
+    BUSTUB_ASSERT(FreeBytes() >= -dropped * GetSize(), "no room to restore the key prefix");
+    Compact(old_prefix.data_ + prefix_size, -dropped);
+  }
+  prefix_size_ = prefix_size;
+}
+
+/* Rewrite the live keys back to back at the end of the page, each behind prefix if there is one */
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::Compact(const char *prefix, int prefix_size) {
+  char heap[BUSTUB_PAGE_SIZE];
+  auto *page = reinterpret_cast<char *>(this);
+  uint16_t begin = BUSTUB_PAGE_SIZE;
+  for (int i = 0; i < GetSize(); i++) {
+    begin -= prefix_size + slots_[i].size_;
+    if (prefix_size > 0) {
+      std::memcpy(heap + begin, prefix, prefix_size);
+    }
+    std::memcpy(heap + begin + prefix_size, page + slots_[i].offset_, slots_[i].size_);
+    slots_[i].offset_ = begin;
+    slots_[i].size_ += prefix_size;
+  }
+  begin -= low_key_size_;
+  std::memcpy(heap + begin, page + low_key_offset_, low_key_size_);
+  low_key_offset_ = begin;
+  std::memcpy(page + begin, heap + begin, BUSTUB_PAGE_SIZE - begin);
+  heap_begin_ = begin;
+  key_bytes_ = BUSTUB_PAGE_SIZE - begin;
+}
+
+/*****************************************************************************
+ * OCCUPANCY
+ *****************************************************************************/
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::IsFull() const -> bool {
+  return FreeBytes() < MAX_ENTRY_SIZE;
+}
+
+/*
+ * A page is rebalanced once less than min_fill of its bytes are used, or when
+ * a leaf is empty or an internal page is left with a single child.
+ */
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::IsDeleteSafe(double min_fill) const -> bool {
+  return GetSize() > (IsLeafPage() ? 1 : 2) && UsedBytes() - MAX_ENTRY_SIZE >= min_fill * BUSTUB_PAGE_SIZE;
+}
+
+template <typename ValueType>
+auto BPlusTreeSlottedPage<ValueType>::IsUnderflow(double min_fill) const -> bool {
+  return GetSize() < (IsLeafPage() ? 1 : 2) || UsedBytes() < min_fill * BUSTUB_PAGE_SIZE;
+}
+
+template class BPlusTreeSlottedPage<RID>;
+template class BPlusTreeSlottedPage<page_id_t>;
+
+}  // namespace bustub
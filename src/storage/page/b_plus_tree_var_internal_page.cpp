@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_var_internal_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_var_internal_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/exception.h"
+#include "storage/page/b_plus_tree_var_internal_page.h"
+
+namespace bustub {
+
+#define VAR_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<VarKey, page_id_t, KeyComparator>
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, __attribute__((unused)) int max_size) {
+  InitSlotted(page_id, parent_id, IndexPageType::INTERNAL_PAGE);
+}
+
+template <typename KeyComparator>
+auto VAR_INTERNAL_PAGE_TYPE::ValueIndex(const page_id_t &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename KeyComparator>
+auto VAR_INTERNAL_PAGE_TYPE::Lookup(const VarKey &key, __attribute__((unused)) const KeyComparator &comparator) const
+    -> page_id_t {
+  // the child left of the first separator greater than key, keys from index 1 on are separators
+  int index = LowerBound(1, key);
+  if (index < GetSize() && CompareKeyAt(index, key) == 0) {
+    return ValueAt(index);
+  }
+  return ValueAt(index - 1);
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::PopulateNewRoot(const page_id_t &old_value, const VarKey &new_key,
+                                             const page_id_t &new_value) {
+  Truncate(0);
+  InsertAt(0, VarKey{}, old_value);
+  InsertAt(1, new_key, new_value);
+}
+
+/* Add a pair behind the last one, used to fill pages in key order */
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::Append(const VarKey &key, const page_id_t &value) { InsertAt(GetSize(), key, value); }
+
+template <typename KeyComparator>
+auto VAR_INTERNAL_PAGE_TYPE::InsertNodeAfter(const page_id_t &old_value, const VarKey &new_key,
+                                             const page_id_t &new_value) -> int {
+  InsertAt(ValueIndex(old_value) + 1, new_key, new_value);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+/*
+ * Insert new_key & new_value after old_value into a full page and move the
+ * pairs past the byte midpoint to recipient. Afterwards recipient->KeyAt(0) is
+ * the key to push up.
+ */
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::InsertAndMoveHalfTo(BPlusTreeInternalPage *recipient, const page_id_t &old_value,
+                                                 const VarKey &new_key, const page_id_t &new_value,
+                                                 BufferPoolManager *buffer_pool_manager) {
+  std::vector<std::pair<VarKey, page_id_t>> items;
+  items.reserve(GetSize() + 1);
+  for (int i = 0; i < GetSize(); i++) {
+    items.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  int idx = ValueIndex(old_value) + 1;
+  items.insert(items.begin() + idx, std::make_pair(new_key, new_value));
+
+  int total = static_cast<int>(items.size());
+  int half = (EntryBytes(0) + static_cast<int>(sizeof(Slot)) + new_key.size_) / 2;
+  int keep = 0;
+  for (int bytes = 0; keep < total && bytes < half; keep++) {
+    bytes += static_cast<int>(sizeof(Slot)) + items[keep].first.size_;
+  }
+  keep = std::clamp(keep, 1, total - 1);
+
+  Truncate(0);
+  for (int i = 0; i < keep; i++) {
+    Append(items[i].first, items[i].second);
+  }
+  for (int i = keep; i < total; i++) {
+    recipient->Append(items[i].first, items[i].second);
+    recipient->AdoptChild(items[i].second, buffer_pool_manager);
+  }
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetHighKey(GetHighKey());
+  SetNextPageId(recipient->GetPageId());
+  SetHighKey(recipient->KeyAt(0));
+
+  // the freshly inserted child may have landed on this side of the split
+  if (idx < keep) {
+    AdoptChild(new_value, buffer_pool_manager);
+  }
+}
+
+/*
+ * Point the parent page id of child at this page. The child is not latched: in
+ * B-link mode its writer may hold it while waiting for the latch of this page.
+ * Only the parent id is touched, which BPlusTreePage accesses atomically.
+ */
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::AdoptChild(page_id_t child, BufferPoolManager *buffer_pool_manager) {
+  Page *page = buffer_pool_manager->FetchPage(child);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch child page while re-parenting");
+  }
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(child, true);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::Remove(int index) { RemoveAt(index); }
+
+template <typename KeyComparator>
+auto VAR_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() -> page_id_t {
+  page_id_t only_child = ValueAt(0);
+  Truncate(0);
+  return only_child;
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+/*
+ * Move every pair to recipient, with middle_key from the parent standing in for
+ * the unused first key. This page is left untouched until it is emptied, so it
+ * needs no room for middle_key.
+ */
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const VarKey &middle_key,
+                                       BufferPoolManager *buffer_pool_manager) {
+  for (int i = 0; i < GetSize(); i++) {
+    recipient->Append(i == 0 ? middle_key : KeyAt(i), ValueAt(i));
+    recipient->AdoptChild(ValueAt(i), buffer_pool_manager);
+  }
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetHighKey(GetHighKey());
+  Truncate(0);
+}
+
+/*****************************************************************************
+ * REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Afterwards KeyAt(0) holds the separator that should replace middle_key in
+ * the parent.
+ */
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const VarKey &middle_key,
+                                              BufferPoolManager *buffer_pool_manager) {
+  recipient->Append(middle_key, ValueAt(0));
+  recipient->AdoptChild(ValueAt(0), buffer_pool_manager);
+  RemoveAt(0);
+}
+
+/*
+ * Afterwards recipient->KeyAt(0) holds the separator that should replace
+ * middle_key in the parent.
+ */
+template <typename KeyComparator>
+void VAR_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const VarKey &middle_key,
+                                               BufferPoolManager *buffer_pool_manager) {
+  VarKey last_key = KeyAt(GetSize() - 1);
+  page_id_t last_value = ValueAt(GetSize() - 1);
+  RemoveAt(GetSize() - 1);
+  recipient->SetKeyAt(0, middle_key);
+  recipient->InsertAt(0, last_key, last_value);
+  recipient->AdoptChild(last_value, buffer_pool_manager);
+}
+
+/*****************************************************************************
+ * OCCUPANCY
+ *****************************************************************************/
+/* An internal page splits when a child is added to a full page */
+template <typename KeyComparator>
+auto VAR_INTERNAL_PAGE_TYPE::IsInsertSafe() const -> bool { return !IsFull(); }
+
+template <typename KeyComparator>
+auto VAR_INTERNAL_PAGE_TYPE::CanAbsorb(const BPlusTreeInternalPage *sibling, const VarKey &middle_key) const -> bool {
+  return FreeBytes() >= sibling->EntryBytes(0) - sibling->KeySizeAt(0) + middle_key.size_;
+}
+
+/* Bulk loading stops filling a page at fill_factor of it, but never below half of it */
+template <typename KeyComparator>
+auto VAR_INTERNAL_PAGE_TYPE::ReachedFillFactor(double fill_factor) const -> bool {
+  return UsedBytes() >= std::max(fill_factor, 0.5) * BUSTUB_PAGE_SIZE || IsFull();
+}
+
+template class BPlusTreeInternalPage<VarKey, page_id_t, VarKeyComparator>;
+template class BPlusTreeInternalPage<VarKey, page_id_t, NonUniqueComparator<VarKeyComparator>>;
+
+}  // namespace bustub
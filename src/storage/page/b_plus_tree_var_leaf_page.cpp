@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_var_leaf_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_var_leaf_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "storage/page/b_plus_tree_var_leaf_page.h"
+
+namespace bustub {
+
+#define VAR_LEAF_PAGE_TYPE BPlusTreeLeafPage<VarKey, RID, KeyComparator>
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+template <typename KeyComparator>
+void VAR_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, __attribute__((unused)) int max_size) {
+  InitSlotted(page_id, parent_id, IndexPageType::LEAF_PAGE);
+}
+
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::GetItem(int index) -> std::pair<VarKey, RID> { return {KeyAt(index), ValueAt(index)}; }
+
+/* Keys are compared on their stored bytes, which orders them like the comparator does */
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::KeyIndex(const VarKey &key, __attribute__((unused)) const KeyComparator &comparator) const
+    -> int {
+  return LowerBound(0, key);
+}
+
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::Lookup(const VarKey &key, RID *value, const KeyComparator &comparator) -> bool {
+  int idx = KeyIndex(key, comparator);
+  if (idx == GetSize() || CompareKeyAt(idx, key) != 0) {
+    return false;
+  }
+  *value = ValueAt(idx);
+  return true;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::Insert(const VarKey &key, const RID &value, const KeyComparator &comparator) -> int {
+  InsertAt(KeyIndex(key, comparator), key, value);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+/*
+ * Move the entries past the byte midpoint to recipient, so that both halves
+ * end up with about the same free space however long their keys are. The
+ * separator the tree posts for the split becomes the fence between the two
+ * pages, both only narrow their key range and keep a prefix at least as long.
+ */
+template <typename KeyComparator>
+void VAR_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  int half = EntryBytes(0) / 2;
+  int keep = 0;
+  for (int bytes = 0; keep < GetSize() && bytes < half; keep++) {
+    bytes += static_cast<int>(sizeof(Slot)) + KeySizeAt(keep);
+  }
+  keep = std::clamp(keep, 1, GetSize() - 1);
+  VarKey separator = VarKey::ShortestSeparator(KeyAt(keep - 1), KeyAt(keep));
+  // set the fences of recipient first, so that the keys arrive without their shared prefix
+  recipient->SetLowKey(separator);
+  recipient->SetHighKey(GetHighKey());
+  CopyTo(recipient, keep);
+  Truncate(keep);
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetPrevPageId(GetPageId());
+  SetNextPageId(recipient->GetPageId());
+  SetHighKey(separator);
+}
+
+template <typename KeyComparator>
+void VAR_LEAF_PAGE_TYPE::CopyTo(BPlusTreeLeafPage *recipient, int begin) const {
+  for (int i = begin; i < GetSize(); i++) {
+    recipient->InsertAt(recipient->GetSize(), KeyAt(i), ValueAt(i));
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const VarKey &key, const KeyComparator &comparator) -> int {
+  int idx = KeyIndex(key, comparator);
+  if (idx == GetSize() || CompareKeyAt(idx, key) != 0) {
+    return GetSize();
+  }
+  RemoveAt(idx);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+/* recipient takes over the high key first, its range widens to cover the keys of this page */
+template <typename KeyComparator>
+void VAR_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  recipient->SetHighKey(GetHighKey());
+  CopyTo(recipient, 0);
+  recipient->SetNextPageId(GetNextPageId());
+  Truncate(0);
+}
+
+/*****************************************************************************
+ * REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * The fence between the pages moves to the separator the tree posts in the
+ * parent. The recipient widens its range before it takes the entry, the
+ * giving page narrows its range once the entry is gone.
+ */
+template <typename KeyComparator>
+void VAR_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  VarKey separator = VarKey::ShortestSeparator(KeyAt(0), KeyAt(1));
+  recipient->SetHighKey(separator);
+  recipient->InsertAt(recipient->GetSize(), KeyAt(0), ValueAt(0));
+  RemoveAt(0);
+  SetLowKey(separator);
+}
+
+template <typename KeyComparator>
+void VAR_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  int last = GetSize() - 1;
+  VarKey separator = VarKey::ShortestSeparator(KeyAt(last - 1), KeyAt(last));
+  recipient->SetLowKey(separator);
+  recipient->InsertAt(0, KeyAt(last), ValueAt(last));
+  RemoveAt(last);
+  SetHighKey(separator);
+}
+
+/*****************************************************************************
+ * OCCUPANCY
+ *****************************************************************************/
+/* A leaf splits once it is full after an insert, so one more entry of any length must leave it below that */
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::IsInsertSafe() const -> bool { return FreeBytes() >= 2 * MAX_ENTRY_SIZE; }
+
+/* The merged page spans both key ranges, the keys of both pages may give up part of their prefix */
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::CanAbsorb(const BPlusTreeLeafPage *sibling) const -> bool {
+  int prefix_size = FencePrefixSize(GetLowKey(), sibling->GetHighKey());
+  int restored =
+      GetSize() * (PrefixSize() - prefix_size) + sibling->GetSize() * (sibling->PrefixSize() - prefix_size);
+  return FreeBytes() - sibling->EntryBytes(0) - restored >= MAX_ENTRY_SIZE;
+}
+
+/*
+ * Whether this page can take one entry from its neighbour sibling, and both
+ * pages can take the fence keys that come with it (see MoveFirstToEndOf and
+ * MoveLastToFrontOf), leaving room for another insert in each.
+ */
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::CanBorrowFrom(const BPlusTreeLeafPage *sibling) const -> bool {
+  int last = sibling->GetSize() - 1;
+  if (GetNextPageId() == sibling->GetPageId()) {
+    VarKey separator = VarKey::ShortestSeparator(sibling->KeyAt(0), sibling->KeyAt(1));
+    int prefix_size = FencePrefixSize(GetLowKey(), separator);
+    int needed = GetSize() * (PrefixSize() - prefix_size) + static_cast<int>(sizeof(Slot)) +
+                 sibling->KeyAt(0).size_ - prefix_size;
+    int sibling_freed = static_cast<int>(sizeof(Slot)) + sibling->KeySizeAt(0) + sibling->GetLowKey().size_ -
+                        separator.size_;
+    return FreeBytes() - needed >= MAX_ENTRY_SIZE && sibling->FreeBytes() + sibling_freed >= MAX_ENTRY_SIZE;
+  }
+  VarKey separator = VarKey::ShortestSeparator(sibling->KeyAt(last - 1), sibling->KeyAt(last));
+  int prefix_size = FencePrefixSize(separator, GetHighKey());
+  int needed = separator.size_ - GetLowKey().size_ + GetSize() * (PrefixSize() - prefix_size) +
+               static_cast<int>(sizeof(Slot)) + sibling->KeyAt(last).size_ - prefix_size;
+  return FreeBytes() - needed >= MAX_ENTRY_SIZE;
+}
+
+/* Bulk loading stops filling a leaf at fill_factor of the page, but never below half of it */
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::ReachedFillFactor(double fill_factor) const -> bool {
+  return UsedBytes() >= std::max(fill_factor, 0.5) * BUSTUB_PAGE_SIZE || !IsInsertSafe();
+}
+
+template <typename KeyComparator>
+auto VAR_LEAF_PAGE_TYPE::Fill() const -> double {
+  return static_cast<double>(UsedBytes()) / BUSTUB_PAGE_SIZE;
+}
+
+template class BPlusTreeLeafPage<VarKey, RID, VarKeyComparator>;
+template class BPlusTreeLeafPage<VarKey, RID, NonUniqueComparator<VarKeyComparator>>;
+
+}  // namespace bustub
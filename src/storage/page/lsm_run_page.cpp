@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_run_page.cpp
+//
+// Identification: src/storage/page/lsm_run_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/lsm_run_page.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace bustub {
+
+void LSMRunPage::Init() {
+  size_ = 0;
+  heap_begin_ = BUSTUB_PAGE_SIZE;
+}
+
+auto LSMRunPage::GetSize() const -> int { return static_cast<int>(size_); }
+
+auto LSMRunPage::Append(std::string_view key, bool tombstone, RID value) -> bool {
+  const size_t entry_size = ENTRY_HEADER_SIZE + key.size();
+  const size_t slots_end = offsetof(LSMRunPage, slots_) + (size_ + 1) * sizeof(uint16_t);
+  if (slots_end + entry_size > heap_begin_) {
+    return false;
+  }
+  heap_begin_ -= entry_size;
+  char *entry = reinterpret_cast<char *>(this) + heap_begin_;
+  auto key_size = static_cast<uint16_t>(key.size());
+  memcpy(entry, &value, sizeof(RID));
+  memcpy(entry + sizeof(RID), &key_size, sizeof(uint16_t));
+  entry[sizeof(RID) + sizeof(uint16_t)] = static_cast<char>(tombstone);
+  memcpy(entry + ENTRY_HEADER_SIZE, key.data(), key.size());
+  slots_[size_++] = static_cast<uint16_t>(heap_begin_);
+  return true;
+}
+
+auto LSMRunPage::KeyAt(int index) const -> std::string_view {
+  const char *entry = EntryAt(index);
+  uint16_t key_size;
+  memcpy(&key_size, entry + sizeof(RID), sizeof(uint16_t));
+  return {entry + ENTRY_HEADER_SIZE, key_size};
+}
+
+auto LSMRunPage::ValueAt(int index) const -> RID {
+  RID value;
+  memcpy(&value, EntryAt(index), sizeof(RID));
+  return value;
+}
+
+auto LSMRunPage::IsTombstoneAt(int index) const -> bool {
+  return EntryAt(index)[sizeof(RID) + sizeof(uint16_t)] != 0;
+}
+
+auto LSMRunPage::LowerBound(std::string_view key) const -> int {
+  int low = 0;
+  int high = GetSize();
+  while (low < high) {
+    int mid = (low + high) / 2;
+    if (KeyAt(mid) < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+auto LSMRunPage::EntryAt(int index) const -> const char * {
+  return reinterpret_cast<const char *>(this) + slots_[index];
+}
+
+}  // namespace bustub
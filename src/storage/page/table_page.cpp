@@ -326,6 +326,21 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   return true;
 }
 
+auto TablePage::GetTupleView(const RID &rid, Tuple *tuple) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || IsDeleted(GetTupleSize(slot_num))) {
+    return false;
+  }
+  if (tuple->allocated_) {
+    delete[] tuple->data_;
+  }
+  tuple->data_ = GetData() + GetTupleOffsetAtSlot(slot_num);
+  tuple->size_ = GetTupleSize(slot_num);
+  tuple->rid_ = rid;
+  tuple->allocated_ = false;
+  return true;
+}
+
 auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
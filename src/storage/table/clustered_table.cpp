@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clustered_table.cpp
+//
+// Identification: src/storage/table/clustered_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/clustered_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+namespace {
+
+auto RowAttrs(const Schema &schema, const std::vector<uint32_t> &key_attrs) -> std::vector<uint32_t> {
+  std::vector<uint32_t> attrs(key_attrs);
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    if (std::find(key_attrs.begin(), key_attrs.end(), i) == key_attrs.end()) {
+      attrs.push_back(i);
+    }
+  }
+  return attrs;
+}
+
+}  // namespace
+
+ClusteredTable::ClusteredTable(const std::string &name, BufferPoolManager *buffer_pool_manager, const Schema &schema,
+                               std::vector<uint32_t> key_attrs)
+    : schema_(schema),
+      key_schema_(Schema::CopySchema(&schema, key_attrs)),
+      key_attrs_(std::move(key_attrs)),
+      row_schema_(Schema::CopySchema(&schema, RowAttrs(schema, key_attrs_))),
+      row_attrs_(RowAttrs(schema, key_attrs_)),
+      tree_(name, buffer_pool_manager, VarKeyComparator(nullptr)) {}
+
+auto ClusteredTable::Fits(const Schema &schema) -> bool { return VarKey::Fits(&schema); }
+
+/*****************************************************************************
+ * WRITES
+ *****************************************************************************/
+auto ClusteredTable::InsertTuple(const Tuple &tuple, Transaction *txn) -> bool {
+  VarKey key = EncodeKey(tuple.KeyFromTuple(schema_, key_schema_, key_attrs_));
+  VarKey row;
+  std::scoped_lock lock(write_latch_);
+  if (FindRow(key, &row)) {
+    return false;
+  }
+  return tree_.Insert(EncodeRow(tuple), RID(), txn);
+}
+
+/*
+ * The new row shares the primary key of the old one, so it sorts right where
+ * the old one was and mostly replaces it in place. Otherwise it takes a
+ * remove and an insert, and the old row is put back if the insert fails.
+ */
+auto ClusteredTable::UpdateTuple(const Tuple &tuple, Transaction *txn) -> bool {
+  VarKey key = EncodeKey(tuple.KeyFromTuple(schema_, key_schema_, key_attrs_));
+  VarKey row;
+  std::scoped_lock lock(write_latch_);
+  if (!FindRow(key, &row)) {
+    return false;
+  }
+  VarKey new_row = EncodeRow(tuple);
+  if (tree_.ReplaceKey(row, new_row)) {
+    return true;
+  }
+  tree_.Remove(row, txn);
+  if (tree_.Insert(new_row, RID(), txn)) {
+    return true;
+  }
+  tree_.Insert(row, RID(), txn);
+  return false;
+}
+
+auto ClusteredTable::DeleteTuple(const Tuple &key, Transaction *txn) -> bool {
+  VarKey row;
+  std::scoped_lock lock(write_latch_);
+  if (!FindRow(EncodeKey(key), &row)) {
+    return false;
+  }
+  tree_.Remove(row, txn);
+  return true;
+}
+
+/*****************************************************************************
+ * READS
+ *****************************************************************************/
+auto ClusteredTable::GetTuple(const Tuple &key, Tuple *result, __attribute__((unused)) Transaction *txn) -> bool {
+  VarKey row;
+  if (!FindRow(EncodeKey(key), &row)) {
+    return false;
+  }
+  *result = DecodeRow(row);
+  return true;
+}
+
+auto ClusteredTable::Begin() -> Iterator { return {this, tree_.Begin()}; }
+
+auto ClusteredTable::Begin(const Tuple &key) -> Iterator { return {this, tree_.Begin(EncodeKey(key))}; }
+
+void ClusteredTable::ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                               std::vector<Tuple> *result, __attribute__((unused)) Transaction *txn) {
+  VarKey low;
+  VarKey high;
+  if (low_key != nullptr) {
+    low = EncodeKey(*low_key);
+  }
+  if (high_key != nullptr) {
+    high = EncodeKey(*high_key);
+  }
+  auto iter = low_key == nullptr ? tree_.Begin() : tree_.Begin(low);
+  if (low_key != nullptr && !low_inclusive && !iter.IsEnd() && HasKey((*iter).first, low)) {
+    ++iter;
+  }
+  for (; !iter.IsEnd(); ++iter) {
+    const VarKey &row = (*iter).first;
+    if (high_key != nullptr) {
+      // a row compares greater than its own key, so the upper bound itself shows up as a prefix
+      bool at_high = HasKey(row, high);
+      if ((at_high && !high_inclusive) ||
+          (!at_high && CompareVarKeyBytes(row.data_, row.size_, high.data_, high.size_) > 0)) {
+        break;
+      }
+    }
+    result->push_back(DecodeRow(row));
+  }
+}
+
+/*****************************************************************************
+ * ENCODING
+ *****************************************************************************/
+auto ClusteredTable::EncodeKey(const Tuple &key) const -> VarKey {
+  VarKey encoded;
+  encoded.SetFromKey(key, &key_schema_);
+  return encoded;
+}
+
+auto ClusteredTable::EncodeRow(const Tuple &tuple) const -> VarKey {
+  VarKey encoded;
+  encoded.SetFromKey(tuple.KeyFromTuple(schema_, row_schema_, row_attrs_), &row_schema_);
+  return encoded;
+}
+
+auto ClusteredTable::DecodeRow(const VarKey &row) const -> Tuple {
+  auto stored = NormalizedKey::DecodeColumns(row.data_, row.size_, &row_schema_);
+  std::vector<Value> values(stored.size());
+  for (size_t i = 0; i < stored.size(); i++) {
+    values[row_attrs_[i]] = std::move(stored[i]);
+  }
+  return {std::move(values), &schema_};
+}
+
+auto ClusteredTable::HasKey(const VarKey &row, const VarKey &key) -> bool {
+  return row.size_ >= key.size_ && memcmp(row.data_, key.data_, key.size_) == 0;
+}
+
+auto ClusteredTable::FindRow(const VarKey &key, VarKey *row) -> bool {
+  auto iter = tree_.Begin(key);
+  if (iter.IsEnd() || !HasKey((*iter).first, key)) {
+    return false;
+  }
+  *row = (*iter).first;
+  return true;
+}
+
+/*****************************************************************************
+ * ITERATOR
+ *****************************************************************************/
+ClusteredTable::Iterator::Iterator(const ClusteredTable *table, TreeIterator &&iter)
+    : table_(table), iter_(std::move(iter)) {
+  Decode();
+}
+
+auto ClusteredTable::Iterator::operator++() -> Iterator & {
+  ++iter_;
+  Decode();
+  return *this;
+}
+
+void ClusteredTable::Iterator::Decode() {
+  if (!iter_.IsEnd()) {
+    tuple_ = table_->DecodeRow((*iter_).first);
+  }
+}
+
+}  // namespace bustub
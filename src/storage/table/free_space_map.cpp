@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void FreeSpaceMap::Update(page_id_t page_id, uint32_t free_space) {
+  size_t category = CategoryOf(free_space);
+  std::scoped_lock lock(latch_);
+  auto [it, inserted] = slots_.try_emplace(page_id, Slot{category, 0, false});
+  if (inserted) {
+    Link(page_id, &it->second, category);
+  } else if (it->second.category_ != category) {
+    if (!it->second.claimed_) {
+      Unlink(it->second);
+    }
+    Link(page_id, &it->second, category);
+  }
+}
+
+auto FreeSpaceMap::Claim(uint32_t size, page_id_t *page_id) -> bool {
+  // every page in a category of at least this one has room
+  size_t category = (size + CATEGORY_SIZE - 1) / CATEGORY_SIZE;
+  std::scoped_lock lock(latch_);
+  for (; category < NUM_CATEGORIES; category++) {
+    if (!categories_[category].empty()) {
+      *page_id = categories_[category].back();
+      Slot &slot = slots_[*page_id];
+      Unlink(slot);
+      slot.claimed_ = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+void FreeSpaceMap::AddClaimed(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  slots_[page_id] = Slot{NUM_CATEGORIES - 1, 0, true};
+}
+
+void FreeSpaceMap::Release(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock lock(latch_);
+  Slot &slot = slots_[page_id];
+  BUSTUB_ASSERT(slot.claimed_, "Only a claimed page can be released.");
+  slot.claimed_ = false;
+  Link(page_id, &slot, CategoryOf(free_space));
+}
+
+auto FreeSpaceMap::GetPageCount() -> size_t {
+  std::scoped_lock lock(latch_);
+  return slots_.size();
+}
+
+void FreeSpaceMap::Link(page_id_t page_id, Slot *slot, size_t category) {
+  slot->category_ = category;
+  if (!slot->claimed_) {
+    slot->index_ = categories_[category].size();
+    categories_[category].push_back(page_id);
+  }
+}
+
+void FreeSpaceMap::Unlink(const Slot &slot) {
+  // move the last page of the category into the hole this page leaves
+  auto &pages = categories_[slot.category_];
+  pages[slot.index_] = pages.back();
+  slots_[pages[slot.index_]].index_ = slot.index_;
+  pages.pop_back();
+}
+
+}  // namespace bustub
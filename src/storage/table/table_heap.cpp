@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/logger.h"
 #include "fmt/format.h"
@@ -18,12 +22,33 @@
 
 namespace bustub {
 
+namespace {
+
+/** @return the lane of the calling thread, handed out round robin so that few threads never share one */
+auto ThreadLane() -> size_t {
+  static std::atomic<size_t> next_lane{0};
+  thread_local size_t lane = next_lane.fetch_add(1);
+  return lane;
+}
+
+}  // namespace
+
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      page_id_t first_page_id)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id) {
+  // Rebuild the free space map from the page headers, which also finds the last page.
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    free_space_map_.Update(page_id, page->GetInsertableSpace());
+    last_page_id_ = page_id;
+    page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(last_page_id_, false);
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -33,6 +58,8 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
   first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  free_space_map_.Update(first_page_id_, first_page->GetInsertableSpace());
+  last_page_id_ = first_page_id_;
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
 }
 
@@ -42,55 +69,158 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
-    txn->SetState(TransactionState::ABORTED);
-    return false;
+  // Threads on different lanes insert into different pages in parallel.
+  auto &lane = insert_lanes_[ThreadLane() % INSERT_LANES];
+  std::scoped_lock lock(lane.latch_);
+  while (true) {
+    // Claim a page that the free space map says has room, and if there is none, append one.
+    if (lane.page_id_ == INVALID_PAGE_ID && !free_space_map_.Claim(tuple.size_, &lane.page_id_)) {
+      lane.page_id_ = AppendPage(txn);
+      if (lane.page_id_ == INVALID_PAGE_ID) {
+        txn->SetState(TransactionState::ABORTED);
+        return false;
+      }
+    }
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(lane.page_id_));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    page->WLatch();
+    bool inserted = page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+    if (!inserted) {
+      // The page is full, at least for this tuple. Its room drops below the size of the tuple, so that it is not
+      // claimed again for the next attempt.
+      free_space_map_.Release(lane.page_id_, page->GetInsertableSpace());
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(lane.page_id_, inserted);
+    if (inserted) {
+      // Update the transaction's write set.
+      txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+      return true;
+    }
+    lane.page_id_ = INVALID_PAGE_ID;
   }
+}
 
-  cur_page->WLatch();
-
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      next_page->WLatch();
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+auto TableHeap::InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool {
+  rids->clear();
+  rids->reserve(tuples.size());
+  size_t remaining_size = 0;
+  for (const auto &tuple : tuples) {
+    if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    remaining_size += tuple.size_;
+  }
+
+  auto &lane = insert_lanes_[ThreadLane() % INSERT_LANES];
+  std::scoped_lock lock(lane.latch_);
+  size_t next = 0;
+  while (next < tuples.size()) {
+    // While at least a page worth of tuples is left, go to an empty page rather than filling gaps.
+    uint32_t wanted = remaining_size >= BUSTUB_PAGE_SIZE ? FreeSpaceMap::EMPTY_PAGE : tuples[next].size_;
+    if (lane.page_id_ == INVALID_PAGE_ID && !free_space_map_.Claim(wanted, &lane.page_id_)) {
+      lane.page_id_ = AppendPage(txn);
+      if (lane.page_id_ == INVALID_PAGE_ID) {
         txn->SetState(TransactionState::ABORTED);
         return false;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
+    }
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(lane.page_id_));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    // Insert tuples into the page until one does not fit.
+    size_t begin = next;
+    RID rid;
+    page->WLatch();
+    while (next < tuples.size() && page->InsertTuple(tuples[next], &rid, txn, lock_manager_, log_manager_)) {
+      rids->push_back(rid);
+      remaining_size -= tuples[next].size_;
+      next++;
+    }
+    if (next < tuples.size()) {
+      free_space_map_.Release(lane.page_id_, page->GetInsertableSpace());
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(lane.page_id_, next > begin);
+    RecordInserts(*rids, begin, next, txn);
+    if (next < tuples.size()) {
+      lane.page_id_ = INVALID_PAGE_ID;
     }
   }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-  // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
   return true;
 }
 
+/*
+ * A lane whose latch is taken is in the middle of an insert, and is not idle.
+ * The room is read from the page, since inserts only update the map when a
+ * page turns out to be full.
+ */
+void TableHeap::ReleaseInsertPages() {
+  for (auto &lane : insert_lanes_) {
+    std::unique_lock lock(lane.latch_, std::try_to_lock);
+    if (!lock.owns_lock() || lane.page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(lane.page_id_));
+    if (page == nullptr) {
+      // keep the claim rather than guess the room, the lane still fills the page
+      continue;
+    }
+    page->RLatch();
+    free_space_map_.Release(lane.page_id_, page->GetInsertableSpace());
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(lane.page_id_, false);
+    lane.page_id_ = INVALID_PAGE_ID;
+  }
+}
+
+void TableHeap::RecordInserts(const std::vector<RID> &rids, size_t begin, size_t end, Transaction *txn) {
+  auto write_set = txn->GetWriteSet();
+  for (size_t i = begin; i < end;) {
+    // Slots are handed out in order on a fresh page, but may fill gaps on a used one.
+    uint32_t count = 1;
+    while (i + count < end && rids[i + count].GetPageId() == rids[i].GetPageId() &&
+           rids[i + count].GetSlotNum() == rids[i].GetSlotNum() + count) {
+      count++;
+    }
+    write_set->emplace_back(rids[i], WType::INSERT, Tuple{}, this, count);
+    i += count;
+  }
+}
+
+auto TableHeap::AppendPage(Transaction *txn) -> page_id_t {
+  std::scoped_lock lock(append_latch_);
+  auto last_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id_));
+  if (last_page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t new_page_id;
+  auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&new_page_id));
+  // If we could not create a new page, then life sucks and the caller aborts the transaction.
+  if (new_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(last_page_id_, false);
+    return INVALID_PAGE_ID;
+  }
+  // Otherwise we were able to create a new page. We initialize it before a scan can reach it.
+  new_page->WLatch();
+  last_page->WLatch();
+  last_page->SetNextPageId(new_page_id);
+  new_page->Init(new_page_id, BUSTUB_PAGE_SIZE, last_page_id_, log_manager_, txn);
+  last_page->WUnlatch();
+  new_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  last_page_id_ = new_page_id;
+  free_space_map_.AddClaimed(new_page_id);
+  return new_page_id;
+}
+
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
@@ -122,6 +252,7 @@ auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   Tuple old_tuple;
   page->WLatch();
   bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  free_space_map_.Update(rid.GetPageId(), page->GetInsertableSpace());
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
   // Update the transaction's write set.
@@ -141,6 +272,7 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
+  free_space_map_.Update(rid.GetPageId(), page->GetInsertableSpace());
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
@@ -176,24 +308,70 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   return res;
 }
 
-auto TableHeap::Begin(Transaction *txn) -> TableIterator {
-  // Start an iterator from the first page.
-  // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
-  RID rid;
-  auto page_id = first_page_id_;
-  while (page_id != INVALID_PAGE_ID) {
+auto TableHeap::ParallelScan(size_t num_workers, const std::function<void(size_t, const Tuple &)> &callback,
+                             Transaction *txn) -> bool {
+  // Collect the page chain up front so that it can be split between the workers.
+  std::vector<page_id_t> page_ids;
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
     auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      if (txn != nullptr) {
+        txn->SetState(TransactionState::ABORTED);
+      }
+      return false;
+    }
+    page_ids.push_back(page_id);
     page->RLatch();
-    // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-    auto found_tuple = page->GetFirstTupleRid(&rid);
+    auto next_page_id = page->GetNextPageId();
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
-    if (found_tuple) {
-      break;
+    page_id = next_page_id;
+  }
+
+  // A worker that cannot fetch a page stops the others; the transaction is aborted once they are joined.
+  std::atomic<bool> failed{false};
+  auto scan = [&](size_t worker, size_t begin, size_t end) {
+    Tuple tuple;
+    for (auto i = begin; i < end && !failed.load(std::memory_order_relaxed); i++) {
+      auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_ids[i]));
+      if (page == nullptr) {
+        failed.store(true, std::memory_order_relaxed);
+        return;
+      }
+      page->RLatch();
+      RID rid;
+      for (auto found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+        if (page->GetTupleView(rid, &tuple)) {
+          callback(worker, tuple);
+        }
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_ids[i], false);
     }
-    page_id = page->GetNextPageId();
+  };
+
+  num_workers = std::max<size_t>(1, std::min(num_workers, page_ids.size()));
+  std::vector<std::thread> workers;
+  for (size_t worker = 1; worker < num_workers; worker++) {
+    workers.emplace_back(scan, worker, page_ids.size() * worker / num_workers,
+                         page_ids.size() * (worker + 1) / num_workers);
+  }
+  // The calling thread scans the first run itself.
+  scan(0, 0, page_ids.size() / num_workers);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  if (failed.load() && txn != nullptr) {
+    txn->SetState(TransactionState::ABORTED);
   }
-  return {this, rid, txn};
+  return !failed.load();
+}
+
+auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+  // Start an iterator from the first page that holds a tuple.
+  TableIterator iterator(this, RID(INVALID_PAGE_ID, 0), txn);
+  iterator.Seek(first_page_id_);
+  return iterator;
 }
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
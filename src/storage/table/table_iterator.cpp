@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <cstring>
+#include <utility>
 
 #include "common/exception.h"
 #include "concurrency/transaction.h"
@@ -19,58 +21,48 @@
 namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+    : table_heap_(table_heap), tuple_(rid), txn_(txn) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+    ReadPage(rid.GetPageId());
+    if (!page_->GetTupleView(rid, &tuple_)) {
       throw bustub::Exception("read non-existing tuple");
     }
   }
 }
 
+TableIterator::TableIterator(TableIterator &&other) noexcept
+    : table_heap_(other.table_heap_), txn_(other.txn_), page_(std::move(other.page_)) {
+  // The page buffer stays where it is, so a view into it can be handed over as it is.
+  tuple_.allocated_ = other.tuple_.allocated_;
+  tuple_.rid_ = other.tuple_.rid_;
+  tuple_.size_ = other.tuple_.size_;
+  tuple_.data_ = other.tuple_.data_;
+  other.tuple_.allocated_ = false;
+  other.tuple_.data_ = nullptr;
+}
+
 auto TableIterator::operator*() -> const Tuple & {
   assert(*this != table_heap_->End());
-  return *tuple_;
+  return tuple_;
 }
 
 auto TableIterator::operator->() -> Tuple * {
   assert(*this != table_heap_->End());
-  return tuple_;
+  return &tuple_;
 }
 
 auto TableIterator::operator++() -> TableIterator & {
-  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
-
-  cur_page->RLatch();
-  RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
-        break;
-      }
-    }
+  // A copy of an iterator has no page yet.
+  if (page_ == nullptr || page_->GetTablePageId() != tuple_.rid_.GetPageId()) {
+    ReadPage(tuple_.rid_.GetPageId());
   }
-  tuple_->rid_ = next_tuple_rid;
-
-  if (*this != table_heap_->End()) {
-    // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
-    // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      throw bustub::Exception("read non-existing tuple");
-    }
+  RID next_tuple_rid;
+  if (page_->GetNextTupleRid(tuple_.rid_, &next_tuple_rid)) {
+    page_->GetTupleView(next_tuple_rid, &tuple_);
+  } else {
+    // end of this page
+    Seek(page_->GetNextPageId());
   }
-  // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
   return *this;
 }
 
@@ -80,4 +72,30 @@ auto TableIterator::operator++(int) -> TableIterator {
   return clone;
 }
 
+void TableIterator::Seek(page_id_t page_id) {
+  RID rid;
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPage(page_id);
+    if (page_->GetFirstTupleRid(&rid)) {
+      page_->GetTupleView(rid, &tuple_);
+      return;
+    }
+    page_id = page_->GetNextPageId();
+  }
+  tuple_ = Tuple(RID(INVALID_PAGE_ID, 0));
+}
+
+void TableIterator::ReadPage(page_id_t page_id) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_id));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");  // all pages are pinned
+  if (page_ == nullptr) {
+    page_ = std::make_unique<TablePage>();
+  }
+  page->RLatch();
+  memcpy(page_->GetData(), page->GetData(), BUSTUB_PAGE_SIZE);
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+}
+
 }  // namespace bustub
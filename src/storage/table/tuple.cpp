@@ -61,35 +61,30 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
+Tuple::Tuple(const Tuple &other) : allocated_(other.data_ != nullptr), rid_(other.rid_), size_(other.size_) {
+  // Deep copy, which also materializes a tuple that views a page.
   if (allocated_) {
-    delete[] data_;
-  }
-  if (allocated_) {
-    // Deep copy.
     data_ = new char[size_];
     memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
   }
 }
 
 auto Tuple::operator=(const Tuple &other) -> Tuple & {
+  if (this == &other) {
+    return *this;
+  }
   if (allocated_) {
     delete[] data_;
   }
-  allocated_ = other.allocated_;
+  allocated_ = other.data_ != nullptr;
   rid_ = other.rid_;
   size_ = other.size_;
+  data_ = nullptr;
 
+  // Deep copy, which also materializes a tuple that views a page.
   if (allocated_) {
-    // Deep copy.
     data_ = new char[size_];
     memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
   }
 
   return *this;
@@ -104,7 +99,7 @@ auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> V
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
-auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
+auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
     -> Tuple {
   std::vector<Value> values;
   values.reserve(key_attrs.size());
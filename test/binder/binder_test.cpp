@@ -13,6 +13,9 @@
 #include "binder/binder.h"
 #include <memory>
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
+#include "binder/statement/create_statement.h"
+#include "binder/statement/index_statement.h"
 #include "catalog/catalog.h"
 #include "gtest/gtest.h"
 
@@ -143,6 +146,47 @@ TEST(BinderTest, FailBindUnknownColumn) {
 
 TEST(BinderTest, BindCreateTable) { TryBind("CREATE TABLE tablex (v1 int)"); }
 
+TEST(BinderTest, BindCreateClusteredTable) {
+  auto statements = TryBind(
+      "CREATE TABLE tablex (v1 int, v2 varchar(8), PRIMARY KEY (v2, v1)) WITH (clustered); "
+      "CREATE TABLE tabley (v1 int PRIMARY KEY, v2 int) WITH (clustered)");
+  PrintStatements(statements);
+  ASSERT_EQ(statements.size(), 2);
+  const auto &x = dynamic_cast<const CreateStatement &>(*statements[0]);
+  EXPECT_TRUE(x.clustered_);
+  EXPECT_EQ(x.primary_key_, (std::vector<uint32_t>{1, 0}));
+  const auto &y = dynamic_cast<const CreateStatement &>(*statements[1]);
+  EXPECT_EQ(y.primary_key_, (std::vector<uint32_t>{0}));
+  EXPECT_THROW(TryBind("CREATE TABLE tablez (v1 int) WITH (clustered)"), Exception);
+  EXPECT_THROW(TryBind("CREATE TABLE tablez (v1 int, PRIMARY KEY (v2)) WITH (clustered)"), Exception);
+  EXPECT_THROW(TryBind("CREATE TABLE tablez (v1 int PRIMARY KEY)"), NotImplementedException);
+}
+
+TEST(BinderTest, BindAnalyze) {
+  auto statements = TryBind("ANALYZE; ANALYZE y");
+  PrintStatements(statements);
+  ASSERT_EQ(statements.size(), 2);
+  EXPECT_EQ(dynamic_cast<const AnalyzeStatement &>(*statements[0]).table_, nullptr);
+  EXPECT_EQ(dynamic_cast<const AnalyzeStatement &>(*statements[1]).table_->table_, "y");
+  EXPECT_THROW(TryBind("ANALYZE y (x)"), NotImplementedException);
+  EXPECT_THROW(TryBind("VACUUM y"), NotImplementedException);
+}
+
+TEST(BinderTest, BindCreateIndex) {
+  auto statements = TryBind("CREATE INDEX yx ON y(x); CREATE UNIQUE INDEX yz ON y USING ART (z, a)");
+  PrintStatements(statements);
+  ASSERT_EQ(statements.size(), 2);
+  EXPECT_EQ(dynamic_cast<const IndexStatement &>(*statements[0]).index_type_, "btree");
+  const auto &art = dynamic_cast<const IndexStatement &>(*statements[1]);
+  EXPECT_EQ(art.index_type_, "art");
+  EXPECT_TRUE(art.is_unique_);
+  EXPECT_EQ(art.cols_.size(), 2);
+  EXPECT_EQ(dynamic_cast<const IndexStatement &>(*TryBind("CREATE INDEX yb ON y USING LSM (b)")[0]).index_type_, "lsm");
+  EXPECT_EQ(dynamic_cast<const IndexStatement &>(*TryBind("CREATE INDEX ya ON y USING SKIPLIST (a)")[0]).index_type_,
+            "skiplist");
+  EXPECT_THROW(TryBind("CREATE INDEX yc ON y USING HASH (c)"), NotImplementedException);
+}
+
 TEST(BinderTest, BindInsert) { TryBind("INSERT INTO y VALUES (1,2,3,4,5), (6,7,8,9,10)"); }
 
 TEST(BinderTest, BindInsertSelect) { TryBind("INSERT INTO y SELECT * FROM y WHERE x < 500"); }
@@ -12,9 +12,12 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -145,4 +148,61 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// Counts the pages read from disk, which may happen on the prefetch thread
+class ReadCountingDiskManager : public DiskManager {
+ public:
+  using DiskManager::DiskManager;
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    reads_++;
+    DiskManager::ReadPage(page_id, page_data);
+  }
+
+  std::atomic<int> reads_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new ReadCountingDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // write out pages 0 to 7, the pool only keeps the last four of them
+  page_id_t page_id_temp;
+  for (int i = 0; i < 8; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(0, disk_manager->reads_);
+
+  // Scenario: a prefetched page is read in the background and is not pinned.
+  bpm->PrefetchPage(1);
+  for (int i = 0; i < 1000 && disk_manager->reads_ == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1, disk_manager->reads_);
+
+  // Scenario: fetching it then finds it in the pool without reading it again.
+  auto *page1 = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page1);
+  EXPECT_EQ(0, strcmp(page1->GetData(), "page 1"));
+  EXPECT_EQ(1, disk_manager->reads_);
+  EXPECT_EQ(1, page1->GetPinCount());
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+
+  // Scenario: the pool stops its prefetch thread with hints still queued.
+  for (int i = 0; i < 8; ++i) {
+    bpm->PrefetchPage(i);
+  }
+  delete bpm;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -19,6 +20,7 @@
 #include "catalog/table_generator.h"
 #include "execution/executor_context.h"
 #include "gtest/gtest.h"
+#include "storage/page/header_page.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -298,6 +300,902 @@ TEST(CatalogTest, DISABLED_CreateIndex3) {
   EXPECT_EQ(tuple.GetRid().Get(), index_rid[0].Get());
 }
 
+// Index creation on a populated table builds the tree bottom-up
+TEST(CatalogTest, CreateIndexBulkLoad) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+
+  Transaction txn{0};
+
+  auto exec_ctx = std::make_unique<ExecutorContext>(&txn, catalog.get(), bpm.get(), nullptr, nullptr);
+
+  TableGenerator gen{exec_ctx.get()};
+  gen.GenerateTestTables();
+
+  auto *table_info = exec_ctx->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  std::vector<Column> key_columns{Column{"A", TypeId::BIGINT}};
+  Schema key_schema{key_columns};
+
+  auto *index_info = catalog->CreateIndex<BigintKeyType, BigintValueType, BigintComparatorType>(
+      &txn, "index1", "test_1", schema, key_schema, {0}, BIGINT_SIZE, BigintHashFunctionType{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+
+  // every tuple can be found through the index
+  std::unordered_set<int64_t> keys;
+  for (auto itr = table_info->table_->Begin(&txn); itr != table_info->table_->End(); ++itr) {
+    std::vector<RID> index_rid{};
+    index_info->index_->ScanKey(itr->KeyFromTuple(schema, key_schema, index_info->index_->GetKeyAttrs()), &index_rid,
+                                &txn);
+    ASSERT_EQ(index_rid.size(), 1);
+    keys.insert(itr->GetValue(&schema, 0).CastAs(TypeId::BIGINT).GetAs<int64_t>());
+  }
+
+  // colA is an INTEGER column, so the catalog picks the native integer tree
+  auto *tree = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info->index_.get());
+  ASSERT_NE(tree, nullptr);
+
+  // and the leaves hold each distinct key once, in order
+  IntegerComparatorType comparator(&key_schema);
+  std::size_t count = 0;
+  IntegerKeyType prev_key;
+  for (auto itr = tree->GetBeginIterator(); itr != tree->GetEndIterator(); ++itr, ++count) {
+    if (count > 0) {
+      EXPECT_LT(comparator(prev_key, (*itr).first), 0);
+    }
+    prev_key = (*itr).first;
+  }
+  EXPECT_EQ(count, keys.size());
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// A unique index over duplicate keys fails before the tree takes any page
+TEST(CatalogTest, CreateIndexUniqueDuplicates) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 128);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  // enough distinct keys to fill several leaves, and a single duplicate among them
+  for (int i = 0; i <= 5000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i % 5000),
+                              ValueFactory::GetVarcharValue("key-" + std::to_string(i % 5000))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+  }
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::VARCHAR, 128}}};
+  page_id_t before_page_id;
+  bpm->NewPage(&before_page_id);
+  bpm->UnpinPage(before_page_id, false);
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "unique_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true)));
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "unique_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, true)));
+
+  // no page was allocated, and the header page holds no root for either index
+  page_id_t after_page_id;
+  bpm->NewPage(&after_page_id);
+  bpm->UnpinPage(after_page_id, false);
+  EXPECT_EQ(after_page_id, before_page_id + 1);
+  auto *header_page = reinterpret_cast<HeaderPage *>(bpm->FetchPage(header_page_id)->GetData());
+  page_id_t root_page_id;
+  EXPECT_FALSE(header_page->GetRootId("unique_a", &root_page_id));
+  EXPECT_FALSE(header_page->GetRootId("unique_b", &root_page_id));
+  bpm->UnpinPage(header_page_id, false);
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// A varchar key gets a tree over variable length keys
+TEST(CatalogTest, CreateIndexVarchar) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  // the tree records its root in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 128);
+  columns.emplace_back("C", TypeId::VARCHAR, 300);
+  columns.emplace_back("D", TypeId::VARCHAR, 250);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  for (int i = 0; i < 1000; i++) {
+    // long values that only differ at the end, which a fixed size key would cut off
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue(std::string(100, 'a') + std::to_string(i)),
+                              ValueFactory::GetVarcharValue(std::string(280, 'c') + std::to_string(i)),
+                              ValueFactory::GetVarcharValue(std::string(240, 'd') + std::to_string(i))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+  }
+
+  std::vector<Column> key_columns{Column{"B", TypeId::VARCHAR, 128}};
+  Schema key_schema{key_columns};
+  auto *index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index1", "foobar", schema, key_schema, {1}, 8, HashFunction<GenericKey<8>>{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+  using VarKeyIndex = BPlusTreeIndex<VarKey, RID, VarKeyComparator>;
+  ASSERT_NE(dynamic_cast<VarKeyIndex *>(index_info->index_.get()), nullptr);
+
+  // every tuple is found under its own key
+  for (auto itr = table_info->table_->Begin(&txn); itr != table_info->table_->End(); ++itr) {
+    std::vector<RID> index_rid{};
+    index_info->index_->ScanKey(itr->KeyFromTuple(schema, key_schema, index_info->index_->GetKeyAttrs()), &index_rid,
+                                &txn);
+    ASSERT_EQ(index_rid.size(), 1);
+    EXPECT_EQ(index_rid[0], itr->GetRid());
+  }
+
+  // keys that may not fit into a VarKey are rejected rather than truncated into collisions
+  Schema c_schema{std::vector<Column>{Column{"C", TypeId::VARCHAR, 300}}};
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_c", "foobar", schema, c_schema, {2}, 8, HashFunction<GenericKey<8>>{}, true)));
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_c", "foobar", schema, c_schema, {2}, 8, HashFunction<GenericKey<8>>{}, false)));
+  // a non-unique index also needs room for the RID behind the key
+  Schema d_schema{std::vector<Column>{Column{"D", TypeId::VARCHAR, 250}}};
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_d", "foobar", schema, d_schema, {3}, 8, HashFunction<GenericKey<8>>{}, false)));
+  EXPECT_NE(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_d", "foobar", schema, d_schema, {3}, 8, HashFunction<GenericKey<8>>{}, true)));
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Non-unique indexes keep every (key, rid) and return all rids of a key
+TEST(CatalogTest, CreateIndexNonUnique) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  // the trees record their roots in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 128);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  std::vector<std::vector<RID>> rids_by_a(10);
+  for (int i = 0; i < 1000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i % 10),
+                              ValueFactory::GetVarcharValue("status-" + std::to_string(i % 4))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+    rids_by_a[i % 10].push_back(rid);
+  }
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::VARCHAR, 128}}};
+
+  // a unique index cannot be built over duplicate keys
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "unique_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true)));
+
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, false);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  EXPECT_FALSE(a_index->index_->GetMetadata()->IsUnique());
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+  using NonUniqueVarKeyIndex = BPlusTreeIndex<VarKey, RID, NonUniqueComparator<VarKeyComparator>>;
+  ASSERT_NE(dynamic_cast<NonUniqueVarKeyIndex *>(b_index->index_.get()), nullptr);
+
+  // every key finds the rids of all its tuples, in rid order
+  for (int a = 0; a < 10; a++) {
+    std::vector<RID> index_rid{};
+    a_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(a)}, &a_schema), &index_rid, &txn);
+    EXPECT_EQ(index_rid, rids_by_a[a]);
+  }
+  for (int b = 0; b < 4; b++) {
+    std::vector<RID> index_rid{};
+    b_index->index_->ScanKey(Tuple({ValueFactory::GetVarcharValue("status-" + std::to_string(b))}, &b_schema),
+                             &index_rid, &txn);
+    EXPECT_EQ(index_rid.size(), 250);
+  }
+
+  // deleting an entry removes only the given rid among equal keys
+  Tuple key({ValueFactory::GetIntegerValue(3)}, &a_schema);
+  RID victim = rids_by_a[3][42];
+  a_index->index_->DeleteEntry(key, victim, &txn);
+  std::vector<RID> index_rid{};
+  a_index->index_->ScanKey(key, &index_rid, &txn);
+  EXPECT_EQ(index_rid.size(), 99);
+  EXPECT_EQ(std::find(index_rid.begin(), index_rid.end(), victim), index_rid.end());
+  a_index->index_->InsertEntry(key, victim, &txn);
+  index_rid.clear();
+  a_index->index_->ScanKey(key, &index_rid, &txn);
+  EXPECT_EQ(index_rid, rids_by_a[3]);
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Indexes over a single INTEGER or BIGINT column cast to the alias of their column type and uniqueness
+TEST(CatalogTest, CreateIndexIntegerAliases) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::BIGINT);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  for (int i = 0; i < 100; i++) {
+    RID rid;
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(i * 1000L)};
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+  }
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::BIGINT}}};
+  auto create = [&](const std::string &name, const Schema &key_schema, uint32_t column, bool is_unique) {
+    auto *index_info = catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+        &txn, name, "foobar", schema, key_schema, {column}, INTEGER_SIZE, IntegerHashFunctionType{}, is_unique);
+    EXPECT_NE(Catalog::NULL_INDEX_INFO, index_info);
+    return index_info->index_.get();
+  };
+  EXPECT_NE(dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(create("unique_a", a_schema, 0, true)), nullptr);
+  EXPECT_NE(dynamic_cast<BPlusTreeIndexForOneBigintColumn *>(create("unique_b", b_schema, 1, true)), nullptr);
+  EXPECT_NE(dynamic_cast<NonUniqueBPlusTreeIndexForOneBigintColumn *>(create("index_b", b_schema, 1, false)), nullptr);
+  // what a plain CREATE INDEX builds, walked like an index scan would
+  auto *tree = dynamic_cast<NonUniqueBPlusTreeIndexForOneIntegerColumn *>(create("index_a", a_schema, 0, false));
+  ASSERT_NE(tree, nullptr);
+  int count = 0;
+  for (NonUniqueBPlusTreeIndexIteratorForOneIntegerColumn it = tree->GetBeginIterator(); !it.IsEnd(); ++it) {
+    EXPECT_EQ((*it).first.ToString(), count);
+    count++;
+  }
+  EXPECT_EQ(count, 100);
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Range scans return the rids within bounds in key order, in either direction
+TEST(CatalogTest, ScanRange) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  // the trees record their roots in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 16);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  // B holds every key three times
+  auto b_value = [](int a) {
+    std::string b = std::to_string(a / 3);
+    return "k-" + std::string(3 - b.size(), '0') + b;
+  };
+  std::vector<RID> rids;
+  for (int a = 0; a < 300; a++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(b_value(a))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+    rids.push_back(rid);
+  }
+  // rids of the tuples with A in [low, high]
+  auto expected = [&rids](int low, int high, bool reverse) {
+    std::vector<RID> result(rids.begin() + low, rids.begin() + high + 1);
+    if (reverse) {
+      std::reverse(result.begin(), result.end());
+    }
+    return result;
+  };
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::VARCHAR, 16}}};
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+
+  Tuple a100({ValueFactory::GetIntegerValue(100)}, &a_schema);
+  Tuple a200({ValueFactory::GetIntegerValue(200)}, &a_schema);
+  for (bool reverse : {false, true}) {
+    std::vector<RID> result;
+    // BETWEEN 100 AND 200
+    a_index->index_->ScanRange(&a100, true, &a200, true, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(100, 200, reverse));
+    // > 100 AND < 200
+    result.clear();
+    a_index->index_->ScanRange(&a100, false, &a200, false, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(101, 199, reverse));
+    // > 200
+    result.clear();
+    a_index->index_->ScanRange(&a200, false, nullptr, false, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(201, 299, reverse));
+    // <= 100
+    result.clear();
+    a_index->index_->ScanRange(nullptr, false, &a100, true, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(0, 100, reverse));
+    // everything
+    result.clear();
+    a_index->index_->ScanRange(nullptr, false, nullptr, false, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(0, 299, reverse));
+  }
+
+  // excluded bounds of a non-unique index skip all duplicates of the bound
+  Tuple b10({ValueFactory::GetVarcharValue(b_value(30))}, &b_schema);
+  Tuple b12({ValueFactory::GetVarcharValue(b_value(36))}, &b_schema);
+  std::vector<RID> result;
+  b_index->index_->ScanRange(&b10, true, &b12, true, false, &result, &txn);
+  EXPECT_EQ(result, expected(30, 38, false));
+  result.clear();
+  b_index->index_->ScanRange(&b10, false, &b12, false, false, &result, &txn);
+  EXPECT_EQ(result, expected(33, 35, false));
+  // descending by key, equal keys come in descending rid order
+  result.clear();
+  b_index->index_->ScanRange(nullptr, false, &b10, false, true, &result, &txn);
+  EXPECT_EQ(result, expected(0, 29, true));
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Covering indexes return their included columns without reading the table
+TEST(CatalogTest, CreateIndexCovering) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  // the trees record their roots in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::BIGINT);
+  columns.emplace_back("C", TypeId::VARCHAR, 32);
+  columns.emplace_back("D", TypeId::VARCHAR, 64);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  std::vector<RID> rids;
+  for (int a = 0; a < 500; a++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetBigIntValue(a * 1000L),
+                              ValueFactory::GetVarcharValue("name-" + std::to_string(a)),
+                              ValueFactory::GetVarcharValue("")};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+    rids.push_back(rid);
+  }
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::BIGINT}}};
+  // (A) INCLUDE (B) fits into 16 bytes, (B) INCLUDE (A, C) into 64
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true, {1});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  EXPECT_EQ(a_index->index_->GetEntryAttrs(), (std::vector<uint32_t>{0, 1}));
+  using CoveringIndex = BPlusTreeIndex<GenericKey<16>, RID, CoveringComparator<GenericComparator<16>>>;
+  ASSERT_NE(dynamic_cast<CoveringIndex *>(a_index->index_.get()), nullptr);
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false, {0, 2});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+
+  // the entries carry the included columns, in key order
+  Tuple a100({ValueFactory::GetIntegerValue(100)}, &a_schema);
+  Tuple a109({ValueFactory::GetIntegerValue(109)}, &a_schema);
+  std::vector<Tuple> entries;
+  a_index->index_->ScanRangeEntries(&a100, true, &a109, false, false, &entries, &txn);
+  ASSERT_EQ(entries.size(), 9);
+  for (int i = 0; i < 9; i++) {
+    auto *entry_schema = a_index->index_->GetEntrySchema();
+    EXPECT_EQ(entries[i].GetValue(entry_schema, 0).GetAs<int32_t>(), 100 + i);
+    EXPECT_EQ(entries[i].GetValue(entry_schema, 1).GetAs<int64_t>(), (100 + i) * 1000L);
+    EXPECT_EQ(entries[i].GetRid(), rids[100 + i]);
+  }
+  entries.clear();
+  Tuple b_high({ValueFactory::GetBigIntValue(2000)}, &b_schema);
+  b_index->index_->ScanRangeEntries(nullptr, false, &b_high, true, true, &entries, &txn);
+  ASSERT_EQ(entries.size(), 3);
+  for (int i = 0; i < 3; i++) {
+    auto *entry_schema = b_index->index_->GetEntrySchema();
+    EXPECT_EQ(entries[i].GetValue(entry_schema, 0).GetAs<int64_t>(), (2 - i) * 1000L);
+    EXPECT_EQ(entries[i].GetValue(entry_schema, 1).GetAs<int32_t>(), 2 - i);
+    EXPECT_EQ(entries[i].GetValue(entry_schema, 2).ToString(), "name-" + std::to_string(2 - i));
+  }
+
+  // lookups and uniqueness only consider the key columns
+  std::vector<RID> result;
+  a_index->index_->ScanKey(a100, &result, &txn);
+  EXPECT_EQ(result, std::vector<RID>{rids[100]});
+  Schema *a_entry_schema = a_index->index_->GetEntrySchema();
+  Tuple stale({ValueFactory::GetIntegerValue(100), ValueFactory::GetBigIntValue(-1)}, a_entry_schema);
+  a_index->index_->InsertEntry(stale, RID(0, 0), &txn);
+  result.clear();
+  a_index->index_->ScanKey(a100, &result, &txn);
+  EXPECT_EQ(result, std::vector<RID>{rids[100]});
+  Tuple entry({ValueFactory::GetIntegerValue(100), ValueFactory::GetBigIntValue(100000)}, a_entry_schema);
+  a_index->index_->DeleteEntry(entry, rids[100], &txn);
+  result.clear();
+  a_index->index_->ScanKey(a100, &result, &txn);
+  EXPECT_TRUE(result.empty());
+
+  // included columns too wide for any key are rejected
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_wide", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true, {3})));
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Point lookups on hot leaves are answered by the adaptive hash index, deletes invalidate it
+TEST(CatalogTest, AdaptiveHashIndex) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  // the trees record their roots in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  std::vector<RID> rids;
+  for (int a = 0; a < 1000; a++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(a % 10)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+    rids.push_back(rid);
+  }
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::INTEGER}}};
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  auto *tree_index = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(a_index->index_.get());
+  ASSERT_NE(tree_index, nullptr);
+  ASSERT_TRUE(tree_index->SetAdaptiveHashIndex(true));
+  // non-unique indexes keep using the tree
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+  using NonUniqueIntegerIndex = BPlusTreeIndex<NonUniqueKey<IntegerKey<int32_t>>, RID,
+                                               NonUniqueComparator<IntegerKeyComparator<int32_t>>>;
+  auto *non_unique_index = dynamic_cast<NonUniqueIntegerIndex *>(b_index->index_.get());
+  ASSERT_NE(non_unique_index, nullptr);
+  EXPECT_FALSE(non_unique_index->SetAdaptiveHashIndex(true));
+
+  // repeated lookups of a few hot keys end up in the hash
+  for (int round = 0; round < 50; round++) {
+    for (int a = 0; a < 10; a++) {
+      std::vector<RID> result;
+      a_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(a)}, &a_schema), &result, &txn);
+      ASSERT_EQ(result, std::vector<RID>{rids[a]});
+    }
+  }
+  auto stats = tree_index->GetAdaptiveHashIndexStats();
+  EXPECT_GT(stats.leaves_built_, 0);
+  EXPECT_GT(stats.entries_, 0);
+  EXPECT_GT(stats.HitRate(), 0.5);
+
+  // a deleted key is not found in the hash, a reinserted one finds its new rid
+  Tuple key({ValueFactory::GetIntegerValue(5)}, &a_schema);
+  a_index->index_->DeleteEntry(key, rids[5], &txn);
+  std::vector<RID> result;
+  a_index->index_->ScanKey(key, &result, &txn);
+  EXPECT_TRUE(result.empty());
+  a_index->index_->InsertEntry(key, RID(42, 42), &txn);
+  for (int round = 0; round < 50; round++) {
+    result.clear();
+    a_index->index_->ScanKey(key, &result, &txn);
+    ASSERT_EQ(result, std::vector<RID>{RID(42, 42)});
+  }
+
+  // disabling drops the hash
+  EXPECT_TRUE(tree_index->SetAdaptiveHashIndex(false));
+  EXPECT_EQ(tree_index->GetAdaptiveHashIndexStats().entries_, 0);
+  result.clear();
+  a_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(7)}, &a_schema), &result, &txn);
+  EXPECT_EQ(result, std::vector<RID>{rids[7]});
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Adaptive radix tree indexes answer point and range lookups like B+ tree indexes do, outside the buffer pool
+TEST(CatalogTest, CreateIndexART) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 16);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  // B holds every key three times
+  auto b_value = [](int a) {
+    std::string b = std::to_string(a / 3);
+    return "k-" + std::string(3 - b.size(), '0') + b;
+  };
+  std::vector<RID> rids;
+  for (int a = 0; a < 300; a++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(b_value(a))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+    rids.push_back(rid);
+  }
+  auto expected = [&rids](int low, int high, bool reverse) {
+    std::vector<RID> result(rids.begin() + low, rids.begin() + high + 1);
+    if (reverse) {
+      std::reverse(result.begin(), result.end());
+    }
+    return result;
+  };
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::VARCHAR, 16}}};
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true, {},
+      IndexType::ARTIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  EXPECT_EQ(a_index->index_type_, IndexType::ARTIndex);
+  ASSERT_NE(dynamic_cast<ARTIndex *>(a_index->index_.get()), nullptr);
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false, {},
+      IndexType::ARTIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+  // duplicate keys make a unique index fail, included columns are not supported
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_c", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, true, {},
+                IndexType::ARTIndex)));
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_d", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true, {1},
+                IndexType::ARTIndex)));
+
+  for (int a = 0; a < 300; a += 7) {
+    std::vector<RID> result;
+    a_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(a)}, &a_schema), &result, &txn);
+    EXPECT_EQ(result, std::vector<RID>{rids[a]});
+    result.clear();
+    b_index->index_->ScanKey(Tuple({ValueFactory::GetVarcharValue(b_value(a))}, &b_schema), &result, &txn);
+    EXPECT_EQ(result, expected(a / 3 * 3, a / 3 * 3 + 2, false));
+  }
+
+  Tuple a100({ValueFactory::GetIntegerValue(100)}, &a_schema);
+  Tuple a200({ValueFactory::GetIntegerValue(200)}, &a_schema);
+  Tuple b10({ValueFactory::GetVarcharValue(b_value(30))}, &b_schema);
+  Tuple b12({ValueFactory::GetVarcharValue(b_value(36))}, &b_schema);
+  for (bool reverse : {false, true}) {
+    std::vector<RID> result;
+    a_index->index_->ScanRange(&a100, true, &a200, true, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(100, 200, reverse));
+    result.clear();
+    a_index->index_->ScanRange(&a100, false, &a200, false, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(101, 199, reverse));
+    result.clear();
+    b_index->index_->ScanRange(&b10, true, &b12, true, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(30, 38, reverse));
+    result.clear();
+    b_index->index_->ScanRange(&b10, false, &b12, false, reverse, &result, &txn);
+    EXPECT_EQ(result, expected(33, 35, reverse));
+  }
+
+  // entries decode from the stored keys
+  std::vector<Tuple> entries;
+  a_index->index_->ScanRangeEntries(&a100, true, &a100, true, false, &entries, &txn);
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0].GetValue(&a_schema, 0).GetAs<int32_t>(), 100);
+  EXPECT_EQ(entries[0].GetRid(), rids[100]);
+  entries.clear();
+  b_index->index_->ScanRangeEntries(&b10, true, &b10, true, false, &entries, &txn);
+  ASSERT_EQ(entries.size(), 3);
+  EXPECT_EQ(entries[2].GetValue(&b_schema, 0).ToString(), b_value(30));
+
+  // deleting picks out the entry of one rid among equal keys
+  b_index->index_->DeleteEntry(b10, rids[31], &txn);
+  a_index->index_->DeleteEntry(a100, rids[100], &txn);
+  std::vector<RID> result;
+  b_index->index_->ScanKey(b10, &result, &txn);
+  EXPECT_EQ(result, (std::vector<RID>{rids[30], rids[32]}));
+  result.clear();
+  a_index->index_->ScanKey(a100, &result, &txn);
+  EXPECT_TRUE(result.empty());
+  a_index->index_->InsertEntry(a100, RID(42, 42), &txn);
+  a_index->index_->ScanKey(a100, &result, &txn);
+  EXPECT_EQ(result, std::vector<RID>{RID(42, 42)});
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// Log-structured merge tree indexes are bulk loaded from the table and take blind writes afterwards
+TEST(CatalogTest, CreateIndexLSM) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  // B holds every key three times
+  std::vector<RID> rids;
+  for (int a = 0; a < 300; a++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(a / 3)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+    rids.push_back(rid);
+  }
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::INTEGER}}};
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true, {},
+      IndexType::LSMIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  EXPECT_EQ(a_index->index_type_, IndexType::LSMIndex);
+  ASSERT_NE(dynamic_cast<LSMIndex *>(a_index->index_.get()), nullptr);
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false, {},
+      IndexType::LSMIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+  // duplicate keys make a unique index fail
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_c", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, true, {},
+                IndexType::LSMIndex)));
+
+  for (int a = 0; a < 300; a += 7) {
+    std::vector<RID> result;
+    a_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(a)}, &a_schema), &result, &txn);
+    EXPECT_EQ(result, std::vector<RID>{rids[a]});
+    result.clear();
+    b_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(a / 3)}, &b_schema), &result, &txn);
+    EXPECT_EQ(result, std::vector<RID>(rids.begin() + a / 3 * 3, rids.begin() + a / 3 * 3 + 3));
+  }
+
+  // writes after the build shadow the loaded entries
+  Tuple a100({ValueFactory::GetIntegerValue(100)}, &a_schema);
+  Tuple a200({ValueFactory::GetIntegerValue(200)}, &a_schema);
+  Tuple b10({ValueFactory::GetIntegerValue(10)}, &b_schema);
+  a_index->index_->DeleteEntry(a200, rids[200], &txn);
+  a_index->index_->DeleteEntry(a100, rids[100], &txn);
+  a_index->index_->InsertEntry(a100, RID(42, 42), &txn);
+  // a unique index keeps the first RID of a key, like the other index types
+  a_index->index_->InsertEntry(a100, RID(43, 43), &txn);
+  b_index->index_->DeleteEntry(b10, rids[31], &txn);
+  std::vector<RID> result;
+  a_index->index_->ScanRange(&a100, true, &a200, true, true, &result, &txn);
+  std::vector<RID> expected(rids.rbegin() + 100, rids.rbegin() + 200);
+  expected.back() = RID(42, 42);
+  EXPECT_EQ(result, expected);
+  result.clear();
+  b_index->index_->ScanKey(b10, &result, &txn);
+  EXPECT_EQ(result, (std::vector<RID>{rids[30], rids[32]}));
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+TEST(CatalogTest, CreateIndexSkipList) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn{0};
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  // B holds every key three times
+  std::vector<RID> rids;
+  for (int a = 0; a < 300; a++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(a / 3)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, &txn));
+    rids.push_back(rid);
+  }
+
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::INTEGER}}};
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true, {},
+      IndexType::SkipListIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  EXPECT_EQ(a_index->index_type_, IndexType::SkipListIndex);
+  ASSERT_NE(dynamic_cast<SkipListIndex *>(a_index->index_.get()), nullptr);
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false, {},
+      IndexType::SkipListIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+  // duplicate keys make a unique index fail
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_c", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, true, {},
+                IndexType::SkipListIndex)));
+
+  for (int a = 0; a < 300; a += 7) {
+    std::vector<RID> result;
+    a_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(a)}, &a_schema), &result, &txn);
+    EXPECT_EQ(result, std::vector<RID>{rids[a]});
+    result.clear();
+    b_index->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(a / 3)}, &b_schema), &result, &txn);
+    EXPECT_EQ(result, std::vector<RID>(rids.begin() + a / 3 * 3, rids.begin() + a / 3 * 3 + 3));
+  }
+
+  Tuple a100({ValueFactory::GetIntegerValue(100)}, &a_schema);
+  Tuple a200({ValueFactory::GetIntegerValue(200)}, &a_schema);
+  Tuple b10({ValueFactory::GetIntegerValue(10)}, &b_schema);
+  a_index->index_->DeleteEntry(a200, rids[200], &txn);
+  b_index->index_->DeleteEntry(b10, rids[31], &txn);
+  std::vector<RID> result;
+  a_index->index_->ScanRange(&a100, false, &a200, true, false, &result, &txn);
+  EXPECT_EQ(result, std::vector<RID>(rids.begin() + 101, rids.begin() + 200));
+  result.clear();
+  b_index->index_->ScanKey(b10, &result, &txn);
+  EXPECT_EQ(result, (std::vector<RID>{rids[30], rids[32]}));
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+TEST(CatalogTest, CreateClusteredTable) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  // the tree registers its root in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn{0};
+
+  Schema schema{std::vector<Column>{Column{"A", TypeId::INTEGER}, Column{"B", TypeId::VARCHAR, 16}}};
+  auto *table_info = catalog->CreateClusteredTable(&txn, "foobar", schema, {1});
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  EXPECT_EQ(table_info->table_, nullptr);
+  ASSERT_NE(table_info->clustered_table_, nullptr);
+  EXPECT_EQ(catalog->GetTable("foobar"), table_info);
+  // names are shared with heap tables, rows must fit into a tree entry, and there are no secondary indexes
+  EXPECT_EQ(Catalog::NULL_TABLE_INFO, catalog->CreateTable(&txn, "foobar", schema));
+  EXPECT_EQ(Catalog::NULL_TABLE_INFO, catalog->CreateClusteredTable(&txn, "nokey", schema, {}));
+  Schema wide_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}, Column{"B", TypeId::VARCHAR, 1000}}};
+  EXPECT_EQ(Catalog::NULL_TABLE_INFO, catalog->CreateClusteredTable(&txn, "wide", wide_schema, {0}));
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{})));
+
+  auto *table = table_info->clustered_table_.get();
+  for (int a = 0; a < 100; a++) {
+    Tuple row({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue("key " + std::to_string(1099 - a))},
+              &schema);
+    ASSERT_TRUE(table->InsertTuple(row, &txn));
+  }
+  int a = 99;
+  for (auto it = table->Begin(); !it.IsEnd(); ++it, a--) {
+    EXPECT_EQ((*it).GetValue(&schema, 0).GetAs<int32_t>(), a);
+  }
+  EXPECT_EQ(a, -1);
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+TEST(CatalogTest, AnalyzeTable) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  // the trees register their roots in the header page, which must not be the first page of the table
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  Transaction txn{0};
+
+  Schema schema{std::vector<Column>{Column{"A", TypeId::INTEGER}, Column{"B", TypeId::INTEGER}}};
+  auto *table_info = catalog->CreateTable(&txn, "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  // B holds every key three times
+  for (int a = 0; a < 3000; a++) {
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(
+        Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(a / 3)}, &schema), &rid, &txn));
+  }
+  Schema a_schema{std::vector<Column>{Column{"A", TypeId::INTEGER}}};
+  Schema b_schema{std::vector<Column>{Column{"B", TypeId::INTEGER}}};
+  auto *a_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{});
+  auto *b_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "foobar", schema, b_schema, {1}, 8, HashFunction<GenericKey<8>>{}, false);
+  auto *art_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_art", "foobar", schema, a_schema, {0}, 8, HashFunction<GenericKey<8>>{}, true, {},
+      IndexType::ARTIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, a_index);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, b_index);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, art_index);
+  EXPECT_FALSE(a_index->stats_.has_value());
+
+  // only the B+ trees keep statistics
+  EXPECT_EQ(catalog->AnalyzeTable(&txn, "foobar"), 2);
+  EXPECT_EQ(catalog->AnalyzeTable(&txn, "missing"), 0);
+  EXPECT_FALSE(art_index->stats_.has_value());
+  ASSERT_TRUE(a_index->stats_.has_value());
+  ASSERT_TRUE(b_index->stats_.has_value());
+  const auto &a_stats = *a_index->stats_;
+  const auto &b_stats = *b_index->stats_;
+  EXPECT_GE(a_stats.height_, 2);
+  EXPECT_NEAR(a_stats.entries_, 3000, 600);
+  EXPECT_DOUBLE_EQ(a_stats.distinct_keys_, a_stats.entries_);
+  EXPECT_NEAR(b_stats.entries_, 3000, 600);
+  EXPECT_NEAR(b_stats.distinct_keys_, 1000, 200);
+  EXPECT_EQ(a_stats.lowest_.GetAs<int32_t>(), 0);
+  EXPECT_NEAR(b_stats.EstimateEqual(ValueFactory::GetIntegerValue(500)), 3, 1);
+  Value low = ValueFactory::GetIntegerValue(1000);
+  Value high = ValueFactory::GetIntegerValue(1999);
+  EXPECT_NEAR(a_stats.EstimateRange(&low, &high), 1000, 250);
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
 // Vanilla index queries by name
 TEST(CatalogTest, DISABLED_QueryIndex1) {
   auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
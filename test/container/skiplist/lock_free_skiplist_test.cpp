@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_skiplist_test.cpp
+//
+// Identification: test/container/skiplist/lock_free_skiplist_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/skiplist/lock_free_skiplist.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LockFreeSkipListTest, InsertRemoveLookupTest) {
+  LockFreeSkipList<int, int> list;
+  std::map<int, int> reference;
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 20000; i++) {
+    int key = static_cast<int>(rng() % 3000);
+    if (i % 3 == 2) {
+      EXPECT_EQ(list.Remove(key), reference.erase(key) == 1) << key;
+    } else {
+      EXPECT_EQ(list.Insert(key, i), reference.emplace(key, i).second) << key;
+    }
+  }
+  EXPECT_EQ(list.Size(), reference.size());
+  for (int key = -1; key <= 3000; key++) {
+    int value;
+    auto it = reference.find(key);
+    ASSERT_EQ(list.Lookup(key, &value), it != reference.end()) << key;
+    if (it != reference.end()) {
+      EXPECT_EQ(value, it->second);
+    }
+  }
+
+  // forward iteration, from the start and from within the list
+  auto expected = reference.begin();
+  for (auto it = list.Begin(); !it.IsEnd(); ++it, ++expected) {
+    ASSERT_NE(expected, reference.end());
+    EXPECT_EQ(it.Key(), expected->first);
+    EXPECT_EQ(it.Value(), expected->second);
+  }
+  EXPECT_EQ(expected, reference.end());
+  for (int key = -1; key <= 3000; key += 37) {
+    auto it = list.LowerBound(key);
+    auto ref = reference.lower_bound(key);
+    ASSERT_EQ(it.IsEnd(), ref == reference.end());
+    if (ref != reference.end()) {
+      EXPECT_EQ(it.Key(), ref->first);
+    }
+  }
+}
+
+TEST(LockFreeSkipListTest, ComparatorTest) {
+  LockFreeSkipList<std::string, int, std::greater<>> list;
+  EXPECT_TRUE(list.Insert("a", 1));
+  EXPECT_TRUE(list.Insert("c", 3));
+  EXPECT_TRUE(list.Insert("b", 2));
+  EXPECT_FALSE(list.Insert("b", 4));
+  std::vector<std::string> keys;
+  for (auto it = list.Begin(); !it.IsEnd(); ++it) {
+    keys.push_back(it.Key());
+  }
+  EXPECT_EQ(keys, (std::vector<std::string>{"c", "b", "a"}));
+  EXPECT_EQ(list.LowerBound("bb").Key(), "b");
+}
+
+TEST(LockFreeSkipListTest, ConcurrentTest) {
+  LockFreeSkipList<int, int> list;
+  const int num_threads = 4;
+  const int keys_per_thread = 20000;
+  // every writer inserts its own keys, removes every other one, and races the others on a shared range of keys
+  std::atomic<int> shared_inserted{0};
+  std::atomic<int> shared_removed{0};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < num_threads; t++) {
+    writers.emplace_back([&, t]() {
+      for (int i = 0; i < keys_per_thread; i++) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(list.Insert(key, key));
+        if (i % 2 == 1) {
+          EXPECT_TRUE(list.Remove(key - num_threads));
+        }
+        int shared = -1 - i % 100;
+        if (list.Insert(shared, t)) {
+          shared_inserted++;
+        }
+        if (list.Remove(shared)) {
+          shared_removed++;
+        }
+      }
+    });
+  }
+  std::atomic<bool> done{false};
+  std::thread reader([&]() {
+    while (!done) {
+      // strictly increasing keys
+      int last = std::numeric_limits<int>::min();
+      for (auto it = list.Begin(); !it.IsEnd(); ++it) {
+        EXPECT_LT(last, it.Key());
+        last = it.Key();
+      }
+    }
+  });
+  for (auto &thread : writers) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(shared_inserted.load(), shared_removed.load());
+  ASSERT_EQ(list.Size(), num_threads * keys_per_thread / 2);
+  int i = 0;
+  for (auto it = list.Begin(); !it.IsEnd(); ++it, i++) {
+    // every writer keeps the odd i
+    int key = (i / num_threads * 2 + 1) * num_threads + i % num_threads;
+    ASSERT_EQ(it.Key(), key);
+  }
+}
+
+}  // namespace bustub
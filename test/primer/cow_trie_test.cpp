@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cow_trie_test.cpp
+//
+// Identification: test/primer/cow_trie_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "primer/cow_trie.h"
+
+namespace bustub {
+
+TEST(CowTrieTest, InsertRemoveTest) {
+  CowTrie trie;
+  bool success = false;
+  EXPECT_FALSE(trie.Insert("", 5));
+  EXPECT_TRUE(trie.Insert("abc", 5));
+  EXPECT_TRUE(trie.Insert("ab", std::string("ab")));
+  EXPECT_TRUE(trie.Insert("abcd", 7));
+  EXPECT_FALSE(trie.Insert("abc", 6));
+
+  EXPECT_EQ(trie.GetValue<int>("abc", &success), 5);
+  EXPECT_TRUE(success);
+  EXPECT_EQ(trie.GetValue<std::string>("ab", &success), "ab");
+  EXPECT_TRUE(success);
+  trie.GetValue<int>("ab", &success);
+  EXPECT_FALSE(success);
+  trie.GetValue<int>("a", &success);
+  EXPECT_FALSE(success);
+  trie.GetValue<int>("abcde", &success);
+  EXPECT_FALSE(success);
+
+  // Put overwrites, also with a value of another type
+  EXPECT_TRUE(trie.Put("abc", 6));
+  EXPECT_EQ(trie.GetValue<int>("abc", &success), 6);
+  EXPECT_TRUE(trie.Put("ab", 3));
+  EXPECT_EQ(trie.GetValue<int>("ab", &success), 3);
+  EXPECT_TRUE(success);
+
+  EXPECT_FALSE(trie.Remove("a"));
+  EXPECT_FALSE(trie.Remove("abcde"));
+  EXPECT_TRUE(trie.Remove("abc"));
+  EXPECT_FALSE(trie.Remove("abc"));
+  trie.GetValue<int>("abc", &success);
+  EXPECT_FALSE(success);
+  EXPECT_EQ(trie.GetValue<int>("abcd", &success), 7);
+  EXPECT_TRUE(success);
+
+  EXPECT_TRUE(trie.Remove("abcd"));
+  EXPECT_TRUE(trie.Remove("ab"));
+  EXPECT_EQ(trie.GetSnapshot().GetRoot(), nullptr);
+}
+
+TEST(CowTrieTest, SnapshotTest) {
+  CowTrie trie;
+  EXPECT_TRUE(trie.Insert("config.a", 1));
+  EXPECT_TRUE(trie.Insert("config.b", 2));
+  EXPECT_TRUE(trie.Insert("table", std::make_unique<int>(3)));
+  auto before = trie.GetSnapshot();
+  const int *a = before.Get<int>("config.a");
+  ASSERT_NE(a, nullptr);
+
+  EXPECT_TRUE(trie.Put("config.a", 10));
+  EXPECT_TRUE(trie.Remove("config.b"));
+  EXPECT_TRUE(trie.Insert("config.c", 4));
+  auto after = trie.GetSnapshot();
+
+  // the old version is unaffected, and its values stay valid
+  EXPECT_EQ(*a, 1);
+  EXPECT_EQ(*before.Get<int>("config.b"), 2);
+  EXPECT_EQ(before.Get<int>("config.c"), nullptr);
+  EXPECT_EQ(*after.Get<int>("config.a"), 10);
+  EXPECT_EQ(after.Get<int>("config.b"), nullptr);
+  EXPECT_EQ(*after.Get<int>("config.c"), 4);
+  EXPECT_EQ(**after.Get<std::unique_ptr<int>>("table"), 3);
+
+  // the subtree of the untouched key is shared between the versions
+  EXPECT_EQ(before.GetRoot()->GetChildNode('t'), after.GetRoot()->GetChildNode('t'));
+  EXPECT_NE(before.GetRoot()->GetChildNode('c'), after.GetRoot()->GetChildNode('c'));
+
+  // an old version goes away with its last snapshot
+  std::weak_ptr<const CowTrieNode> old_root = before.GetRoot();
+  before = CowTrieSnapshot();
+  EXPECT_TRUE(old_root.expired());
+}
+
+TEST(CowTrieTest, ConcurrentTest) {
+  CowTrie trie;
+  constexpr int num_words = 1000;
+  constexpr int num_bits = 10;
+  constexpr int num_rounds = 5;
+  for (int i = 0; i < num_words; i++) {
+    EXPECT_TRUE(trie.Insert(std::bitset<num_bits>(i).to_string(), i));
+  }
+
+  // writers keep rewriting the values of their keys while readers check that every version they see is consistent
+  std::atomic<bool> done{false};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; t++) {
+    writers.emplace_back([&trie, t]() {
+      for (int round = 1; round <= num_rounds; round++) {
+        for (int i = t; i < num_words; i += 2) {
+          std::string key = std::bitset<num_bits>(i).to_string();
+          if (i % 3 == 0) {
+            EXPECT_TRUE(trie.Remove(key));
+            EXPECT_TRUE(trie.Insert(key, i + round * num_words));
+          } else {
+            EXPECT_TRUE(trie.Put(key, i + round * num_words));
+          }
+        }
+      }
+    });
+  }
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&trie, &done]() {
+      while (!done) {
+        auto snapshot = trie.GetSnapshot();
+        for (int i = 0; i < num_words; i += 7) {
+          const int *value = snapshot.Get<int>(std::bitset<num_bits>(i).to_string());
+          if (value != nullptr) {
+            EXPECT_EQ(*value % num_words, i);
+          } else {
+            EXPECT_EQ(i % 3, 0);
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : writers) {
+    thread.join();
+  }
+  done = true;
+  for (auto &thread : readers) {
+    thread.join();
+  }
+
+  bool success = false;
+  for (int i = 0; i < num_words; i++) {
+    EXPECT_EQ(trie.GetValue<int>(std::bitset<num_bits>(i).to_string(), &success), i + num_rounds * num_words);
+    EXPECT_TRUE(success);
+  }
+}
+
+}  // namespace bustub
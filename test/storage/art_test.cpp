@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_test.cpp
+//
+// Identification: test/storage/art_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+auto IntegerKey(int64_t key) -> std::string {
+  std::string encoded(sizeof(int64_t), '\0');
+  NormalizedKey::EncodeInteger(key, encoded.data(), encoded.size());
+  return encoded;
+}
+
+/* A varchar key: the non-null flag, the characters and the terminator */
+auto StringKey(const std::string &str) -> std::string { return std::string(1, '\1') + str + std::string(1, '\0'); }
+
+auto ScanAll(const AdaptiveRadixTree &tree, const std::string *low, bool low_inclusive, const std::string *high,
+             bool high_inclusive) -> std::vector<std::string> {
+  std::vector<std::string> keys;
+  tree.Scan(low, low_inclusive, high, high_inclusive,
+            [&keys](const std::string &key, RID rid) { keys.push_back(key); });
+  return keys;
+}
+
+TEST(AdaptiveRadixTreeTest, InsertLookupRemoveTest) {
+  AdaptiveRadixTree tree;
+  // dense keys fill Node256s at the last byte, and groups of 3, 10 and 30 keys that share all other bytes make a
+  // Node4, a Node16 and a Node48
+  std::vector<int64_t> keys(10000);
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  for (int64_t group : {1, 2, 3}) {
+    for (int64_t i = 0; i < (group == 1 ? 3 : group == 2 ? 10 : 30); i++) {
+      keys.push_back((group << 40) + i * 5);
+    }
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(15445));
+
+  for (auto key : keys) {
+    EXPECT_TRUE(tree.Insert(IntegerKey(key), RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key))));
+  }
+  EXPECT_FALSE(tree.Insert(IntegerKey(keys[0]), RID()));
+  EXPECT_EQ(tree.Size(), keys.size());
+  auto counts = tree.GetNodeCounts();
+  for (auto count : counts) {
+    EXPECT_GT(count, 0);
+  }
+
+  RID rid;
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Lookup(IntegerKey(key), &rid));
+    EXPECT_EQ(rid.GetSlotNum(), static_cast<uint32_t>(key));
+  }
+  EXPECT_FALSE(tree.Lookup(IntegerKey(-1), &rid));
+  EXPECT_FALSE(tree.Lookup(IntegerKey((1L << 40) + 1), &rid));
+
+  // removing all but three keys shrinks the nodes and collapses the paths again, down to the root and a Node4
+  for (auto key : keys) {
+    if (key >= 10000 || key % 3500 != 0) {
+      EXPECT_TRUE(tree.Remove(IntegerKey(key)));
+    }
+  }
+  EXPECT_FALSE(tree.Remove(IntegerKey(1)));
+  EXPECT_EQ(tree.Size(), 3);
+  counts = tree.GetNodeCounts();
+  EXPECT_EQ(counts, (std::array<size_t, 4>{1, 0, 0, 1}));
+  for (auto key : keys) {
+    EXPECT_EQ(tree.Lookup(IntegerKey(key), &rid), key < 10000 && key % 3500 == 0);
+  }
+}
+
+TEST(AdaptiveRadixTreeTest, LongPrefixTest) {
+  // keys share prefixes far longer than a node stores, and diverge within and past them
+  AdaptiveRadixTree tree;
+  std::string common(40, 'x');
+  std::vector<std::string> strings{common + "a", common + "b", common.substr(0, 3) + "y", common.substr(0, 20) + "z",
+                                   common + "ab", common.substr(0, 12), "a", ""};
+  for (const auto &str : strings) {
+    EXPECT_TRUE(tree.Insert(StringKey(str), RID(0, static_cast<uint32_t>(str.size()))));
+  }
+  RID rid;
+  for (const auto &str : strings) {
+    ASSERT_TRUE(tree.Lookup(StringKey(str), &rid)) << str;
+    EXPECT_EQ(rid.GetSlotNum(), str.size());
+  }
+  EXPECT_FALSE(tree.Lookup(StringKey(common.substr(0, 20) + "a"), &rid));
+  EXPECT_FALSE(tree.Lookup(StringKey(common.substr(0, 30) + "a"), &rid));
+
+  std::sort(strings.begin(), strings.end());
+  auto scanned = ScanAll(tree, nullptr, false, nullptr, false);
+  ASSERT_EQ(scanned.size(), strings.size());
+  for (size_t i = 0; i < strings.size(); i++) {
+    EXPECT_EQ(scanned[i], StringKey(strings[i]));
+  }
+
+  for (const auto &str : strings) {
+    EXPECT_TRUE(tree.Remove(StringKey(str)));
+    EXPECT_FALSE(tree.Lookup(StringKey(str), &rid));
+  }
+  EXPECT_EQ(tree.Size(), 0);
+}
+
+TEST(AdaptiveRadixTreeTest, ScanTest) {
+  AdaptiveRadixTree tree;
+  std::map<std::string, int64_t> reference;
+  std::mt19937_64 rng(15445);
+  for (int i = 0; i < 5000; i++) {
+    auto key = static_cast<int64_t>(rng() % 100000) - 50000;
+    if (tree.Insert(IntegerKey(key), RID())) {
+      reference[IntegerKey(key)] = key;
+    }
+  }
+
+  for (int i = 0; i < 200; i++) {
+    auto low_key = static_cast<int64_t>(rng() % 110000) - 55000;
+    std::string low = IntegerKey(low_key);
+    std::string high = IntegerKey(low_key + static_cast<int64_t>(rng() % 2000));
+    bool low_inclusive = i % 2 == 0;
+    bool high_inclusive = i % 3 == 0;
+    std::vector<std::string> expected;
+    for (auto it = reference.lower_bound(low); it != reference.end(); ++it) {
+      if (it->first > high || (it->first == high && !high_inclusive)) {
+        break;
+      }
+      if (it->first != low || low_inclusive) {
+        expected.push_back(it->first);
+      }
+    }
+    EXPECT_EQ(ScanAll(tree, &low, low_inclusive, &high, high_inclusive), expected);
+  }
+
+  // open bounds, and bounds that are entries themselves
+  std::string first = reference.begin()->first;
+  std::string last = reference.rbegin()->first;
+  EXPECT_EQ(ScanAll(tree, nullptr, false, nullptr, false).size(), reference.size());
+  EXPECT_EQ(ScanAll(tree, &first, false, nullptr, false).size(), reference.size() - 1);
+  EXPECT_EQ(ScanAll(tree, nullptr, false, &last, true).size(), reference.size());
+  EXPECT_EQ(ScanAll(tree, &last, true, &last, true), std::vector<std::string>{last});
+}
+
+TEST(AdaptiveRadixTreeTest, ConcurrentTest) {
+  AdaptiveRadixTree tree;
+  const int num_threads = 4;
+  const int64_t keys_per_thread = 20000;
+  // every thread inserts its own keys, removes every other one and looks them all up, while a scanner runs
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&tree, t]() {
+      std::vector<int64_t> keys;
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        keys.push_back(i * num_threads + t);
+      }
+      std::shuffle(keys.begin(), keys.end(), std::mt19937_64(t));
+      for (auto key : keys) {
+        EXPECT_TRUE(tree.Insert(IntegerKey(key), RID(0, static_cast<uint32_t>(key))));
+      }
+      for (auto key : keys) {
+        if (key % 2 == 0) {
+          EXPECT_TRUE(tree.Remove(IntegerKey(key)));
+        }
+      }
+      RID rid;
+      for (auto key : keys) {
+        EXPECT_EQ(tree.Lookup(IntegerKey(key), &rid), key % 2 != 0);
+      }
+    });
+  }
+  std::atomic<bool> done{false};
+  std::thread scanner([&tree, &done]() {
+    while (!done) {
+      auto keys = ScanAll(tree, nullptr, false, nullptr, false);
+      EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+      EXPECT_TRUE(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  scanner.join();
+
+  EXPECT_EQ(tree.Size(), num_threads * keys_per_thread / 2);
+  auto keys = ScanAll(tree, nullptr, false, nullptr, false);
+  ASSERT_EQ(keys.size(), tree.Size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(keys[i], IntegerKey(static_cast<int64_t>(i) * 2 + 1));
+  }
+}
+
+}  // namespace bustub
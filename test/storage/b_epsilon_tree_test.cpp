@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_tree_test.cpp
+//
+// Identification: test/storage/b_epsilon_tree_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_epsilon_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// Random upserts and deletes, checked against a map after every round
+TEST(BEpsilonTreeTests, UpsertDeleteTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(20, disk_manager);
+  // small pages and buffers, so that messages travel through several levels
+  BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 4, 6);
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  std::vector<RID> rids;
+  index_key.SetFromInteger(1);
+  tree.Remove(index_key);
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_FALSE(tree.GetValue(index_key, &rids));
+
+  std::map<int64_t, RID> expected;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int64_t> key_dist(0, 999);
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 500; i++) {
+      int64_t key = key_dist(gen);
+      index_key.SetFromInteger(key);
+      if (gen() % 4 == 0) {
+        tree.Remove(index_key);
+        expected.erase(key);
+      } else {
+        rid.Set(round, key);
+        tree.Insert(index_key, rid);
+        expected[key] = rid;
+      }
+    }
+    for (int64_t key = 0; key < 1000; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      auto it = expected.find(key);
+      ASSERT_EQ(tree.GetValue(index_key, &rids), it != expected.end()) << "key " << key << " round " << round;
+      if (it != expected.end()) {
+        ASSERT_EQ(rids.size(), 1);
+        EXPECT_EQ(rids[0], it->second);
+      }
+    }
+  }
+  EXPECT_NE(tree.GetRootPageId(), INVALID_PAGE_ID);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+// Sequential inserts into full size pages, larger than the buffer pool
+TEST(BEpsilonTreeTests, LargeInsertTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(16, disk_manager);
+  BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  int64_t scale_factor = 20000;
+  for (int64_t key = 0; key < scale_factor; key++) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, key);
+    tree.Insert(index_key, rid);
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < scale_factor; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -100,7 +101,19 @@ void DeleteHelperSplit(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree
   delete transaction;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
+// helper function to scan backwards until done is set, concurrent writers may make it skip or repeat entries, but
+// it must neither deadlock with them nor read anything but entries
+void ReverseScanHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, int64_t scale_factor,
+                       const std::atomic<bool> *done) {
+  while (!done->load()) {
+    for (auto iterator = tree->ReverseBegin(); !iterator.IsEnd(); --iterator) {
+      int64_t key = (*iterator).second.GetSlotNum();
+      EXPECT_TRUE(key > 0 && key < scale_factor);
+    }
+  }
+}
+
+TEST(BPlusTreeConcurrentTest, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -152,7 +165,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
+TEST(BPlusTreeConcurrentTest, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -203,7 +216,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
+TEST(BPlusTreeConcurrentTest, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -245,7 +258,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
+TEST(BPlusTreeConcurrentTest, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -288,7 +301,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
+TEST(BPlusTreeConcurrentTest, MixTest) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -333,4 +346,148 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, BLinkInsertDeleteTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree, small nodes so that splits propagate up to new roots concurrently
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4, ConcurrencyMode::B_LINK);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // keys to Insert
+  std::vector<int64_t> keys;
+  int64_t scale_factor = 1000;
+  for (int64_t key = 1; key < scale_factor; key++) {
+    keys.push_back(key);
+  }
+  LaunchParallelTest(4, InsertHelperSplit, &tree, keys, 4);
+
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    EXPECT_EQ(rids.size(), 1);
+  }
+
+  // remove the odd keys, the leaves stay in place
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 1; key < scale_factor; key += 2) {
+    remove_keys.push_back(key);
+  }
+  LaunchParallelTest(4, DeleteHelperSplit, &tree, remove_keys, 4);
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, scale_factor);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, ReverseScanTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  for (auto mode : {ConcurrencyMode::LATCH_CRABBING, ConcurrencyMode::B_LINK}) {
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    // create b+ tree, small nodes so that reverse scans keep running into splits and merges
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4, mode);
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    std::vector<int64_t> keys;
+    int64_t scale_factor = 1000;
+    for (int64_t key = 1; key < scale_factor; key++) {
+      keys.push_back(key);
+    }
+
+    std::atomic<bool> done{false};
+    std::thread scanner(ReverseScanHelper, &tree, scale_factor, &done);
+    LaunchParallelTest(3, InsertHelperSplit, &tree, keys, 3);
+    std::vector<int64_t> remove_keys;
+    for (int64_t key = 1; key < scale_factor; key += 2) {
+      remove_keys.push_back(key);
+    }
+    LaunchParallelTest(3, DeleteHelperSplit, &tree, remove_keys, 3);
+    done = true;
+    scanner.join();
+
+    int64_t current_key = scale_factor - 2;
+    for (auto iterator = tree.ReverseBegin(); !iterator.IsEnd(); --iterator) {
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key = current_key - 2;
+    }
+    EXPECT_EQ(current_key, 0);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+TEST(BPlusTreeConcurrentTest, ResidentUpperLevelsTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  for (auto mode : {ConcurrencyMode::LATCH_CRABBING, ConcurrencyMode::B_LINK}) {
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    // create b+ tree, small nodes so that resident pages keep splitting and merging
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4, mode);
+    tree.SetResidentUpperLevels(8);
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    std::vector<int64_t> keys;
+    int64_t scale_factor = 1000;
+    for (int64_t key = 1; key < scale_factor; key++) {
+      keys.push_back(key);
+    }
+
+    std::atomic<bool> done{false};
+    std::thread scanner(ReverseScanHelper, &tree, scale_factor, &done);
+    LaunchParallelTest(3, InsertHelperSplit, &tree, keys, 3);
+    std::vector<int64_t> remove_keys;
+    for (int64_t key = 1; key < scale_factor; key += 2) {
+      remove_keys.push_back(key);
+    }
+    LaunchParallelTest(3, DeleteHelperSplit, &tree, remove_keys, 3);
+    done = true;
+    scanner.join();
+
+    GenericKey<8> index_key;
+    std::vector<RID> rids;
+    for (auto key : keys) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+    }
+    EXPECT_GT(tree.GetResidentPageCount(), 0);
+    tree.SetResidentUpperLevels(0);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
 }  // namespace bustub
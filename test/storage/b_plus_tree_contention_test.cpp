@@ -2,11 +2,13 @@
  * b_plus_tree_contention_test.cpp
  */
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
 #include <future>  // NOLINT
 #include <iostream>
+#include <random>
 #include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager_instance.h"
@@ -17,7 +19,8 @@
 
 namespace bustub {
 
-bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool with_global_mutex) {
+bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool with_global_mutex,
+                                ConcurrencyMode mode = ConcurrencyMode::LATCH_CRABBING) {
   bool success = true;
   std::vector<int64_t> insert_keys;
 
@@ -27,7 +30,7 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   auto *disk_manager = new DiskManagerMemory(256 << 10);  // 1GB
   BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
   // create b+ tree
-  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_node_size, 10);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_node_size, 10, mode);
   // create and fetch header_page
   page_id_t page_id;
   auto *header_page = bpm->NewPage(&page_id);
@@ -74,6 +77,69 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   return success;
 }
 
+/*
+ * Lookup heavy mix: the tree is loaded with the even keys first, then every
+ * thread looks up random loaded keys and inserts one odd key of its own for
+ * every nine lookups. Only the mixed phase is timed.
+ * @return : the milliseconds the mixed phase took, or -1 if a lookup missed
+ */
+int64_t BPlusTreeMixedBenchmarkCall(size_t num_threads, int leaf_node_size, ConcurrencyMode mode) {
+  const int64_t loaded_keys = 10000;
+  const int ops_per_thread = 40000 / num_threads;
+
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(256 << 10);  // 1GB
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_node_size, 10, mode);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < loaded_keys; key++) {
+    index_key.SetFromInteger(key * 2);
+    tree.Insert(index_key, RID(0, key * 2));
+  }
+
+  std::atomic<bool> success{true};
+  std::vector<std::thread> threads;
+  auto clock_start = std::chrono::system_clock::now();
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&tree, &success, i, num_threads, ops_per_thread]() {
+      GenericKey<8> index_key;
+      std::vector<RID> result;
+      std::mt19937_64 rng(i);
+      auto *transaction = new Transaction(static_cast<txn_id_t>(i + 1));
+      for (int op = 0; op < ops_per_thread; op++) {
+        if (op % 10 == 9) {
+          int64_t key = (op / 10 * static_cast<int64_t>(num_threads) + i) * 2 + 1;
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, RID(0, key), transaction);
+          continue;
+        }
+        int64_t key = static_cast<int64_t>(rng() % loaded_keys) * 2;
+        index_key.SetFromInteger(key);
+        result.clear();
+        if (!tree.GetValue(index_key, &result, transaction) || result[0].GetSlotNum() != key) {
+          success = false;
+        }
+      }
+      delete transaction;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto clock_end = std::chrono::system_clock::now();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+
+  return success ? std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count() : -1;
+}
+
 TEST(BPlusTreeTest, DISABLED_BPlusTreeContentionBenchmark) {  // NOLINT
   std::vector<size_t> time_ms_with_mutex;
   std::vector<size_t> time_ms_wo_mutex;
@@ -154,4 +220,77 @@ TEST(BPlusTreeTest, DISABLED_BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+TEST(BPlusTreeTest, DISABLED_BPlusTreeBLinkBenchmark) {  // NOLINT
+  std::vector<size_t> time_ms_crabbing;
+  std::vector<size_t> time_ms_b_link;
+  for (size_t iter = 0; iter < 10; iter++) {
+    bool b_link = iter % 2 == 0;
+    auto clock_start = std::chrono::system_clock::now();
+    ASSERT_TRUE(BPlusTreeLockBenchmarkCall(32, 10, false,
+                                           b_link ? ConcurrencyMode::B_LINK : ConcurrencyMode::LATCH_CRABBING));
+    auto clock_end = std::chrono::system_clock::now();
+    auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start);
+    if (b_link) {
+      time_ms_b_link.push_back(dur.count());
+    } else {
+      time_ms_crabbing.push_back(dur.count());
+    }
+  }
+  std::cout << "This test compares latch crabbing against the B-link protocol under contention." << std::endl;
+  std::cout << "<<< BEGIN3" << std::endl;
+  std::cout << "Crabbing Access Time: ";
+  double ratio_1 = 0;
+  double ratio_2 = 0;
+  for (auto x : time_ms_crabbing) {
+    std::cout << x << " ";
+    ratio_1 += x;
+  }
+  std::cout << std::endl;
+
+  std::cout << "B-link Access Time: ";
+  for (auto x : time_ms_b_link) {
+    std::cout << x << " ";
+    ratio_2 += x;
+  }
+  std::cout << std::endl;
+  std::cout << "Ratio: " << ratio_2 / ratio_1 << std::endl;
+  std::cout << ">>> END3" << std::endl;
+}
+
+TEST(BPlusTreeTest, DISABLED_BPlusTreeBLinkMixedBenchmark) {  // NOLINT
+  std::vector<size_t> time_ms_crabbing;
+  std::vector<size_t> time_ms_b_link;
+  for (size_t iter = 0; iter < 10; iter++) {
+    bool b_link = iter % 2 == 0;
+    auto time_ms =
+        BPlusTreeMixedBenchmarkCall(32, 10, b_link ? ConcurrencyMode::B_LINK : ConcurrencyMode::LATCH_CRABBING);
+    ASSERT_GE(time_ms, 0);
+    if (b_link) {
+      time_ms_b_link.push_back(time_ms);
+    } else {
+      time_ms_crabbing.push_back(time_ms);
+    }
+  }
+  std::cout << "This test compares latch crabbing against the B-link protocol on lookups mixed with inserts."
+            << std::endl;
+  std::cout << "<<< BEGIN4" << std::endl;
+  std::cout << "Crabbing Access Time: ";
+  double ratio_1 = 0;
+  double ratio_2 = 0;
+  for (auto x : time_ms_crabbing) {
+    std::cout << x << " ";
+    ratio_1 += x;
+  }
+  std::cout << std::endl;
+
+  std::cout << "B-link Access Time: ";
+  for (auto x : time_ms_b_link) {
+    std::cout << x << " ";
+    ratio_2 += x;
+  }
+  std::cout << std::endl;
+  std::cout << "Ratio: " << ratio_2 / ratio_1 << std::endl;
+  std::cout << ">>> END4" << std::endl;
+}
+
 }  // namespace bustub
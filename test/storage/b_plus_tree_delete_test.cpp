@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -20,7 +21,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -92,7 +93,7 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -163,4 +164,223 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, ReverseIteratorTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree, small nodes so that the prev links go through many splits and merges
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  EXPECT_TRUE(tree.ReverseBegin().IsEnd());
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 500; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, static_cast<uint32_t>(key));
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+  // remove every multiple of three, the leaves merge and borrow along the way
+  for (auto key : keys) {
+    if (key % 3 == 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+  }
+
+  int64_t current_key = 500;
+  for (auto iterator = tree.ReverseBegin(); !iterator.IsEnd(); --iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key -= current_key % 3 == 1 ? 2 : 1;
+  }
+  EXPECT_EQ(current_key, -1);
+
+  // a removed key starts at the one before it, and both directions can be mixed
+  {
+    index_key.SetFromInteger(300);
+    auto iterator = tree.ReverseBegin(index_key);
+    iterator.EnablePrefetch();
+    EXPECT_EQ((*iterator).second.GetSlotNum(), 299);
+    --iterator;
+    EXPECT_EQ((*iterator).second.GetSlotNum(), 298);
+    ++iterator;
+    ++iterator;
+    EXPECT_EQ((*iterator).second.GetSlotNum(), 301);
+  }
+  index_key.SetFromInteger(0);
+  EXPECT_TRUE(tree.ReverseBegin(index_key).IsEnd());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, MinFillCompactTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  std::vector<std::pair<ConcurrencyMode, double>> configs{
+      {ConcurrencyMode::LATCH_CRABBING, 0.5}, {ConcurrencyMode::LATCH_CRABBING, 0}, {ConcurrencyMode::B_LINK, 0.5}};
+  std::vector<int> pages_saved;
+  for (auto [mode, min_fill] : configs) {
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, mode);
+    tree.SetMinFill(min_fill);
+    GenericKey<8> index_key;
+    RID rid;
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 1000; key++) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+    for (auto key : keys) {
+      rid.Set(0, static_cast<uint32_t>(key));
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid);
+    }
+    for (auto key : keys) {
+      if (key % 10 != 0) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key);
+      }
+    }
+
+    // sparse pages are packed again, the entries stay the same
+    for (int round = 0; round < 2; round++) {
+      std::vector<RID> rids;
+      for (int64_t key = 1; key <= 1000; key++) {
+        rids.clear();
+        index_key.SetFromInteger(key);
+        EXPECT_EQ(tree.GetValue(index_key, &rids), key % 10 == 0);
+      }
+      int64_t current_key = 10;
+      for (auto iterator = tree.Begin(); !iterator.IsEnd(); ++iterator) {
+        EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+        current_key += 10;
+      }
+      EXPECT_EQ(current_key, 1010);
+      if (round == 0) {
+        pages_saved.push_back(tree.Compact());
+        EXPECT_GT(pages_saved.back(), 0);
+      }
+    }
+
+    for (int64_t key = 10; key <= 1000; key += 10) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    tree.Compact();
+    EXPECT_TRUE(tree.IsEmpty());
+    EXPECT_TRUE(tree.Begin().IsEnd());
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+  // merging only empty pages leaves more of them sparse
+  EXPECT_GT(pages_saved[1], pages_saved[0]);
+}
+
+TEST(BPlusTreeTests, ResidentUpperLevelsTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (auto mode : {ConcurrencyMode::LATCH_CRABBING, ConcurrencyMode::B_LINK}) {
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    // small nodes so that there are more internal pages than may stay resident
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, mode);
+    GenericKey<8> index_key;
+    RID rid;
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 1000; key++) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+    for (auto key : keys) {
+      rid.Set(0, static_cast<uint32_t>(key));
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid);
+    }
+
+    tree.SetResidentUpperLevels(16);
+    std::vector<RID> rids;
+    for (auto key : keys) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.GetValue(index_key, &rids));
+      EXPECT_EQ(rids[0].GetSlotNum(), key);
+    }
+    EXPECT_EQ(tree.GetResidentPageCount(), 16);
+    // the root is read first, the tree holds a pin on it
+    Page *root = bpm->FetchPage(tree.GetRootPageId());
+    EXPECT_EQ(root->GetPinCount(), 2);
+    bpm->UnpinPage(root->GetPageId(), false);
+
+    // resident pages are unswizzled before merges free them
+    for (auto key : keys) {
+      if (key % 3 != 0) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key);
+      }
+    }
+    for (int64_t key = 1; key <= 1000; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(tree.GetValue(index_key, &rids), key % 3 == 0);
+    }
+    int64_t current_key = 3;
+    for (auto iterator = tree.Begin(); !iterator.IsEnd(); ++iterator) {
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key += 3;
+    }
+    EXPECT_EQ(current_key, 1002);
+    EXPECT_LE(tree.GetResidentPageCount(), 16);
+
+    tree.SetResidentUpperLevels(0);
+    EXPECT_EQ(tree.GetResidentPageCount(), 0);
+    root = bpm->FetchPage(tree.GetRootPageId());
+    EXPECT_EQ(root->GetPinCount(), 1);
+    bpm->UnpinPage(root->GetPageId(), false);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
 }  // namespace bustub
@@ -12,15 +12,18 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <string>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
 #include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -64,7 +67,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -127,7 +130,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -195,4 +198,410 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // shuffled keys with duplicates, the first occurrence wins
+  int64_t scale_factor = 500;
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, key);
+    entries.emplace_back(index_key, rid);
+    rid.Set(1, 0);
+    entries.emplace_back(index_key, rid);
+  }
+  ASSERT_TRUE(tree.BulkLoad(&entries, 0.5));
+  ASSERT_FALSE(tree.BulkLoad(&entries));
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetPageId(), 0);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, scale_factor + 1);
+
+  // the loaded tree must keep working with regular inserts and deletes
+  for (int64_t key = scale_factor + 1; key <= 2 * scale_factor; key++) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, key);
+    EXPECT_TRUE(tree.Insert(index_key, rid));
+  }
+  for (int64_t key = 1; key <= 2 * scale_factor; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 2 * scale_factor; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BatchTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (auto mode : {ConcurrencyMode::LATCH_CRABBING, ConcurrencyMode::B_LINK}) {
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    // create b+ tree
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, mode);
+    GenericKey<8> index_key;
+    RID rid;
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    ASSERT_EQ(page_id, HEADER_PAGE_ID);
+    (void)header_page;
+
+    // even keys in shuffled batches, each batch repeats a key of the previous one
+    int64_t scale_factor = 500;
+    std::vector<int64_t> keys;
+    for (int64_t key = 2; key <= 2 * scale_factor; key += 2) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+    for (size_t begin = 0; begin < keys.size(); begin += 100) {
+      std::vector<std::pair<GenericKey<8>, RID>> entries;
+      for (size_t i = begin; i < begin + 100; i++) {
+        index_key.SetFromInteger(keys[i]);
+        rid.Set(0, keys[i]);
+        entries.emplace_back(index_key, rid);
+      }
+      if (begin > 0) {
+        index_key.SetFromInteger(keys[begin - 1]);
+        entries.emplace_back(index_key, RID(1, 0));
+      }
+      EXPECT_EQ(tree.InsertBatch(&entries), 100);
+    }
+
+    int64_t current_key = 2;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      EXPECT_EQ((*iterator).second.GetPageId(), 0);
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key = current_key + 2;
+    }
+    EXPECT_EQ(current_key, 2 * scale_factor + 2);
+
+    // every key in descending order, only the even ones are present
+    std::vector<GenericKey<8>> lookups;
+    for (int64_t key = 2 * scale_factor + 1; key >= 0; key--) {
+      index_key.SetFromInteger(key);
+      lookups.push_back(index_key);
+    }
+    std::vector<std::vector<RID>> results;
+    EXPECT_EQ(tree.GetValueBatch(lookups, &results), scale_factor);
+    ASSERT_EQ(results.size(), lookups.size());
+    for (int64_t key = 2 * scale_factor + 1; key >= 0; key--) {
+      const auto &result = results[2 * scale_factor + 1 - key];
+      if (key % 2 == 0 && key > 0) {
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result[0].GetSlotNum(), key);
+      } else {
+        EXPECT_TRUE(result.empty());
+      }
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+TEST(BPlusTreeTests, IntegerKeyTest) {
+  // native integer keys need no key schema
+  IntegerKeyComparator<int64_t> comparator(nullptr);
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree
+  BPlusTree<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>> tree("foo_pk", bpm, comparator, 5, 5);
+  IntegerKey<int64_t> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // negative keys must order before positive ones
+  std::vector<int64_t> keys;
+  for (int64_t key = -300; key < 300; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, static_cast<uint32_t>(key + 300));
+    EXPECT_TRUE(tree.Insert(index_key, rid));
+  }
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), key + 300);
+  }
+
+  int64_t current_key = -300;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, 300);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, ReplaceKeyTest) {
+  IntegerKeyComparator<int64_t> comparator(nullptr);
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<IntegerKey<int64_t>, RID, IntegerKeyComparator<int64_t>> tree("foo_pk", bpm, comparator, 16, 5);
+  auto key = [](int64_t i) {
+    IntegerKey<int64_t> index_key;
+    index_key.SetFromInteger(i);
+    return index_key;
+  };
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  for (int64_t i = 0; i < 1000; i += 10) {
+    EXPECT_TRUE(tree.Insert(key(i), RID(0, static_cast<uint32_t>(i))));
+  }
+  EXPECT_FALSE(tree.ReplaceKey(key(5), key(6)));
+  EXPECT_FALSE(tree.ReplaceKey(key(500), key(510)));
+  EXPECT_FALSE(tree.ReplaceKey(key(500), key(489)));
+
+  // only entries between two others of their leaf are replaced
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 1000; i += 10) {
+    expected.push_back(tree.ReplaceKey(key(i), key(i + 5)) ? i + 5 : i);
+  }
+  EXPECT_GT(std::count_if(expected.begin(), expected.end(), [](int64_t i) { return i % 10 == 5; }), 20);
+  EXPECT_GT(std::count_if(expected.begin(), expected.end(), [](int64_t i) { return i % 10 == 0; }), 20);
+
+  auto it = expected.begin();
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++it) {
+    ASSERT_NE(it, expected.end());
+    EXPECT_EQ((*iterator).first.ToString(), *it);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), *it / 10 * 10);
+  }
+  EXPECT_EQ(it, expected.end());
+  std::vector<RID> rids;
+  for (auto i : expected) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(key(i), &rids));
+    EXPECT_FALSE(tree.GetValue(key(i % 10 == 5 ? i - 5 : i + 5), &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, VarKeyTest) {
+  auto key_schema = ParseCreateStatement("a varchar(128)");
+  VarKeyComparator comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree, slotted pages ignore the max sizes
+  BPlusTree<VarKey, RID, VarKeyComparator> tree("foo_pk", bpm, comparator);
+  BPlusTree<VarKey, RID, VarKeyComparator> loaded_tree("foo_bulk", bpm, comparator);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // keys of very different lengths with long shared prefixes, so that pages hold different numbers of them
+  auto make_key = [&key_schema](int64_t i) {
+    std::string str = "customer-" + std::to_string(i % 7) + "-" + std::string(i % 97, 'x') + std::to_string(i);
+    VarKey key;
+    key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(str)}, key_schema.get()), key_schema.get());
+    return key;
+  };
+  int64_t scale_factor = 2000;
+  std::vector<int64_t> keys;
+  for (int64_t i = 0; i < scale_factor; i++) {
+    keys.push_back(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  std::vector<std::pair<VarKey, RID>> entries;
+  RID rid;
+  for (auto i : keys) {
+    rid.Set(0, i);
+    EXPECT_TRUE(tree.Insert(make_key(i), rid));
+    entries.emplace_back(make_key(i), rid);
+  }
+  EXPECT_FALSE(tree.Insert(make_key(keys[0]), rid));
+  ASSERT_TRUE(loaded_tree.BulkLoad(&entries));
+
+  // the leaves hold every key once, in order
+  for (auto *current : {&tree, &loaded_tree}) {
+    int64_t count = 0;
+    VarKey prev_key;
+    for (auto iterator = current->Begin(); iterator != current->End(); ++iterator, ++count) {
+      if (count > 0) {
+        EXPECT_LT(comparator(prev_key, (*iterator).first), 0);
+      }
+      prev_key = (*iterator).first;
+      EXPECT_EQ(comparator((*iterator).first, make_key((*iterator).second.GetSlotNum())), 0);
+    }
+    EXPECT_EQ(count, scale_factor);
+  }
+
+  // remove two thirds of the keys, merging and redistributing the slotted pages
+  for (auto i : keys) {
+    if (i % 3 != 0) {
+      tree.Remove(make_key(i));
+      loaded_tree.Remove(make_key(i));
+    }
+  }
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < scale_factor; i++) {
+    for (auto *current : {&tree, &loaded_tree}) {
+      rids.clear();
+      ASSERT_EQ(current->GetValue(make_key(i), &rids), i % 3 == 0) << i;
+      if (i % 3 == 0) {
+        EXPECT_EQ(rids[0].GetSlotNum(), i);
+      }
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, VarKeyPrefixTest) {
+  auto key_schema = ParseCreateStatement("a varchar(128)");
+  VarKeyComparator comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<VarKey, RID, VarKeyComparator> tree("foo_pk", bpm, comparator);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // two runs of keys that share a long prefix within each run and differ only in their last digits
+  auto make_key = [&key_schema](int64_t i) {
+    std::string base = i % 2 == 0 ? "https://example.com/catalog/" : "https://example.org/archive/";
+    std::string str = base + std::string(80, 'p') + "/" + std::to_string(1000000 + i);
+    VarKey key;
+    key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(str)}, key_schema.get()), key_schema.get());
+    return key;
+  };
+  int64_t scale_factor = 3000;
+  std::vector<int64_t> keys;
+  for (int64_t i = 0; i < scale_factor; i++) {
+    keys.push_back(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  RID rid;
+  for (auto i : keys) {
+    rid.Set(0, i);
+    EXPECT_TRUE(tree.Insert(make_key(i), rid));
+  }
+
+  // leaves store the prefix once, so they hold more keys than even a page without a header could hold whole
+  IndexStatistics stats;
+  std::vector<std::vector<VarKey>> sample;
+  tree.CollectStatistics(1000, &stats, &sample);
+  auto whole_keys_per_page = BUSTUB_PAGE_SIZE / (2 * sizeof(uint16_t) + sizeof(RID) + make_key(0).size_);
+  EXPECT_GT(static_cast<size_t>(scale_factor) / stats.leaf_pages_, 3 * whole_keys_per_page);
+
+  int64_t count = 0;
+  VarKey prev_key;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++count) {
+    if (count > 0) {
+      EXPECT_LT(comparator(prev_key, (*iterator).first), 0);
+    }
+    prev_key = (*iterator).first;
+    EXPECT_EQ(comparator((*iterator).first, make_key((*iterator).second.GetSlotNum())), 0);
+  }
+  EXPECT_EQ(count, scale_factor);
+
+  // merges and redistributions widen the key range of leaves, which gives bytes of the prefix back to the keys
+  for (auto i : keys) {
+    if (i % 5 != 0) {
+      tree.Remove(make_key(i));
+    }
+  }
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < scale_factor; i++) {
+    rids.clear();
+    ASSERT_EQ(tree.GetValue(make_key(i), &rids), i % 5 == 0) << i;
+  }
+  for (int64_t i = 0; i < scale_factor; i++) {
+    rid.Set(0, i);
+    EXPECT_EQ(tree.Insert(make_key(i), rid), i % 5 != 0);
+  }
+  for (int64_t i = 0; i < scale_factor; i++) {
+    rids.clear();
+    ASSERT_TRUE(tree.GetValue(make_key(i), &rids)) << i;
+    EXPECT_EQ(rids[0].GetSlotNum(), i);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
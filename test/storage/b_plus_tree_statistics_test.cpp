@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_statistics_test.cpp
+//
+// Identification: test/storage/b_plus_tree_statistics_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/index_statistics.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(BPlusTreeStatisticsTest, ShapeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(50, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm.get(), comparator, 8, 8);
+
+  IndexStatistics empty;
+  std::vector<std::vector<GenericKey<8>>> sample;
+  tree.CollectStatistics(IndexStatistics::SAMPLE_LEAVES, &empty, &sample);
+  EXPECT_EQ(empty.height_, 0);
+  EXPECT_TRUE(sample.empty());
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 1000; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<int32_t>(key), 0));
+  }
+
+  // reading every leaf makes the counts exact
+  IndexStatistics full;
+  tree.CollectStatistics(1000, &full, &sample);
+  size_t sampled = 0;
+  for (const auto &keys : sample) {
+    sampled += keys.size();
+    for (size_t i = 1; i < keys.size(); i++) {
+      EXPECT_LT(comparator(keys[i - 1], keys[i]), 0);
+    }
+  }
+  EXPECT_EQ(sampled, 1000);
+  EXPECT_EQ(sample.size(), full.leaf_pages_);
+  EXPECT_DOUBLE_EQ(full.entries_, 1000);
+  EXPECT_GE(full.height_, 4);
+  EXPECT_GT(full.internal_pages_, 0);
+  // splits leave leaves between half full and full
+  EXPECT_GE(full.leaf_fill_, 0.5);
+  EXPECT_LE(full.leaf_fill_, 1.0);
+
+  // a sample of the leaves extrapolates the entries
+  IndexStatistics sampled_stats;
+  sample.clear();
+  tree.CollectStatistics(16, &sampled_stats, &sample);
+  EXPECT_EQ(sample.size(), 16);
+  EXPECT_EQ(sampled_stats.height_, full.height_);
+  EXPECT_EQ(sampled_stats.leaf_pages_, full.leaf_pages_);
+  EXPECT_NEAR(sampled_stats.entries_, 1000, 250);
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeStatisticsTest, HistogramTest) {
+  // 2000 entries over the values 0 to 999, every value twice, sampled as 20 leaves of 10 entries
+  IndexStatistics stats;
+  stats.entries_ = 2000;
+  std::vector<std::vector<Value>> leaves;
+  for (int leaf = 0; leaf < 20; leaf++) {
+    auto &values = leaves.emplace_back();
+    for (int i = 0; i < 10; i++) {
+      values.push_back(ValueFactory::GetIntegerValue(leaf * 50 + i / 2));
+    }
+  }
+  size_t pairs = 20 * 9;
+  size_t changes = 20 * 4;
+  EXPECT_NEAR(IndexStatistics::EstimateDistinct(2000, pairs, changes), 2000 * 4.0 / 9, 1);
+  EXPECT_DOUBLE_EQ(IndexStatistics::EstimateDistinct(2000, 0, 0), 2000);
+  EXPECT_DOUBLE_EQ(IndexStatistics::EstimateDistinct(2000, 10, 0), 1);
+
+  stats.BuildHistogram(leaves, 8);
+  ASSERT_FALSE(stats.histogram_.empty());
+  EXPECT_LE(stats.histogram_.size(), 8);
+  EXPECT_EQ(stats.lowest_.GetAs<int32_t>(), 0);
+  EXPECT_EQ(stats.histogram_.back().upper_.GetAs<int32_t>(), 954);
+  double total = 0;
+  for (size_t i = 0; i < stats.histogram_.size(); i++) {
+    total += stats.histogram_[i].count_;
+    if (i > 0) {
+      EXPECT_LT(stats.histogram_[i - 1].upper_.GetAs<int32_t>(), stats.histogram_[i].upper_.GetAs<int32_t>());
+    }
+  }
+  EXPECT_DOUBLE_EQ(total, 2000);
+
+  EXPECT_DOUBLE_EQ(stats.EstimateRange(nullptr, nullptr), 2000);
+  Value v_low = ValueFactory::GetIntegerValue(-10);
+  Value v_0 = ValueFactory::GetIntegerValue(0);
+  Value v_250 = ValueFactory::GetIntegerValue(250);
+  Value v_500 = ValueFactory::GetIntegerValue(500);
+  Value v_high = ValueFactory::GetIntegerValue(2000);
+  EXPECT_NEAR(stats.EstimateRange(&v_0, &v_500), 1000, 200);
+  EXPECT_NEAR(stats.EstimateRange(&v_250, nullptr), 1500, 200);
+  EXPECT_DOUBLE_EQ(stats.EstimateRange(&v_high, nullptr), 0);
+  EXPECT_DOUBLE_EQ(stats.EstimateRange(nullptr, &v_low), 0);
+  EXPECT_NEAR(stats.EstimateEqual(v_500), 2, 1);
+  EXPECT_DOUBLE_EQ(stats.EstimateEqual(v_low), 0);
+  EXPECT_DOUBLE_EQ(stats.EstimateEqual(v_high), 0);
+
+  // a value making up most of the entries gets a bucket of its own
+  IndexStatistics skewed;
+  skewed.entries_ = 100;
+  std::vector<std::vector<Value>> skewed_leaves(1);
+  for (int i = 0; i < 100; i++) {
+    skewed_leaves[0].push_back(ValueFactory::GetIntegerValue(i < 80 ? 7 : i));
+  }
+  skewed.BuildHistogram(skewed_leaves, 10);
+  EXPECT_NEAR(skewed.EstimateEqual(ValueFactory::GetIntegerValue(7)), 80, 1);
+  EXPECT_NEAR(skewed.EstimateEqual(ValueFactory::GetIntegerValue(90)), 1, 1);
+}
+
+}  // namespace bustub
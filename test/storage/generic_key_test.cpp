@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, NormalizedOrderTest) {
+  std::vector<Column> columns;
+  columns.emplace_back("a", TypeId::INTEGER);
+  columns.emplace_back("b", TypeId::VARCHAR, 8);
+  columns.emplace_back("c", TypeId::DECIMAL);
+  Schema schema(columns);
+  GenericComparator<32> comparator(&schema);
+
+  // rows in ascending key order, NULLs sort first
+  std::vector<std::vector<Value>> rows = {
+      {ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetVarcharValue("z"),
+       ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(-7), ValueFactory::GetVarcharValue("a"), ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(0), ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+       ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(""), ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("ab"), ValueFactory::GetDecimalValue(-2.5)},
+      {ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("ab"), ValueFactory::GetDecimalValue(-0.5)},
+      {ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("ab"), ValueFactory::GetDecimalValue(1.5)},
+      {ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("abc"), ValueFactory::GetDecimalValue(-9)},
+      {ValueFactory::GetIntegerValue(3), ValueFactory::GetVarcharValue("a"), ValueFactory::GetDecimalValue(0)},
+  };
+  std::vector<GenericKey<32>> keys(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    keys[i].SetFromKey(Tuple(rows[i], &schema), &schema);
+  }
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      EXPECT_EQ(comparator(keys[i], keys[j]), i < j ? -1 : (i == j ? 0 : 1)) << i << " vs " << j;
+    }
+  }
+
+  // the original values can still be read back
+  for (size_t i = 0; i < rows.size(); i++) {
+    for (uint32_t col = 0; col < schema.GetColumnCount(); col++) {
+      Value value = keys[i].ToValue(&schema, col);
+      EXPECT_EQ(value.IsNull(), rows[i][col].IsNull());
+      if (!value.IsNull()) {
+        EXPECT_EQ(value.CompareEquals(rows[i][col]), CmpBool::CmpTrue);
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, ShortestSeparatorTest) {
+  std::vector<Column> columns;
+  columns.emplace_back("a", TypeId::VARCHAR, 32);
+  Schema schema(columns);
+  GenericComparator<32> comparator(&schema);
+
+  auto make_key = [&schema](const std::string &str) {
+    GenericKey<32> key;
+    key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(str)}, &schema), &schema);
+    return key;
+  };
+  std::vector<std::pair<std::string, std::string>> pairs = {
+      {"apple", "banana"}, {"interstellar", "intertwine"}, {"abc", "abcd"}, {"same", "samf"}};
+  for (auto &[left_str, right_str] : pairs) {
+    auto left = make_key(left_str);
+    auto right = make_key(right_str);
+    auto separator = GenericKey<32>::ShortestSeparator(left, right);
+    EXPECT_LT(comparator(left, separator), 0) << left_str;
+    EXPECT_LE(comparator(separator, right), 0) << right_str;
+  }
+  // only the first distinguishing character is kept
+  auto separator = GenericKey<32>::ShortestSeparator(make_key("apple"), make_key("banana"));
+  EXPECT_EQ(separator.ToValue(&schema, 0).ToString(), "b");
+  separator = GenericKey<32>::ShortestSeparator(make_key("interstellar"), make_key("intertwine"));
+  EXPECT_EQ(separator.ToValue(&schema, 0).ToString(), "intert");
+}
+
+}  // namespace bustub
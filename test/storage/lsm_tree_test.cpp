@@ -0,0 +1,269 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree_test.cpp
+//
+// Identification: test/storage/lsm_tree_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/lsm_tree.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+auto EncodeKey(int64_t key) -> std::string {
+  std::string encoded(sizeof(int64_t), '\0');
+  NormalizedKey::EncodeInteger(key, encoded.data(), encoded.size());
+  return encoded;
+}
+
+using Entries = std::vector<std::pair<std::string, RID>>;
+
+auto ScanAll(const LSMTree &tree, const std::string *low, bool low_inclusive, const std::string *high,
+             bool high_inclusive) -> Entries {
+  Entries entries;
+  tree.Scan(low, low_inclusive, high, high_inclusive,
+            [&entries](const std::string &key, RID rid) { entries.emplace_back(key, rid); });
+  return entries;
+}
+
+TEST(LSMTreeTest, PutLookupRemoveTest) {
+  auto disk_manager = std::make_unique<DiskManager>("lsm_tree_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  // the tree compacts in the background until it is destroyed, which has to happen before the cleanup
+  {
+    // small memtables and two runs per level, so that the entries spread over several levels
+    LSMTree tree(bpm.get(), 16 << 10, 2);
+    std::map<std::string, RID> reference;
+    std::mt19937_64 rng(15445);
+    for (int i = 0; i < 20000; i++) {
+      auto key = static_cast<int64_t>(rng() % 5000);
+      if (i % 4 == 3) {
+        tree.Remove(EncodeKey(key));
+        reference.erase(EncodeKey(key));
+      } else {
+        RID rid(static_cast<int32_t>(key), static_cast<uint32_t>(i));
+        tree.Put(EncodeKey(key), rid);
+        reference[EncodeKey(key)] = rid;
+      }
+    }
+    auto check = [&]() {
+      RID rid;
+      for (int64_t key = -1; key <= 5000; key++) {
+        auto it = reference.find(EncodeKey(key));
+        ASSERT_EQ(tree.Lookup(EncodeKey(key), &rid), it != reference.end()) << key;
+        if (it != reference.end()) {
+          EXPECT_EQ(rid, it->second);
+        }
+      }
+      auto entries = ScanAll(tree, nullptr, false, nullptr, false);
+      EXPECT_EQ(entries, Entries(reference.begin(), reference.end()));
+    };
+    // while entries are still in the memtable, and once all of them are in runs
+    check();
+    tree.Flush();
+    auto counts = tree.GetRunCounts();
+    EXPECT_GT(counts.size(), 1);
+    for (auto count : counts) {
+      EXPECT_LT(count, 2);
+    }
+    check();
+
+    // removing everything leaves tombstones behind until they reach the last level
+    for (const auto &entry : reference) {
+      tree.Remove(entry.first);
+    }
+    reference.clear();
+    check();
+    tree.Flush();
+    check();
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("lsm_tree_test.db");
+  remove("lsm_tree_test.log");
+}
+
+TEST(LSMTreeTest, ScanTest) {
+  auto disk_manager = std::make_unique<DiskManager>("lsm_tree_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  {
+    LSMTree tree(bpm.get(), 8 << 10, 3);
+    std::map<std::string, RID> reference;
+    std::mt19937_64 rng(15445);
+    for (int i = 0; i < 5000; i++) {
+      auto key = static_cast<int64_t>(rng() % 100000) - 50000;
+      tree.Put(EncodeKey(key), RID(0, static_cast<uint32_t>(i)));
+      reference[EncodeKey(key)] = RID(0, static_cast<uint32_t>(i));
+    }
+
+    for (int i = 0; i < 200; i++) {
+      auto low_key = static_cast<int64_t>(rng() % 110000) - 55000;
+      std::string low = EncodeKey(low_key);
+      std::string high = EncodeKey(low_key + static_cast<int64_t>(rng() % 2000));
+      bool low_inclusive = i % 2 == 0;
+      bool high_inclusive = i % 3 == 0;
+      Entries expected;
+      for (auto it = reference.lower_bound(low); it != reference.end(); ++it) {
+        if (it->first > high || (it->first == high && !high_inclusive)) {
+          break;
+        }
+        if (it->first != low || low_inclusive) {
+          expected.emplace_back(*it);
+        }
+      }
+      EXPECT_EQ(ScanAll(tree, &low, low_inclusive, &high, high_inclusive), expected);
+    }
+
+    // open bounds, and bounds that are entries themselves
+    std::string first = reference.begin()->first;
+    std::string last = reference.rbegin()->first;
+    EXPECT_EQ(ScanAll(tree, nullptr, false, nullptr, false).size(), reference.size());
+    EXPECT_EQ(ScanAll(tree, &first, false, nullptr, false).size(), reference.size() - 1);
+    EXPECT_EQ(ScanAll(tree, nullptr, false, &last, true).size(), reference.size());
+    EXPECT_EQ(ScanAll(tree, &last, true, &last, true).size(), 1);
+
+    // a scan does not see the writes made while it runs, neither those that go into its memtable nor the ones
+    // after that memtable fills up and is frozen
+    tree.Flush();
+    tree.Put(EncodeKey(-100000), RID(0, 0));
+    reference[EncodeKey(-100000)] = RID(0, 0);
+    Entries entries;
+    tree.Scan(nullptr, false, nullptr, false, [&](const std::string &key, RID rid) {
+      if (entries.empty()) {
+        for (int64_t i = -60000; i < 60000; i += 7) {
+          tree.Put(EncodeKey(i), RID(1, 0));
+        }
+        tree.Remove(last);
+      }
+      entries.emplace_back(key, rid);
+    });
+    EXPECT_EQ(entries, Entries(reference.begin(), reference.end()));
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("lsm_tree_test.db");
+  remove("lsm_tree_test.log");
+}
+
+TEST(LSMTreeTest, BulkLoadTest) {
+  auto disk_manager = std::make_unique<DiskManager>("lsm_tree_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  {
+    LSMTree tree(bpm.get(), 16 << 10, 4);
+    Entries entries;
+    for (int64_t key = 0; key < 20000; key += 2) {
+      entries.emplace_back(EncodeKey(key), RID(0, static_cast<uint32_t>(key)));
+    }
+    tree.BulkLoad(entries);
+    // the run goes to a level of its size
+    EXPECT_GT(tree.GetRunCounts().size(), 1);
+    EXPECT_EQ(tree.GetRunCounts().back(), 1);
+
+    // newer entries hide the loaded ones
+    for (int64_t key = 0; key < 20000; key += 3) {
+      tree.Put(EncodeKey(key), RID(1, static_cast<uint32_t>(key)));
+    }
+    for (int64_t key = 0; key < 20000; key += 10) {
+      tree.Remove(EncodeKey(key));
+    }
+    tree.Flush();
+    RID rid;
+    for (int64_t key = 0; key < 20000; key++) {
+      bool expected = key % 10 != 0 && (key % 2 == 0 || key % 3 == 0);
+      ASSERT_EQ(tree.Lookup(EncodeKey(key), &rid), expected) << key;
+      if (expected) {
+        EXPECT_EQ(rid, RID(key % 3 == 0 ? 1 : 0, static_cast<uint32_t>(key)));
+      }
+    }
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("lsm_tree_test.db");
+  remove("lsm_tree_test.log");
+}
+
+TEST(LSMTreeTest, ConcurrentTest) {
+  auto disk_manager = std::make_unique<DiskManager>("lsm_tree_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  {
+    LSMTree tree(bpm.get(), 16 << 10, 3);
+    const int num_writers = 2;
+    const int64_t keys_per_writer = 20000;
+    // writers insert their own keys and remove every other one, while readers look keys up and scan
+    std::vector<std::thread> writers;
+    for (int t = 0; t < num_writers; t++) {
+      writers.emplace_back([&tree, t]() {
+        for (int64_t i = 0; i < keys_per_writer; i++) {
+          int64_t key = i * num_writers + t;
+          tree.Put(EncodeKey(key), RID(0, static_cast<uint32_t>(key)));
+          if (i % 2 == 1) {
+            tree.Remove(EncodeKey(key - num_writers));
+          }
+        }
+      });
+    }
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; t++) {
+      readers.emplace_back([&tree, &done, t]() {
+        std::mt19937_64 rng(t);
+        while (!done) {
+          if (t == 0) {
+            auto entries = ScanAll(tree, nullptr, false, nullptr, false);
+            // strictly increasing keys
+            EXPECT_TRUE(std::adjacent_find(entries.begin(), entries.end(), [](const auto &left, const auto &right) {
+                          return left.first >= right.first;
+                        }) == entries.end());
+            continue;
+          }
+          RID rid;
+          auto key = static_cast<int64_t>(rng() % (num_writers * keys_per_writer));
+          if (tree.Lookup(EncodeKey(key), &rid)) {
+            EXPECT_EQ(rid.GetSlotNum(), key);
+          }
+        }
+      });
+    }
+    for (auto &thread : writers) {
+      thread.join();
+    }
+    done = true;
+    for (auto &thread : readers) {
+      thread.join();
+    }
+
+    tree.Flush();
+    auto entries = ScanAll(tree, nullptr, false, nullptr, false);
+    ASSERT_EQ(entries.size(), num_writers * keys_per_writer / 2);
+    for (size_t i = 0; i < entries.size(); i++) {
+      // every writer keeps the odd i
+      int64_t key = static_cast<int64_t>(i / num_writers * 2 + 1) * num_writers + static_cast<int64_t>(i % num_writers);
+      EXPECT_EQ(entries[i].first, EncodeKey(key));
+    }
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("lsm_tree_test.db");
+  remove("lsm_tree_test.log");
+}
+
+}  // namespace bustub
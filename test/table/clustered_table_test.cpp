@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clustered_table_test.cpp
+//
+// Identification: test/table/clustered_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/table/clustered_table.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(ClusteredTableTest, InsertGetDeleteTest) {
+  auto disk_manager = std::make_unique<DiskManager>("clustered_table_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  // the primary key (c, a) leads with a varchar and is not a prefix of the columns
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 32},
+                                    Column{"c", TypeId::VARCHAR, 8}, Column{"d", TypeId::BIGINT}}};
+  ClusteredTable table("clustered", bpm.get(), schema, {2, 0});
+  Transaction txn(0);
+  auto make_row = [&schema](int a, const std::string &b, const std::string &c, int64_t d) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(b),
+                  ValueFactory::GetVarcharValue(c), ValueFactory::GetBigIntValue(d)},
+                 &schema);
+  };
+  auto make_key = [&table](const std::string &c, int a) {
+    return Tuple({ValueFactory::GetVarcharValue(c), ValueFactory::GetIntegerValue(a)}, &table.GetKeySchema());
+  };
+
+  // reference rows by (c, a)
+  std::map<std::pair<std::string, int>, int64_t> reference;
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 5000; i++) {
+    int a = static_cast<int>(rng() % 1000) - 500;
+    std::string c(1 + rng() % 3, static_cast<char>('a' + rng() % 3));
+    bool inserted = reference.emplace(std::make_pair(c, a), i).second;
+    EXPECT_EQ(table.InsertTuple(make_row(a, "row " + std::to_string(i), c, i), &txn), inserted);
+  }
+
+  Tuple result;
+  for (const auto &[key, d] : reference) {
+    ASSERT_TRUE(table.GetTuple(make_key(key.first, key.second), &result, &txn));
+    EXPECT_EQ(result.GetValue(&schema, 0).GetAs<int32_t>(), key.second);
+    EXPECT_EQ(result.GetValue(&schema, 1).ToString(), "row " + std::to_string(d));
+    EXPECT_EQ(result.GetValue(&schema, 2).ToString(), key.first);
+    EXPECT_EQ(result.GetValue(&schema, 3).GetAs<int64_t>(), d);
+  }
+  EXPECT_FALSE(table.GetTuple(make_key("z", 0), &result, &txn));
+
+  // every other row is updated or deleted
+  int n = 0;
+  for (auto it = reference.begin(); it != reference.end(); n++) {
+    const auto &[c, a] = it->first;
+    if (n % 2 == 0) {
+      ASSERT_TRUE(table.UpdateTuple(make_row(a, "updated", c, -it->second), &txn));
+      it->second = -it->second;
+      ++it;
+    } else {
+      ASSERT_TRUE(table.DeleteTuple(make_key(c, a), &txn));
+      EXPECT_FALSE(table.DeleteTuple(make_key(c, a), &txn));
+      it = reference.erase(it);
+    }
+  }
+  EXPECT_FALSE(table.UpdateTuple(make_row(0, "missing", "z", 0), &txn));
+
+  // the scan walks the rows in primary key order
+  auto expected = reference.begin();
+  for (auto it = table.Begin(); !it.IsEnd(); ++it, ++expected) {
+    ASSERT_NE(expected, reference.end());
+    EXPECT_EQ((*it).GetValue(&schema, 2).ToString(), expected->first.first);
+    EXPECT_EQ((*it).GetValue(&schema, 0).GetAs<int32_t>(), expected->first.second);
+    EXPECT_EQ((*it).GetValue(&schema, 1).ToString(), "updated");
+    EXPECT_EQ((*it).GetValue(&schema, 3).GetAs<int64_t>(), expected->second);
+  }
+  EXPECT_EQ(expected, reference.end());
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("clustered_table_test.db");
+  remove("clustered_table_test.log");
+}
+
+TEST(ClusteredTableTest, ScanRangeTest) {
+  auto disk_manager = std::make_unique<DiskManager>("clustered_table_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}}};
+  ClusteredTable table("clustered", bpm.get(), schema, {1});
+  Transaction txn(0);
+  for (int b = 0; b < 3000; b += 3) {
+    ASSERT_TRUE(table.InsertTuple(Tuple({ValueFactory::GetIntegerValue(-b), ValueFactory::GetIntegerValue(b)},
+                                        &schema),
+                                  &txn));
+  }
+  auto key = [&table](int b) { return Tuple({ValueFactory::GetIntegerValue(b)}, &table.GetKeySchema()); };
+  auto scan = [&](const Tuple *low, bool low_inclusive, const Tuple *high, bool high_inclusive) {
+    std::vector<Tuple> rows;
+    table.ScanRange(low, low_inclusive, high, high_inclusive, &rows, &txn);
+    std::vector<int> keys;
+    for (const auto &row : rows) {
+      EXPECT_EQ(row.GetValue(&schema, 0).GetAs<int32_t>(), -row.GetValue(&schema, 1).GetAs<int32_t>());
+      keys.push_back(row.GetValue(&schema, 1).GetAs<int32_t>());
+    }
+    return keys;
+  };
+  auto range = [](int low, int high) {
+    std::vector<int> keys;
+    for (int b = low; b <= high; b += 3) {
+      keys.push_back(b);
+    }
+    return keys;
+  };
+
+  Tuple k300 = key(300);
+  Tuple k600 = key(600);
+  Tuple k301 = key(301);
+  Tuple k599 = key(599);
+  EXPECT_EQ(scan(&k300, true, &k600, true), range(300, 600));
+  EXPECT_EQ(scan(&k300, false, &k600, false), range(303, 597));
+  EXPECT_EQ(scan(&k301, true, &k599, true), range(303, 597));
+  EXPECT_EQ(scan(nullptr, false, &k300, false), range(0, 297));
+  EXPECT_EQ(scan(&k600, false, nullptr, false), range(603, 2997));
+  EXPECT_EQ(scan(nullptr, false, nullptr, false).size(), 1000);
+  EXPECT_EQ((*table.Begin(k301)).GetValue(&schema, 1).GetAs<int32_t>(), 303);
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("clustered_table_test.db");
+  remove("clustered_table_test.log");
+}
+
+}  // namespace bustub
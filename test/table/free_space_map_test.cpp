@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_test.cpp
+//
+// Identification: test/table/free_space_map_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(FreeSpaceMapTest, ClaimTest) {
+  FreeSpaceMap map;
+  page_id_t page_id;
+  EXPECT_FALSE(map.Claim(1, &page_id));
+
+  map.Update(1, 100);
+  map.Update(2, 1000);
+  map.Update(3, 3000);
+  EXPECT_EQ(map.GetPageCount(), 3);
+  // the page with the least room that surely fits, which is then gone until it is released
+  ASSERT_TRUE(map.Claim(50, &page_id));
+  EXPECT_EQ(page_id, 2);
+  ASSERT_TRUE(map.Claim(50, &page_id));
+  EXPECT_EQ(page_id, 3);
+  EXPECT_FALSE(map.Claim(50, &page_id));
+  map.Release(3, 2000);
+  map.Release(2, 10);
+  ASSERT_TRUE(map.Claim(1000, &page_id));
+  EXPECT_EQ(page_id, 3);
+  EXPECT_FALSE(map.Claim(1000, &page_id));
+  EXPECT_FALSE(map.Claim(3500, &page_id));
+
+  // updates of a claimed page do not make it claimable, updates of others move them between categories
+  map.Update(3, 3500);
+  map.Update(2, 3500);
+  EXPECT_EQ(map.GetPageCount(), 3);
+  ASSERT_TRUE(map.Claim(3000, &page_id));
+  EXPECT_EQ(page_id, 2);
+  EXPECT_FALSE(map.Claim(1000, &page_id));
+  map.AddClaimed(4);
+  EXPECT_EQ(map.GetPageCount(), 4);
+  EXPECT_FALSE(map.Claim(1000, &page_id));
+  map.Release(4, 4000);
+  map.Update(1, 2000);
+  ASSERT_TRUE(map.Claim(1000, &page_id));
+  EXPECT_EQ(page_id, 1);
+  ASSERT_TRUE(map.Claim(1000, &page_id));
+  EXPECT_EQ(page_id, 4);
+}
+
+TEST(FreeSpaceMapTest, TableHeapReuseTest) {
+  auto disk_manager = std::make_unique<DiskManager>("free_space_map_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}}};
+  auto make_row = [&schema](int a) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(200, 'x'))}, &schema);
+  };
+  auto count_pages = [&bpm](page_id_t first_page_id) {
+    std::set<page_id_t> pages;
+    for (auto page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+      pages.insert(page_id);
+      auto page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+      auto next_page_id = page->GetNextPageId();
+      bpm->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    return pages.size();
+  };
+
+  Transaction txn(0);
+  page_id_t first_page_id;
+  std::vector<RID> rids(2000);
+  {
+    TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+    first_page_id = table.GetFirstPageId();
+    for (int i = 0; i < 2000; i++) {
+      ASSERT_TRUE(table.InsertTuple(make_row(i), &rids[i], &txn));
+    }
+  }
+  size_t pages = count_pages(first_page_id);
+  EXPECT_GT(pages, 100);
+
+  // a reopened table finds the room the deletes free up in the middle of the chain
+  TableHeap table(bpm.get(), nullptr, nullptr, first_page_id);
+  for (int i = 500; i < 1500; i++) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    table.ApplyDelete(rids[i], &txn);
+  }
+  std::set<page_id_t> reused;
+  for (int i = 500; i < 1500; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(make_row(i), &rid, &txn));
+    reused.insert(rid.GetPageId());
+  }
+  EXPECT_EQ(count_pages(first_page_id), pages);
+  // only the pages of the deleted rows, and the last one, had room
+  std::set<page_id_t> freed{rids[1999].GetPageId()};
+  for (int i = 500; i < 1500; i++) {
+    freed.insert(rids[i].GetPageId());
+  }
+  for (auto page_id : reused) {
+    EXPECT_EQ(freed.count(page_id), 1);
+  }
+
+  // once the holes are filled, the table grows again
+  RID rid;
+  for (int i = 0; i < 200; i++) {
+    ASSERT_TRUE(table.InsertTuple(make_row(i), &rid, &txn));
+  }
+  EXPECT_GT(count_pages(first_page_id), pages);
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn, true));
+  EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 199);
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("free_space_map_test.db");
+  remove("free_space_map_test.log");
+}
+
+TEST(FreeSpaceMapTest, ConcurrentInsertTest) {
+  auto disk_manager = std::make_unique<DiskManager>("free_space_map_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100}}};
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+
+  const int num_threads = 4;
+  const int rows_per_thread = 1000;
+  std::vector<std::vector<RID>> rids(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      Transaction worker_txn(t + 1);
+      for (int i = 0; i < rows_per_thread; i++) {
+        Tuple row({ValueFactory::GetIntegerValue(t * rows_per_thread + i),
+                   ValueFactory::GetVarcharValue(std::string(100, static_cast<char>('a' + t)))},
+                  &schema);
+        RID rid;
+        ASSERT_TRUE(table.InsertTuple(row, &rid, &worker_txn));
+        rids[t].push_back(rid);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // every thread filled pages of its own
+  std::map<page_id_t, int> page_owner;
+  Tuple tuple;
+  for (int t = 0; t < num_threads; t++) {
+    ASSERT_EQ(rids[t].size(), rows_per_thread);
+    for (int i = 0; i < rows_per_thread; i++) {
+      EXPECT_EQ(page_owner.try_emplace(rids[t][i].GetPageId(), t).first->second, t);
+      ASSERT_TRUE(table.GetTuple(rids[t][i], &tuple, &txn));
+      EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), t * rows_per_thread + i);
+    }
+  }
+  size_t rows = 0;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    rows++;
+  }
+  EXPECT_EQ(rows, num_threads * rows_per_thread);
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("free_space_map_test.db");
+  remove("free_space_map_test.log");
+}
+
+}  // namespace bustub
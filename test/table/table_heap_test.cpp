@@ -0,0 +1,206 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+auto MakeRows(const Schema &schema, int from, int to) -> std::vector<Tuple> {
+  std::vector<Tuple> rows;
+  for (int a = from; a < to; a++) {
+    rows.emplace_back(
+        std::vector<Value>{ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(100, 'x'))},
+        &schema);
+  }
+  return rows;
+}
+
+auto CountPages(BufferPoolManager *bpm, page_id_t first_page_id) -> size_t {
+  size_t pages = 0;
+  for (auto page_id = first_page_id; page_id != INVALID_PAGE_ID; pages++) {
+    auto page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+    auto next_page_id = page->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return pages;
+}
+
+TEST(TableHeapTest, BatchInsertTest) {
+  auto disk_manager = std::make_unique<DiskManager>("table_heap_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100}}};
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+  std::vector<RID> rids;
+  ASSERT_TRUE(table.InsertTuples(MakeRows(schema, 0, 3000), &rids, &txn));
+  ASSERT_EQ(rids.size(), 3000);
+  Tuple tuple;
+  for (int i = 0; i < 3000; i++) {
+    ASSERT_TRUE(table.GetTuple(rids[i], &tuple, &txn));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+  }
+
+  // the batch filled the empty first page and then fresh ones in order, one write record for each
+  size_t pages = CountPages(bpm.get(), table.GetFirstPageId());
+  EXPECT_EQ(rids.front(), RID(table.GetFirstPageId(), 0));
+  EXPECT_EQ(txn.GetWriteSet()->size(), pages);
+  uint32_t count = 0;
+  for (const auto &record : *txn.GetWriteSet()) {
+    EXPECT_EQ(record.wtype_, WType::INSERT);
+    EXPECT_EQ(record.rid_, rids[count]);
+    count += record.count_;
+  }
+  EXPECT_EQ(count, 3000);
+
+  // a small batch fills the gaps that deletes leave
+  for (int i = 0; i < 3000; i += 2) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    table.ApplyDelete(rids[i], &txn);
+  }
+  std::set<page_id_t> used;
+  for (int from = 0; from < 100; from += 10) {
+    ASSERT_TRUE(table.InsertTuples(MakeRows(schema, from, from + 10), &rids, &txn));
+    for (const auto &rid : rids) {
+      used.insert(rid.GetPageId());
+    }
+  }
+  EXPECT_EQ(CountPages(bpm.get(), table.GetFirstPageId()), pages);
+  EXPECT_LE(used.size(), 10);
+
+  Schema wide_schema{std::vector<Column>{Column{"b", TypeId::VARCHAR, BUSTUB_PAGE_SIZE}}};
+  std::vector<Tuple> too_large{
+      Tuple({ValueFactory::GetVarcharValue(std::string(BUSTUB_PAGE_SIZE, 'x'))}, &wide_schema)};
+  EXPECT_FALSE(table.InsertTuples(too_large, &rids, &txn));
+  EXPECT_EQ(txn.GetState(), TransactionState::ABORTED);
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("table_heap_test.db");
+  remove("table_heap_test.log");
+}
+
+TEST(TableHeapTest, BatchInsertAbortTest) {
+  auto disk_manager = std::make_unique<DiskManager>("table_heap_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100}}};
+  LockManager lock_manager;
+  TransactionManager txn_mgr(&lock_manager);
+  auto *txn = txn_mgr.Begin();
+  TableHeap table(bpm.get(), &lock_manager, nullptr, txn);
+  std::vector<RID> rids;
+  ASSERT_TRUE(table.InsertTuples(MakeRows(schema, 0, 1000), &rids, txn));
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(MakeRows(schema, 1000, 1001)[0], &rid, txn));
+  EXPECT_NE(table.Begin(txn), table.End());
+
+  txn_mgr.Abort(txn);
+  EXPECT_EQ(table.Begin(txn), table.End());
+  delete txn;
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("table_heap_test.db");
+  remove("table_heap_test.log");
+}
+
+TEST(TableHeapTest, ReleaseInsertPagesTest) {
+  auto disk_manager = std::make_unique<DiskManager>("table_heap_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100}}};
+  LockManager lock_manager;
+  TransactionManager txn_mgr(&lock_manager);
+  auto *create_txn = txn_mgr.Begin();
+  TableHeap table(bpm.get(), &lock_manager, nullptr, create_txn);
+  txn_mgr.Commit(create_txn);
+  delete create_txn;
+
+  // every new thread inserts through a lane of its own, and the lane holds on to its page after the insert
+  auto insert = [&](int a, Transaction *txn) {
+    RID rid;
+    std::thread([&]() { ASSERT_TRUE(table.InsertTuple(MakeRows(schema, a, a + 1)[0], &rid, txn)); }).join();
+    return rid.GetPageId();
+  };
+  auto *first_txn = txn_mgr.Begin();
+  EXPECT_EQ(insert(0, first_txn), table.GetFirstPageId());
+  auto *second_txn = txn_mgr.Begin();
+  auto second_page_id = insert(1, second_txn);
+  EXPECT_NE(second_page_id, table.GetFirstPageId());
+
+  // once a transaction ends, the idle lanes give their pages back, and the next lane does not append another one
+  txn_mgr.Commit(first_txn);
+  auto *third_txn = txn_mgr.Begin();
+  auto page_id = insert(2, third_txn);
+  EXPECT_TRUE(page_id == table.GetFirstPageId() || page_id == second_page_id);
+  txn_mgr.Abort(third_txn);
+  auto *fourth_txn = txn_mgr.Begin();
+  page_id = insert(3, fourth_txn);
+  EXPECT_TRUE(page_id == table.GetFirstPageId() || page_id == second_page_id);
+  txn_mgr.Commit(second_txn);
+  txn_mgr.Commit(fourth_txn);
+  EXPECT_EQ(CountPages(bpm.get(), table.GetFirstPageId()), 2);
+  delete first_txn;
+  delete second_txn;
+  delete third_txn;
+  delete fourth_txn;
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("table_heap_test.db");
+  remove("table_heap_test.log");
+}
+
+TEST(TableHeapTest, ParallelScanTest) {
+  auto disk_manager = std::make_unique<DiskManager>("table_heap_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100}}};
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+  std::vector<RID> rids;
+  ASSERT_TRUE(table.InsertTuples(MakeRows(schema, 0, 1000), &rids, &txn));
+  std::atomic<int> sum{0};
+  auto add = [&](size_t /* worker */, const Tuple &tuple) { sum += tuple.GetValue(&schema, 0).GetAs<int32_t>(); };
+  EXPECT_TRUE(table.ParallelScan(4, add, &txn));
+  EXPECT_EQ(sum, 999 * 1000 / 2);
+  EXPECT_EQ(txn.GetState(), TransactionState::GROWING);
+
+  // with every frame pinned the scan cannot fetch the table's pages
+  std::vector<page_id_t> pinned(64);
+  for (auto &page_id : pinned) {
+    ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+  }
+  EXPECT_FALSE(table.ParallelScan(4, add, &txn));
+  EXPECT_EQ(txn.GetState(), TransactionState::ABORTED);
+  EXPECT_FALSE(table.ParallelScan(4, add, nullptr));
+  for (auto page_id : pinned) {
+    bpm->UnpinPage(page_id, false);
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("table_heap_test.db");
+  remove("table_heap_test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_iterator_test.cpp
+//
+// Identification: test/table/table_iterator_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(TableIteratorTest, ScanTest) {
+  auto disk_manager = std::make_unique<DiskManager>("table_iterator_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(16, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}}};
+  auto make_row = [&schema](int a, size_t length) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(length, 'x'))}, &schema);
+  };
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+  EXPECT_EQ(table.Begin(&txn), table.End());
+
+  // far more pages than the buffer pool holds, so that the scan pins none of them for long
+  std::vector<RID> rids(3000);
+  for (int i = 0; i < 3000; i++) {
+    ASSERT_TRUE(table.InsertTuple(make_row(i, i % 200), &rids[i], &txn));
+  }
+  // empty a run of pages in the middle, and every third row elsewhere
+  for (int i = 0; i < 3000; i++) {
+    if ((i >= 1000 && i < 2000) || i % 3 == 0) {
+      ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+      table.ApplyDelete(rids[i], &txn);
+    }
+  }
+
+  // inserts fill whichever page has room, so the rows come back in any order
+  std::vector<int> expected;
+  for (int i = 0; i < 3000; i++) {
+    if (!((i >= 1000 && i < 2000) || i % 3 == 0)) {
+      expected.push_back(i);
+    }
+  }
+  std::vector<int> scanned;
+  std::vector<Tuple> kept;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    int a = (*it).GetValue(&schema, 0).GetAs<int32_t>();
+    EXPECT_EQ(it->GetRid(), rids[a]);
+    EXPECT_EQ(it->GetValue(&schema, 1).ToString(), std::string(a % 200, 'x'));
+    scanned.push_back(a);
+    if (scanned.size() % 100 == 0) {
+      kept.push_back(*it);
+    }
+  }
+  std::sort(scanned.begin(), scanned.end());
+  EXPECT_EQ(scanned, expected);
+
+  // the copies own their data, which outlives the pages the iterator viewed
+  ASSERT_EQ(kept.size(), expected.size() / 100);
+  for (const auto &tuple : kept) {
+    int a = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+    EXPECT_EQ(tuple.GetRid(), rids[a]);
+    EXPECT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(a % 200, 'x'));
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("table_iterator_test.db");
+  remove("table_iterator_test.log");
+}
+
+TEST(TableIteratorTest, CopyAndWriteTest) {
+  auto disk_manager = std::make_unique<DiskManager>("table_iterator_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(16, disk_manager.get());
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}}};
+  auto make_row = [&schema](int a, size_t length) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(length, 'x'))}, &schema);
+  };
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+  std::vector<RID> rids(500);
+  for (int i = 0; i < 500; i++) {
+    ASSERT_TRUE(table.InsertTuple(make_row(i, 50), &rids[i], &txn));
+  }
+
+  // a copy starts from the same tuple and moves on by itself
+  auto it = table.Begin(&txn);
+  auto old = it++;
+  EXPECT_EQ(old->GetValue(&schema, 0).GetAs<int32_t>(), 0);
+  EXPECT_EQ(it->GetValue(&schema, 0).GetAs<int32_t>(), 1);
+  ++old;
+  EXPECT_EQ(old, it);
+  auto moved = std::move(old);
+  EXPECT_EQ(moved->GetValue(&schema, 0).GetAs<int32_t>(), 1);
+  ++moved;
+  EXPECT_EQ(moved->GetValue(&schema, 0).GetAs<int32_t>(), 2);
+
+  // the scan holds no latch between tuples, so it can delete what it reads
+  int n = 0;
+  for (auto scan = table.Begin(&txn); scan != table.End(); ++scan, n++) {
+    if (n % 2 == 0) {
+      ASSERT_TRUE(table.MarkDelete(scan->GetRid(), &txn));
+      table.ApplyDelete(scan->GetRid(), &txn);
+    }
+  }
+  EXPECT_EQ(n, 500);
+  n = 0;
+  for (auto scan = table.Begin(&txn); scan != table.End(); ++scan, n++) {
+    EXPECT_EQ(scan->GetValue(&schema, 0).GetAs<int32_t>(), 2 * n + 1);
+  }
+  EXPECT_EQ(n, 250);
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("table_iterator_test.db");
+  remove("table_iterator_test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_epsilon_bench.cpp
+//
+// Identification: tools/b_epsilon_bench/b_epsilon_bench.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/counting_disk_manager.h"
+#include "fmt/core.h"
+#include "storage/index/b_epsilon_tree.h"
+#include "storage/index/b_plus_tree.h"
+
+using KeyType = bustub::IntegerKey<int64_t>;
+using ComparatorType = bustub::IntegerKeyComparator<int64_t>;
+
+/*
+ * Insert keys in random order into a tree whose buffer pool holds only a
+ * fraction of it, then look a sample of them up again.
+ */
+template <typename Tree>
+void RunBench(const std::string &name, const std::vector<int64_t> &keys, size_t frames) {
+  std::string db_file = fmt::format("b_epsilon_bench_{}.db", name);
+  auto disk_manager = std::make_unique<bustub::CountingDiskManager>(db_file);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+  bustub::page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Tree tree(name, bpm.get(), ComparatorType(nullptr));
+
+  KeyType index_key;
+  auto start = std::chrono::steady_clock::now();
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, bustub::RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)));
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fmt::print("{:<8} insert: {:>10.0f} keys/s  {:>8} page reads  {:>8} page writes\n", name, keys.size() / elapsed,
+             disk_manager->reads_, disk_manager->writes_);
+
+  size_t lookups = std::min<size_t>(keys.size(), 10000);
+  size_t found = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < lookups; i++) {
+    std::vector<bustub::RID> result;
+    index_key.SetFromInteger(keys[i]);
+    found += tree.GetValue(index_key, &result) ? 1 : 0;
+  }
+  elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fmt::print("{:<8} lookup: {:>10.0f} keys/s  {}/{} found\n", name, lookups / elapsed, found, lookups);
+
+  disk_manager->ShutDown();
+  remove(db_file.c_str());
+  remove(fmt::format("b_epsilon_bench_{}.log", name).c_str());
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-b-epsilon-bench");
+  program.add_argument("--keys").help("number of keys to insert").default_value(std::string("200000"));
+  program.add_argument("--frames").help("buffer pool size in pages").default_value(std::string("64"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_keys = std::stoul(program.get("--keys"));
+  size_t frames = std::stoul(program.get("--frames"));
+  std::vector<int64_t> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(15445));
+
+  fmt::print("{} random inserts, {} buffer pool frames\n", num_keys, frames);
+  RunBench<bustub::BPlusTree<KeyType, bustub::RID, ComparatorType>>("bplus", keys, frames);
+  RunBench<bustub::BEpsilonTree<KeyType, bustub::RID, ComparatorType>>("bepsilon", keys, frames);
+  return 0;
+}
@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bench.cpp
+//
+// Identification: tools/b_plus_tree_bench/b_plus_tree_bench.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/counting_disk_manager.h"
+#include "fmt/core.h"
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/normalized_key.h"
+
+using KeyType = bustub::IntegerKey<int64_t>;
+using ComparatorType = bustub::IntegerKeyComparator<int64_t>;
+using TreeType = bustub::BPlusTree<KeyType, bustub::RID, ComparatorType>;
+
+void InsertKeys(TreeType *tree, const std::vector<int64_t> &keys) {
+  KeyType index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree->Insert(index_key, bustub::RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)));
+  }
+}
+
+/*
+ * Look up random keys from every thread and report the latency of a lookup,
+ * in nanoseconds.
+ */
+template <typename Lookup>
+void RunLookups(const std::string &name, size_t num_keys, size_t lookups, size_t threads, Lookup &&lookup) {
+  std::vector<std::vector<double>> latencies(threads);
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      std::mt19937_64 rng(t);
+      std::uniform_int_distribution<int64_t> dist(0, static_cast<int64_t>(num_keys) - 1);
+      latencies[t].reserve(lookups);
+      for (size_t i = 0; i < lookups; i++) {
+        int64_t key = dist(rng);
+        auto lookup_start = std::chrono::steady_clock::now();
+        lookup(key);
+        latencies[t].push_back(
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - lookup_start).count());
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<double> all;
+  for (auto &latency : latencies) {
+    all.insert(all.end(), latency.begin(), latency.end());
+  }
+  std::sort(all.begin(), all.end());
+  double sum = 0;
+  for (double latency : all) {
+    sum += latency;
+  }
+  fmt::print("{:<12} {:>10.0f} lookups/s  avg {:>7.0f} ns  p50 {:>7.0f} ns  p99 {:>7.0f} ns\n", name,
+             all.size() / elapsed, sum / all.size(), all[all.size() / 2], all[all.size() * 99 / 100]);
+}
+
+/*
+ * Delete-then-reinsert churn: remove a run of neighbouring keys, which drains
+ * their leaves, and insert them again. Reports the dirty pages written back
+ * per operation, flushing after every round, and how many pages compaction
+ * frees afterwards.
+ */
+void RunChurn(double min_fill, const std::vector<int64_t> &keys, int64_t run, size_t rounds, size_t frames) {
+  auto disk_manager = std::make_unique<bustub::CountingDiskManager>("b_plus_tree_bench.db");
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+  bustub::page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  TreeType tree("bench", bpm.get(), ComparatorType(nullptr));
+  tree.SetMinFill(min_fill);
+  InsertKeys(&tree, keys);
+  bpm->FlushAllPages();
+  disk_manager->writes_ = 0;
+
+  std::mt19937_64 rng(15445);
+  std::uniform_int_distribution<int64_t> dist(0, static_cast<int64_t>(keys.size()) - run);
+  KeyType index_key;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; round++) {
+    int64_t first = dist(rng);
+    std::vector<int64_t> batch;
+    for (int64_t key = first; key < first + run; key++) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+      batch.push_back(key);
+    }
+    std::shuffle(batch.begin(), batch.end(), rng);
+    InsertKeys(&tree, batch);
+    // write back what the round dirtied, as a checkpoint would
+    bpm->FlushAllPages();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double ops = 2.0 * run * rounds;
+  int pages_saved = tree.Compact();
+  fmt::print("min_fill {:<4}  {:>8.0f} ops/s  {:>6.3f} pages written/op  compaction frees {} pages\n", min_fill,
+             ops / elapsed, disk_manager->writes_ / ops, pages_saved);
+
+  disk_manager->ShutDown();
+  remove("b_plus_tree_bench.db");
+  remove("b_plus_tree_bench.log");
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-b-plus-tree-bench");
+  program.add_argument("--keys").help("number of keys in the tree").default_value(std::string("200000"));
+  program.add_argument("--lookups").help("lookups per thread").default_value(std::string("200000"));
+  program.add_argument("--threads").help("number of lookup threads").default_value(std::string("1"));
+  program.add_argument("--frames").help("buffer pool size in pages").default_value(std::string("4096"));
+  program.add_argument("--resident").help("internal pages kept resident").default_value(std::string("1024"));
+  program.add_argument("--workload").help("lookup, churn or art").default_value(std::string("lookup"));
+  program.add_argument("--rounds").help("churn rounds").default_value(std::string("100"));
+  program.add_argument("--run").help("neighbouring keys deleted and reinserted per round").default_value(
+      std::string("4096"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_keys = std::stoul(program.get("--keys"));
+  size_t lookups = std::stoul(program.get("--lookups"));
+  size_t threads = std::stoul(program.get("--threads"));
+  size_t frames = std::stoul(program.get("--frames"));
+  size_t resident = std::stoul(program.get("--resident"));
+  std::vector<int64_t> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(15445));
+
+  if (program.get("--workload") == "churn") {
+    size_t rounds = std::stoul(program.get("--rounds"));
+    int64_t run = std::stol(program.get("--run"));
+    fmt::print("{} keys, {} churn rounds, {} buffer pool frames\n", num_keys, rounds, frames);
+    for (double min_fill : {0.5, 0.25, 0.0}) {
+      RunChurn(min_fill, keys, run, rounds, frames);
+    }
+    return 0;
+  }
+
+  auto disk_manager = std::make_unique<bustub::DiskManager>("b_plus_tree_bench.db");
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+  bustub::page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  TreeType tree("bench", bpm.get(), ComparatorType(nullptr));
+
+  InsertKeys(&tree, keys);
+  auto point_lookup = [&tree](int64_t key) {
+    KeyType index_key;
+    index_key.SetFromInteger(key);
+    std::vector<bustub::RID> result;
+    tree.GetValue(index_key, &result);
+  };
+
+  fmt::print("{} keys, {} threads, {} buffer pool frames\n", num_keys, threads, frames);
+  if (program.get("--workload") == "art") {
+    // point lookups and scans of 10 neighbouring keys, on the swizzled B+ tree and on an adaptive radix tree
+    auto range_lookup = [&tree](int64_t key) {
+      KeyType index_key;
+      index_key.SetFromInteger(key);
+      int found = 0;
+      for (auto iter = tree.Begin(index_key); !iter.IsEnd() && found < 10; ++iter) {
+        found++;
+      }
+    };
+    bustub::AdaptiveRadixTree art;
+    auto encode = [](int64_t key) {
+      std::string encoded(sizeof(int64_t), '\0');
+      bustub::NormalizedKey::EncodeInteger(key, encoded.data(), encoded.size());
+      return encoded;
+    };
+    for (auto key : keys) {
+      art.Insert(encode(key), bustub::RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)));
+    }
+    auto art_point_lookup = [&art, &encode](int64_t key) {
+      bustub::RID rid;
+      art.Lookup(encode(key), &rid);
+    };
+    auto art_range_lookup = [&art, &encode](int64_t key) {
+      std::string low = encode(key);
+      std::string high = encode(key + 9);
+      int found = 0;
+      art.Scan(&low, true, &high, true, [&found](const std::string &entry, bustub::RID rid) { found++; });
+    };
+    tree.SetResidentUpperLevels(resident);
+    RunLookups("bplus point", num_keys, lookups, threads, point_lookup);
+    RunLookups("art point", num_keys, lookups, threads, art_point_lookup);
+    RunLookups("bplus range", num_keys, lookups, threads, range_lookup);
+    RunLookups("art range", num_keys, lookups, threads, art_range_lookup);
+    auto counts = art.GetNodeCounts();
+    fmt::print("art nodes: {} Node4, {} Node16, {} Node48, {} Node256\n", counts[0], counts[1], counts[2], counts[3]);
+  } else {
+    RunLookups("fetch", num_keys, lookups, threads, point_lookup);
+    tree.SetResidentUpperLevels(resident);
+    RunLookups("swizzled", num_keys, lookups, threads, point_lookup);
+    fmt::print("{} internal pages resident\n", tree.GetResidentPageCount());
+  }
+  tree.SetResidentUpperLevels(0);
+
+  disk_manager->ShutDown();
+  remove("b_plus_tree_bench.db");
+  remove("b_plus_tree_bench.log");
+  return 0;
+}
@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// counting_disk_manager.h
+//
+// Identification: tools/common/counting_disk_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** A disk manager for the benchmarks that counts the page reads and writes that miss the buffer pool */
+class CountingDiskManager : public DiskManager {
+ public:
+  explicit CountingDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    writes_++;
+    DiskManager::WritePage(page_id, page_data);
+  }
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    reads_++;
+    DiskManager::ReadPage(page_id, page_data);
+  }
+
+  uint64_t reads_{0};
+  uint64_t writes_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_bench.cpp
+//
+// Identification: tools/lsm_bench/lsm_bench.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/counting_disk_manager.h"
+#include "fmt/core.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/lsm_tree.h"
+#include "storage/index/normalized_key.h"
+
+using KeyType = bustub::IntegerKey<int64_t>;
+using ComparatorType = bustub::IntegerKeyComparator<int64_t>;
+
+/** The same operations on both trees, so that RunBench can time them alike */
+class BPlusTreeTarget {
+ public:
+  explicit BPlusTreeTarget(bustub::BufferPoolManager *bpm) : tree_("bplus", bpm, ComparatorType(nullptr)) {}
+
+  void Insert(int64_t key, bustub::RID rid) {
+    key_.SetFromInteger(key);
+    tree_.Insert(key_, rid);
+  }
+
+  void Finish() {}
+
+  auto Lookup(int64_t key) -> bool {
+    std::vector<bustub::RID> result;
+    key_.SetFromInteger(key);
+    return tree_.GetValue(key_, &result);
+  }
+
+ private:
+  bustub::BPlusTree<KeyType, bustub::RID, ComparatorType> tree_;
+  KeyType key_;
+};
+
+class LSMTreeTarget {
+ public:
+  explicit LSMTreeTarget(bustub::BufferPoolManager *bpm) : tree_(bpm), key_(sizeof(int64_t), '\0') {}
+
+  void Insert(int64_t key, bustub::RID rid) {
+    bustub::NormalizedKey::EncodeInteger(key, key_.data(), key_.size());
+    tree_.Put(key_, rid);
+  }
+
+  // the runs of the last memtables are written and merged in the background, and count towards the inserts
+  void Finish() { tree_.Flush(); }
+
+  auto Lookup(int64_t key) -> bool {
+    bustub::RID rid;
+    bustub::NormalizedKey::EncodeInteger(key, key_.data(), key_.size());
+    return tree_.Lookup(key_, &rid);
+  }
+
+ private:
+  bustub::LSMTree tree_;
+  std::string key_;
+};
+
+/*
+ * Insert keys into a tree whose buffer pool holds only a fraction of it, then
+ * look a sample of them up again.
+ */
+template <typename Target>
+void RunBench(const std::string &name, const std::vector<int64_t> &keys, size_t frames) {
+  std::string db_file = fmt::format("lsm_bench_{}.db", name);
+  auto disk_manager = std::make_unique<bustub::CountingDiskManager>(db_file);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+  bustub::page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  {
+    Target target(bpm.get());
+    auto start = std::chrono::steady_clock::now();
+    for (auto key : keys) {
+      target.Insert(key, bustub::RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)));
+    }
+    target.Finish();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{:<6} insert: {:>10.0f} keys/s  {:>8} page reads  {:>8} page writes\n", name, keys.size() / elapsed,
+               disk_manager->reads_, disk_manager->writes_);
+
+    size_t lookups = std::min<size_t>(keys.size(), 10000);
+    size_t found = 0;
+    std::mt19937_64 rng(15445);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+      found += target.Lookup(keys[rng() % keys.size()]) ? 1 : 0;
+    }
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{:<6} lookup: {:>10.0f} keys/s  {}/{} found\n", name, lookups / elapsed, found, lookups);
+  }
+
+  disk_manager->ShutDown();
+  remove(db_file.c_str());
+  remove(fmt::format("lsm_bench_{}.log", name).c_str());
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-lsm-bench");
+  program.add_argument("--keys").help("number of keys to insert").default_value(std::string("200000"));
+  program.add_argument("--frames").help("buffer pool size in pages").default_value(std::string("64"));
+  program.add_argument("--order")
+      .help("key order, append (increasing, like event tables) or random")
+      .default_value(std::string("random"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_keys = std::stoul(program.get("--keys"));
+  size_t frames = std::stoul(program.get("--frames"));
+  std::string order = program.get("--order");
+  std::vector<int64_t> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  if (order != "append") {
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(15445));
+  }
+
+  fmt::print("{} {} inserts, {} buffer pool frames\n", num_keys, order, frames);
+  RunBench<BPlusTreeTarget>("bplus", keys, frames);
+  RunBench<LSMTreeTarget>("lsm", keys, frames);
+  return 0;
+}
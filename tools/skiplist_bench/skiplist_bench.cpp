@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skiplist_bench.cpp
+//
+// Identification: tools/skiplist_bench/skiplist_bench.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/skiplist/lock_free_skiplist.h"
+#include "fmt/core.h"
+#include "storage/index/b_plus_tree.h"
+
+using KeyType = bustub::IntegerKey<int64_t>;
+using ComparatorType = bustub::IntegerKeyComparator<int64_t>;
+
+/** The same operations on every structure, so that RunBench can time them alike */
+class MapTarget {
+ public:
+  void Insert(int64_t key, bustub::RID rid) {
+    std::scoped_lock lock(latch_);
+    map_.emplace(key, rid);
+  }
+
+  auto Lookup(int64_t key) -> bool {
+    std::scoped_lock lock(latch_);
+    return map_.count(key) == 1;
+  }
+
+ private:
+  std::mutex latch_;
+  std::map<int64_t, bustub::RID> map_;
+};
+
+class SkipListTarget {
+ public:
+  void Insert(int64_t key, bustub::RID rid) { list_.Insert(key, rid); }
+
+  auto Lookup(int64_t key) -> bool {
+    bustub::RID rid;
+    return list_.Lookup(key, &rid);
+  }
+
+ private:
+  bustub::LockFreeSkipList<int64_t, bustub::RID> list_;
+};
+
+/** A B+ tree whose buffer pool holds all of it, so that it runs in memory as well */
+class BPlusTreeTarget {
+ public:
+  explicit BPlusTreeTarget(size_t num_keys)
+      : disk_manager_(std::make_unique<bustub::DiskManager>("skiplist_bench.db")),
+        bpm_(std::make_unique<bustub::BufferPoolManagerInstance>(num_keys / 64 + 1024, disk_manager_.get())) {
+    bustub::page_id_t header_page_id;
+    bpm_->NewPage(&header_page_id);
+    bpm_->UnpinPage(header_page_id, true);
+    tree_ = std::make_unique<bustub::BPlusTree<KeyType, bustub::RID, ComparatorType>>("bench", bpm_.get(),
+                                                                                       ComparatorType(nullptr));
+  }
+
+  ~BPlusTreeTarget() {
+    tree_.reset();
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("skiplist_bench.db");
+    remove("skiplist_bench.log");
+  }
+
+  void Insert(int64_t key, bustub::RID rid) {
+    KeyType index_key;
+    index_key.SetFromInteger(key);
+    tree_->Insert(index_key, rid);
+  }
+
+  auto Lookup(int64_t key) -> bool {
+    KeyType index_key;
+    index_key.SetFromInteger(key);
+    std::vector<bustub::RID> result;
+    return tree_->GetValue(index_key, &result);
+  }
+
+ private:
+  std::unique_ptr<bustub::DiskManager> disk_manager_;
+  std::unique_ptr<bustub::BufferPoolManagerInstance> bpm_;
+  std::unique_ptr<bustub::BPlusTree<KeyType, bustub::RID, ComparatorType>> tree_;
+};
+
+/** Run work(thread, key) for every key, the keys split evenly among the threads, and return the keys per second */
+template <typename Work>
+auto RunThreads(const std::vector<int64_t> &keys, size_t threads, Work &&work) -> double {
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      for (size_t i = t; i < keys.size(); i += threads) {
+        work(keys[i]);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return keys.size() / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Insert all keys from every thread, then look all of them up again in a
+ * different order.
+ */
+template <typename Target>
+void RunBench(const std::string &name, Target *target, const std::vector<int64_t> &keys, size_t threads) {
+  double inserts = RunThreads(keys, threads, [target](int64_t key) {
+    target->Insert(key, bustub::RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)));
+  });
+  std::vector<int64_t> lookup_keys(keys);
+  std::shuffle(lookup_keys.begin(), lookup_keys.end(), std::mt19937_64(15721));
+  std::atomic<size_t> found{0};
+  double lookups = RunThreads(lookup_keys, threads, [target, &found](int64_t key) {
+    if (target->Lookup(key)) {
+      found.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  fmt::print("{:<9} insert: {:>10.0f} keys/s  lookup: {:>10.0f} keys/s  {}/{} found\n", name, inserts, lookups,
+             found.load(), keys.size());
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-skiplist-bench");
+  program.add_argument("--keys").help("number of keys to insert").default_value(std::string("200000"));
+  program.add_argument("--threads").help("number of worker threads").default_value(std::string("4"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_keys = std::stoul(program.get("--keys"));
+  size_t threads = std::stoul(program.get("--threads"));
+  std::vector<int64_t> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(15445));
+
+  fmt::print("{} random keys, {} threads\n", num_keys, threads);
+  {
+    MapTarget target;
+    RunBench("std::map", &target, keys, threads);
+  }
+  {
+    SkipListTarget target;
+    RunBench("skiplist", &target, keys, threads);
+  }
+  {
+    BPlusTreeTarget target(num_keys);
+    RunBench("bplus", &target, keys, threads);
+  }
+  return 0;
+}
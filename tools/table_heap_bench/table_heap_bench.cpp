@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_bench.cpp
+//
+// Identification: tools/table_heap_bench/table_heap_bench.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "recovery/log_manager.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+/** @return the pages in the chain of the table */
+auto CountPages(bustub::BufferPoolManager *bpm, bustub::page_id_t first_page_id) -> size_t {
+  size_t pages = 0;
+  for (auto page_id = first_page_id; page_id != bustub::INVALID_PAGE_ID; pages++) {
+    auto page = static_cast<bustub::TablePage *>(bpm->FetchPage(page_id));
+    auto next_page_id = page->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return pages;
+}
+
+/*
+ * Grow a table one insert at a time and report the insert latency as it
+ * gets larger, then delete random rows and insert as many again, which
+ * should fill the space the deletes freed instead of growing the table.
+ * Scan the table, then fill a second table from several threads at once.
+ * Finally compare inserting the same rows one at a time and in batches.
+ */
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-table-heap-bench");
+  program.add_argument("--rows").help("number of rows to insert").default_value(std::string("200000"));
+  program.add_argument("--row-size").help("bytes of payload per row").default_value(std::string("100"));
+  program.add_argument("--churn")
+      .help("share of the rows deleted and inserted again")
+      .default_value(std::string("0.1"));
+  program.add_argument("--threads").help("number of concurrent inserters").default_value(std::string("4"));
+  program.add_argument("--batch").help("rows per batch insert").default_value(std::string("1024"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_rows = std::stoul(program.get("--rows"));
+  size_t row_size = std::stoul(program.get("--row-size"));
+  double churn = std::stod(program.get("--churn"));
+  size_t threads = std::stoul(program.get("--threads"));
+  size_t batch = std::max<size_t>(1, std::stoul(program.get("--batch")));
+
+  auto disk_manager = std::make_unique<bustub::DiskManager>("table_heap_bench.db");
+  // the whole table stays in memory, so that the latency is the one of finding a page
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(
+      4 * num_rows * (row_size + 16) / bustub::BUSTUB_PAGE_SIZE + 1024, disk_manager.get());
+  bustub::LockManager lock_manager;
+  bustub::LogManager log_manager(disk_manager.get());
+  bustub::Schema schema{std::vector<bustub::Column>{bustub::Column{"id", bustub::TypeId::INTEGER},
+                                                    bustub::Column{"payload", bustub::TypeId::VARCHAR,
+                                                                   static_cast<uint32_t>(row_size)}}};
+  auto make_row = [&](size_t id) {
+    return bustub::Tuple({bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(id)),
+                          bustub::ValueFactory::GetVarcharValue(std::string(row_size, 'x'))},
+                         &schema);
+  };
+
+  {
+    bustub::Transaction txn(0);
+    bustub::TableHeap table(bpm.get(), &lock_manager, &log_manager, &txn);
+    std::vector<bustub::RID> rids(num_rows);
+    fmt::print("{} rows of {} bytes\n", num_rows, row_size);
+    const size_t steps = 10;
+    for (size_t step = 0; step < steps; step++) {
+      size_t begin = num_rows * step / steps;
+      size_t end = num_rows * (step + 1) / steps;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = begin; i < end; i++) {
+        table.InsertTuple(make_row(i), &rids[i], &txn);
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      fmt::print("rows {:>9} - {:>9}: {:>10.2f} us/insert\n", begin, end, seconds * 1e6 / (end - begin));
+    }
+    size_t pages = CountPages(bpm.get(), table.GetFirstPageId());
+
+    std::vector<bustub::RID> victims(rids);
+    std::shuffle(victims.begin(), victims.end(), std::mt19937_64(15445));
+    victims.resize(static_cast<size_t>(static_cast<double>(num_rows) * churn));
+    for (const auto &rid : victims) {
+      table.MarkDelete(rid, &txn);
+      table.ApplyDelete(rid, &txn);
+    }
+    auto start = std::chrono::steady_clock::now();
+    bustub::RID rid;
+    for (size_t i = 0; i < victims.size(); i++) {
+      table.InsertTuple(make_row(num_rows + i), &rid, &txn);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("churn {:>9} rows   : {:>10.2f} us/insert, pages {} -> {}\n", victims.size(),
+               seconds * 1e6 / std::max<size_t>(victims.size(), 1), pages,
+               CountPages(bpm.get(), table.GetFirstPageId()));
+
+    const int scans = 5;
+    size_t scanned = 0;
+    int64_t checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int scan = 0; scan < scans; scan++) {
+      for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+        checksum += it->GetLength();
+        scanned++;
+      }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("scan  {:>9} rows   : {:>10.0f} rows/s (checksum {})\n", scanned / scans, scanned / seconds, checksum);
+  }
+
+  {
+    bustub::Transaction txn(0);
+    bustub::TableHeap table(bpm.get(), &lock_manager, &log_manager, &txn);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; t++) {
+      workers.emplace_back([&, t]() {
+        bustub::Transaction worker_txn(static_cast<bustub::txn_id_t>(t + 1));
+        bustub::RID rid;
+        for (size_t i = t; i < num_rows; i += threads) {
+          table.InsertTuple(make_row(i), &rid, &worker_txn);
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{} threads           : {:>10.0f} inserts/s, pages {}\n", threads, num_rows / seconds,
+               CountPages(bpm.get(), table.GetFirstPageId()));
+  }
+
+  {
+    // the rows are built up front, so that only the inserts are timed
+    std::vector<bustub::Tuple> tuples;
+    tuples.reserve(num_rows);
+    for (size_t i = 0; i < num_rows; i++) {
+      tuples.push_back(make_row(i));
+    }
+    bustub::Transaction single_txn(0);
+    bustub::TableHeap single_table(bpm.get(), &lock_manager, &log_manager, &single_txn);
+    bustub::RID rid;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &tuple : tuples) {
+      single_table.InsertTuple(tuple, &rid, &single_txn);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("single inserts      : {:>10.2f} us/insert, {} write records\n", seconds * 1e6 / num_rows,
+               single_txn.GetWriteSet()->size());
+
+    bustub::Transaction txn(0);
+    bustub::TableHeap table(bpm.get(), &lock_manager, &log_manager, &txn);
+    std::vector<bustub::Tuple> slice;
+    std::vector<bustub::RID> rids;
+    seconds = 0;
+    for (size_t begin = 0; begin < num_rows; begin += batch) {
+      slice.assign(tuples.begin() + begin, tuples.begin() + std::min(num_rows, begin + batch));
+      start = std::chrono::steady_clock::now();
+      table.InsertTuples(slice, &rids, &txn);
+      seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    fmt::print("batches of {:<9}: {:>10.2f} us/insert, {} write records\n", batch, seconds * 1e6 / num_rows,
+               txn.GetWriteSet()->size());
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("table_heap_bench.db");
+  remove("table_heap_bench.log");
+  return 0;
+}